@@ -16,3 +16,157 @@ void sha512(unsigned char* output, unsigned char* input, size_t size) {
     SHA512_Final(output, &sha512);
 }
 
+#include <stdint.h>
+#include <string.h>
+
+#define SHA512_LANES 4 /**< number of messages hashed at once by sha512_batch */
+
+#if defined(__x86_64__) && !defined(HASH_NO_AVX2)
+#include <immintrin.h>
+
+static const uint64_t sha512_k[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL,
+    0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL, 0x12835b0145706fbeULL,
+    0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL, 0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+    0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL, 0x983e5152ee66dfabULL,
+    0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+    0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL,
+    0x53380d139d95b3dfULL, 0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+    0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL, 0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL,
+    0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL,
+    0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL, 0xca273eceea26619cULL,
+    0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL,
+    0x113f9804bef90daeULL, 0x1b710b35131c471bULL, 0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+    0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+static const uint64_t sha512_iv[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+#define ROTR(x, n) _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64-(n)))
+
+/** one round of the compression on the 4 lanes, the roles of the 8 state words rotate from a round to the next */
+#define SHA512_ROUND(a, b, c, d, e, f, g, h, t) do { \
+    __m256i t1, t2; \
+    t1 = _mm256_xor_si256(_mm256_xor_si256(ROTR(e, 14), ROTR(e, 18)), ROTR(e, 41)); \
+    t1 = _mm256_add_epi64(t1, _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g))); \
+    t1 = _mm256_add_epi64(_mm256_add_epi64(t1, h), _mm256_add_epi64(W[(t)%16], _mm256_set1_epi64x(sha512_k[t]))); \
+    t2 = _mm256_xor_si256(_mm256_xor_si256(ROTR(a, 28), ROTR(a, 34)), ROTR(a, 39)); \
+    t2 = _mm256_add_epi64(t2, _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)))); \
+    d = _mm256_add_epi64(d, t1); \
+    h = _mm256_add_epi64(t1, t2); \
+} while (0)
+
+/** expansion of the word t >= 16 of the message schedule, stored in place of the word t-16 */
+#define SHA512_SCHEDULE(t) do { \
+    __m256i w15 = W[((t)-15)%16], w2 = W[((t)-2)%16]; \
+    __m256i sig0 = _mm256_xor_si256(_mm256_xor_si256(ROTR(w15, 1), ROTR(w15, 8)), _mm256_srli_epi64(w15, 7)); \
+    __m256i sig1 = _mm256_xor_si256(_mm256_xor_si256(ROTR(w2, 19), ROTR(w2, 61)), _mm256_srli_epi64(w2, 6)); \
+    W[(t)%16] = _mm256_add_epi64(_mm256_add_epi64(W[(t)%16], sig0), _mm256_add_epi64(W[((t)-7)%16], sig1)); \
+} while (0)
+
+/**
+ * \brief This function reads the big endian 64-bit word of a padded message
+ */
+static uint64_t load_be64(const unsigned char * p) {
+    uint64_t w;
+    memcpy(&w, p, 8);
+    return __builtin_bswap64(w);
+}
+
+/**
+ * \brief This function hashes up to SHA512_LANES messages, one per 64-bit lane of the AVX2 registers
+ *
+ * Each message is padded in its own buffer of 128-byte blocks, a lane keeps its state once its blocks are
+ * consumed.
+ */
+__attribute__((target("avx2")))
+static void sha512_lanes_avx2(unsigned char ** output, unsigned char ** input, size_t * size, int n) {
+
+    int nb_blocks[SHA512_LANES] = {0}, max_blocks = 0;
+    unsigned char * padded[SHA512_LANES] = {NULL}, short_padded[SHA512_LANES][2*128];
+    uint64_t w[SHA512_LANES], st[SHA512_LANES][8];
+    __m256i h[8], a, b, c, d, e, f, g, hh, W[16], active;
+
+    for (int l=0 ; l<n ; l++) {
+        nb_blocks[l] = (size[l]+17+127)/128;
+        if (nb_blocks[l]>max_blocks) max_blocks = nb_blocks[l];
+        // the messages of at most 2 blocks, such as the keys and the OT rows, are padded on the stack
+        padded[l] = nb_blocks[l]<=2 ? short_padded[l] : malloc(128*nb_blocks[l]);
+        memset(padded[l], 0, 128*nb_blocks[l]);
+        memcpy(padded[l], input[l], size[l]);
+        padded[l][size[l]] = 0x80;
+        for (int i=0 ; i<8 ; i++) padded[l][128*nb_blocks[l]-1-i] = (unsigned char) (((uint64_t) size[l]<<3)>>(8*i));
+    }
+    for (int i=0 ; i<8 ; i++) h[i] = _mm256_set1_epi64x(sha512_iv[i]);
+
+    for (int blk=0 ; blk<max_blocks ; blk++) {
+        active = _mm256_set_epi64x(-(int64_t) (blk<nb_blocks[3]), -(int64_t) (blk<nb_blocks[2]), -(int64_t) (blk<nb_blocks[1]), -(int64_t) (blk<nb_blocks[0]));
+        for (int t=0 ; t<16 ; t++) {
+            for (int l=0 ; l<SHA512_LANES ; l++) w[l] = blk<nb_blocks[l] ? load_be64(padded[l]+128*blk+8*t) : 0;
+            W[t] = _mm256_set_epi64x(w[3], w[2], w[1], w[0]);
+        }
+        a = h[0]; b = h[1]; c = h[2]; d = h[3]; e = h[4]; f = h[5]; g = h[6]; hh = h[7];
+        for (int t=0 ; t<80 ; t+=8) {
+            if (t>=16) for (int k=t ; k<t+8 ; k++) SHA512_SCHEDULE(k);
+            SHA512_ROUND(a, b, c, d, e, f, g, hh, t);
+            SHA512_ROUND(hh, a, b, c, d, e, f, g, t+1);
+            SHA512_ROUND(g, hh, a, b, c, d, e, f, t+2);
+            SHA512_ROUND(f, g, hh, a, b, c, d, e, t+3);
+            SHA512_ROUND(e, f, g, hh, a, b, c, d, t+4);
+            SHA512_ROUND(d, e, f, g, hh, a, b, c, t+5);
+            SHA512_ROUND(c, d, e, f, g, hh, a, b, t+6);
+            SHA512_ROUND(b, c, d, e, f, g, hh, a, t+7);
+        }
+        // lanes whose message is over keep their digest
+        h[0] = _mm256_blendv_epi8(h[0], _mm256_add_epi64(h[0], a), active);
+        h[1] = _mm256_blendv_epi8(h[1], _mm256_add_epi64(h[1], b), active);
+        h[2] = _mm256_blendv_epi8(h[2], _mm256_add_epi64(h[2], c), active);
+        h[3] = _mm256_blendv_epi8(h[3], _mm256_add_epi64(h[3], d), active);
+        h[4] = _mm256_blendv_epi8(h[4], _mm256_add_epi64(h[4], e), active);
+        h[5] = _mm256_blendv_epi8(h[5], _mm256_add_epi64(h[5], f), active);
+        h[6] = _mm256_blendv_epi8(h[6], _mm256_add_epi64(h[6], g), active);
+        h[7] = _mm256_blendv_epi8(h[7], _mm256_add_epi64(h[7], hh), active);
+    }
+
+    for (int i=0 ; i<8 ; i++) {
+        _mm256_storeu_si256((__m256i *) w, h[i]);
+        for (int l=0 ; l<SHA512_LANES ; l++) st[l][i] = w[l];
+    }
+    for (int l=0 ; l<n ; l++) {
+        for (int i=0 ; i<64 ; i++) output[l][i] = (unsigned char) (st[l][i/8]>>(56-8*(i%8)));
+        if (padded[l]!=short_padded[l]) free(padded[l]);
+    }
+}
+
+#undef SHA512_SCHEDULE
+#undef SHA512_ROUND
+#undef ROTR
+#endif
+
+/**
+ * \brief This function computes the SHA512 digests of n independent messages
+ *
+ * The messages are hashed SHA512_LANES at a time in the lanes of the AVX2 registers when the processor
+ * supports it, one after the other with sha512 otherwise or when built with -DHASH_NO_AVX2.
+ *
+ * \param[out] output  array of n buffers of 64 bytes
+ * \param[in] input    array of n messages
+ * \param[in] size     array of the n sizes of the messages in bytes
+ * \param[in] n        number of messages
+ */
+void sha512_batch(unsigned char ** output, unsigned char ** input, size_t * size, int n) {
+
+#if defined(__x86_64__) && !defined(HASH_NO_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        for (int i=0 ; i<n ; i+=SHA512_LANES) sha512_lanes_avx2(output+i, input+i, size+i, n-i<SHA512_LANES ? n-i : SHA512_LANES);
+        return;
+    }
+#endif
+    for (int i=0 ; i<n ; i++) sha512(output[i], input[i], size[i]);
+}
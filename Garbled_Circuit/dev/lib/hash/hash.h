@@ -9,5 +9,6 @@
 #include <stdlib.h>
 
 void sha512(unsigned char* output, unsigned char* input, size_t size);
+void sha512_batch(unsigned char ** output, unsigned char ** input, size_t * size, int n);
 
 #endif
@@ -0,0 +1,291 @@
+/**
+  * \file aes_hash.c
+  * \brief Tweakable correlation robust hash built on AES-128 with a fixed public key, used for the garbling
+
+  * The hash of a block k with the tweak i is pi(2k ^ i) ^ 2k ^ i, where pi is AES-128 under a fixed key and
+  * 2k the doubling of k in GF(2^128) (Guo et al., "Efficient and Secure Multiparty Computation from Fixed-Key
+  * Block Ciphers"). The key is public, so its schedule is expanded once per process. Labels of several blocks
+  * are hashed block by block, the block number being the upper half of the tweak, and independent labels can
+  * be hashed together with aes_hash_tccr_batch so that AES_HASH_PIPE encryptions are in flight at once.
+
+  * AES-NI is used when the processor supports it, a portable implementation otherwise. Building with
+  * -DAES_HASH_NO_AESNI forces the portable implementation.
+*/
+
+#include <string.h>
+#include <pthread.h>
+#include "aes_hash.h"
+
+#if !defined(AES_HASH_NO_AESNI) && (defined(__x86_64__) || defined(__i386__))
+#define AES_HASH_X86 1
+#include <wmmintrin.h>
+#include <emmintrin.h>
+#else
+#define AES_HASH_X86 0
+#endif
+
+#define AES_HASH_PIPE 8 /**< number of blocks encrypted in parallel by AES-NI */
+
+/** Fixed public key, the first hexadecimal digits of the fractional part of pi */
+static const uint8_t AES_FIXED_KEY[AES_BLOCK_BYTES] = {
+  0x24, 0x3f, 0x6a, 0x88, 0x85, 0xa3, 0x08, 0xd3, 0x13, 0x19, 0x8a, 0x2e, 0x03, 0x70, 0x73, 0x44
+};
+
+static const uint8_t aes_sbox[256] = {
+  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+  0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+  0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+  0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+  0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+  0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+  0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+  0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+  0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+  0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+  0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static uint8_t aes_round_keys[AES_ROUNDS+1][AES_BLOCK_BYTES]; /**< expanded fixed key */
+static int aes_aesni = 0; /**< 1 if AES-NI is used */
+static pthread_once_t aes_once = PTHREAD_ONCE_INIT;
+
+/**
+  * \fn static uint8_t aes_xtime(uint8_t a)
+  * \brief This function multiplies a by x in GF(2^8)
+*/
+static uint8_t aes_xtime(uint8_t a) {
+  return (uint8_t) ((a<<1) ^ ((a>>7)*0x1b));
+}
+
+/**
+  * \fn static void aes_hash_setup(void)
+  * \brief This function expands the fixed key and selects the implementation, once per process
+*/
+static void aes_hash_setup(void) {
+
+  uint8_t t[4], tmp, rcon = 1;
+
+  memcpy(aes_round_keys[0], AES_FIXED_KEY, AES_BLOCK_BYTES);
+  for (int r=1 ; r<=AES_ROUNDS ; r++) {
+    memcpy(t, aes_round_keys[r-1]+12, 4);
+    tmp = t[0];
+    t[0] = aes_sbox[t[1]] ^ rcon;
+    t[1] = aes_sbox[t[2]];
+    t[2] = aes_sbox[t[3]];
+    t[3] = aes_sbox[tmp];
+    rcon = aes_xtime(rcon);
+    for (int i=0 ; i<AES_BLOCK_BYTES ; i++) {
+      aes_round_keys[r][i] = aes_round_keys[r-1][i] ^ t[i%4];
+      t[i%4] = aes_round_keys[r][i];
+    }
+  }
+
+#if AES_HASH_X86
+  __builtin_cpu_init();
+  aes_aesni = __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse2");
+#endif
+}
+
+/**
+  * \fn void aes_hash_init(void)
+  * \brief This function expands the fixed key, it is otherwise done by the first hash
+*/
+void aes_hash_init(void) {
+  pthread_once(&aes_once, aes_hash_setup);
+}
+
+/**
+  * \fn int aes_hash_uses_aesni(void)
+  * \brief This function tells which implementation of AES is used
+
+  * \return 1 if AES-NI is used
+  * \return 0 if the portable implementation is used
+*/
+int aes_hash_uses_aesni(void) {
+  aes_hash_init();
+  return aes_aesni;
+}
+
+/**
+  * \fn static void aes_encrypt_soft(uint8_t * out, const uint8_t * in)
+  * \brief This function encrypts one block with the fixed key, portable implementation
+*/
+static void aes_encrypt_soft(uint8_t * out, const uint8_t * in) {
+
+  uint8_t s[AES_BLOCK_BYTES], t[AES_BLOCK_BYTES], a0, a1, a2, a3, all;
+
+  for (int i=0 ; i<AES_BLOCK_BYTES ; i++) s[i] = in[i] ^ aes_round_keys[0][i];
+
+  for (int r=1 ; r<=AES_ROUNDS ; r++) {
+    // SubBytes and ShiftRows, the state is stored column by column
+    for (int c=0 ; c<4 ; c++) for (int l=0 ; l<4 ; l++) t[4*c+l] = aes_sbox[s[4*((c+l)%4)+l]];
+    // MixColumns, except in the last round
+    if (r<AES_ROUNDS) for (int c=0 ; c<4 ; c++) {
+      a0 = t[4*c]; a1 = t[4*c+1]; a2 = t[4*c+2]; a3 = t[4*c+3];
+      all = a0 ^ a1 ^ a2 ^ a3;
+      t[4*c]   ^= all ^ aes_xtime(a0 ^ a1);
+      t[4*c+1] ^= all ^ aes_xtime(a1 ^ a2);
+      t[4*c+2] ^= all ^ aes_xtime(a2 ^ a3);
+      t[4*c+3] ^= all ^ aes_xtime(a3 ^ a0);
+    }
+    for (int i=0 ; i<AES_BLOCK_BYTES ; i++) s[i] = t[i] ^ aes_round_keys[r][i];
+  }
+  memcpy(out, s, AES_BLOCK_BYTES);
+}
+
+/**
+  * \fn static void aes_hash_mask(uint8_t * x, const uint8_t * k, uint64_t tweak, uint64_t block)
+  * \brief This function computes x = 2k ^ (tweak, block), the input of pi, k and x being little endian
+*/
+static void aes_hash_mask(uint8_t * x, const uint8_t * k, uint64_t tweak, uint64_t block) {
+
+  uint64_t lo = 0, hi = 0, carry;
+
+  for (int i=7 ; i>=0 ; i--) {
+    lo = (lo<<8) | k[i];
+    hi = (hi<<8) | k[8+i];
+  }
+  // doubling modulo x^128 + x^7 + x^2 + x + 1
+  carry = hi>>63;
+  hi = (hi<<1) | (lo>>63);
+  lo = (lo<<1) ^ (carry*0x87);
+  lo ^= tweak;
+  hi ^= block;
+  for (int i=0 ; i<8 ; i++) {
+    x[i] = (uint8_t) (lo>>(8*i));
+    x[8+i] = (uint8_t) (hi>>(8*i));
+  }
+}
+
+#if AES_HASH_X86
+/**
+  * \fn static void aes_encrypt_aesni(uint8_t * out, const uint8_t * in)
+  * \brief This function encrypts one block with the fixed key, AES-NI implementation
+*/
+__attribute__((target("aes,sse2")))
+static void aes_encrypt_aesni(uint8_t * out, const uint8_t * in) {
+
+  __m128i c = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), _mm_loadu_si128((const __m128i *) aes_round_keys[0]));
+  for (int r=1 ; r<AES_ROUNDS ; r++) c = _mm_aesenc_si128(c, _mm_loadu_si128((const __m128i *) aes_round_keys[r]));
+  c = _mm_aesenclast_si128(c, _mm_loadu_si128((const __m128i *) aes_round_keys[AES_ROUNDS]));
+  _mm_storeu_si128((__m128i *) out, c);
+}
+
+/**
+  * \fn static void aes_pi_xor_aesni(uint8_t * out, const uint8_t * x, int n)
+  * \brief This function computes pi(x_k) ^ x_k for n <= AES_HASH_PIPE blocks, AES-NI implementation
+
+  * The rounds of the n encryptions are interleaved so that the latency of aesenc is hidden.
+*/
+__attribute__((target("aes,sse2")))
+static void aes_pi_xor_aesni(uint8_t * out, const uint8_t * x, int n) {
+
+  __m128i rk, v[AES_HASH_PIPE], c[AES_HASH_PIPE];
+
+  rk = _mm_loadu_si128((const __m128i *) aes_round_keys[0]);
+  for (int k=0 ; k<n ; k++) {
+    v[k] = _mm_loadu_si128((const __m128i *) (x+AES_BLOCK_BYTES*k));
+    c[k] = _mm_xor_si128(v[k], rk);
+  }
+  for (int r=1 ; r<AES_ROUNDS ; r++) {
+    rk = _mm_loadu_si128((const __m128i *) aes_round_keys[r]);
+    for (int k=0 ; k<n ; k++) c[k] = _mm_aesenc_si128(c[k], rk);
+  }
+  rk = _mm_loadu_si128((const __m128i *) aes_round_keys[AES_ROUNDS]);
+  for (int k=0 ; k<n ; k++) {
+    c[k] = _mm_aesenclast_si128(c[k], rk);
+    _mm_storeu_si128((__m128i *) (out+AES_BLOCK_BYTES*k), _mm_xor_si128(c[k], v[k]));
+  }
+}
+#endif
+
+/**
+  * \fn void aes_fixed_encrypt(uint8_t * out, const uint8_t * in)
+  * \brief This function computes the permutation pi, the encryption of one block under the fixed key
+
+  * \param[out] out  bytes array of AES_BLOCK_BYTES representing the ciphertext
+  * \param[in] in    bytes array of AES_BLOCK_BYTES representing the plaintext
+*/
+void aes_fixed_encrypt(uint8_t * out, const uint8_t * in) {
+
+  aes_hash_init();
+#if AES_HASH_X86
+  if (aes_aesni) {
+    aes_encrypt_aesni(out, in);
+    return;
+  }
+#endif
+  aes_encrypt_soft(out, in);
+}
+
+/**
+  * \fn static void aes_pi_xor(uint8_t * out, const uint8_t * x, int n)
+  * \brief This function computes pi(x_k) ^ x_k for n <= AES_HASH_PIPE blocks
+*/
+static void aes_pi_xor(uint8_t * out, const uint8_t * x, int n) {
+
+#if AES_HASH_X86
+  if (aes_aesni) {
+    aes_pi_xor_aesni(out, x, n);
+    return;
+  }
+#endif
+  for (int k=0 ; k<n ; k++) {
+    aes_encrypt_soft(out+AES_BLOCK_BYTES*k, x+AES_BLOCK_BYTES*k);
+    for (int i=0 ; i<AES_BLOCK_BYTES ; i++) out[AES_BLOCK_BYTES*k+i] ^= x[AES_BLOCK_BYTES*k+i];
+  }
+}
+
+/**
+  * \fn void aes_hash_tccr(uint8_t * out, const uint8_t * in, uint64_t tweak, int nb_blocks)
+  * \brief This function computes the hash of a label of nb_blocks blocks with the tweak tweak
+
+  * Each block k_j of the label is replaced by pi(x_j) ^ x_j, x_j = 2k_j ^ (tweak, j).
+
+  * \param[out] out       bytes array of nb_blocks*AES_BLOCK_BYTES representing the hash, it may be in
+  * \param[in] in         bytes array of nb_blocks*AES_BLOCK_BYTES representing the label, little endian
+  * \param[in] tweak      uint64_t representing the tweak, for instance the index of the gate
+  * \param[in] nb_blocks  int representing the number of blocks of the label
+*/
+void aes_hash_tccr(uint8_t * out, const uint8_t * in, uint64_t tweak, int nb_blocks) {
+
+  uint8_t x[AES_HASH_PIPE*AES_BLOCK_BYTES];
+  int n;
+
+  aes_hash_init();
+  for (int b=0 ; b<nb_blocks ; b+=AES_HASH_PIPE) {
+    n = nb_blocks-b<AES_HASH_PIPE ? nb_blocks-b : AES_HASH_PIPE;
+    for (int k=0 ; k<n ; k++) aes_hash_mask(x+AES_BLOCK_BYTES*k, in+AES_BLOCK_BYTES*(b+k), tweak, b+k);
+    aes_pi_xor(out+AES_BLOCK_BYTES*b, x, n);
+  }
+}
+
+/**
+  * \fn void aes_hash_tccr_batch(uint8_t * out, const uint8_t * in, const uint64_t * tweaks, int nb)
+  * \brief This function computes the hashes of nb independent labels of one block, each with its own tweak
+
+  * The label k_j is replaced by pi(x_j) ^ x_j, x_j = 2k_j ^ (tweaks[j], 0), the hash of aes_hash_tccr for a
+  * single block. The encryptions are run AES_HASH_PIPE at a time.
+
+  * \param[out] out     bytes array of nb*AES_BLOCK_BYTES representing the hashes, it may be in
+  * \param[in] in       bytes array of nb*AES_BLOCK_BYTES representing the labels, little endian
+  * \param[in] tweaks   uint64_t array of nb tweaks
+  * \param[in] nb       int representing the number of labels
+*/
+void aes_hash_tccr_batch(uint8_t * out, const uint8_t * in, const uint64_t * tweaks, int nb) {
+
+  uint8_t x[AES_HASH_PIPE*AES_BLOCK_BYTES];
+  int n;
+
+  aes_hash_init();
+  for (int b=0 ; b<nb ; b+=AES_HASH_PIPE) {
+    n = nb-b<AES_HASH_PIPE ? nb-b : AES_HASH_PIPE;
+    for (int k=0 ; k<n ; k++) aes_hash_mask(x+AES_BLOCK_BYTES*k, in+AES_BLOCK_BYTES*(b+k), tweaks[b+k], 0);
+    aes_pi_xor(out+AES_BLOCK_BYTES*b, x, n);
+  }
+}
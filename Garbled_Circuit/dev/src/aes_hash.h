@@ -0,0 +1,20 @@
+/**
+  * \file aes_hash.h
+  * \brief Tweakable correlation robust hash built on AES-128 with a fixed public key, used for the garbling
+*/
+
+#ifndef AES_HASH_H
+#define AES_HASH_H
+
+#include <stdint.h>
+
+#define AES_BLOCK_BYTES 16 /**< size of an AES block */
+#define AES_ROUNDS 10 /**< number of rounds of AES-128 */
+
+void aes_hash_init(void);
+int aes_hash_uses_aesni(void);
+void aes_fixed_encrypt(uint8_t * out, const uint8_t * in);
+void aes_hash_tccr(uint8_t * out, const uint8_t * in, uint64_t tweak, int nb_blocks);
+void aes_hash_tccr_batch(uint8_t * out, const uint8_t * in, const uint64_t * tweaks, int nb);
+
+#endif
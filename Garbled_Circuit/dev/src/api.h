@@ -2,9 +2,9 @@
 #ifndef API_H
 #define API_H
 
-int cmp_Alice_step1(uint8_t * Alice_input, Alice_struct * Alice, OT_sender * Alice_OT);
-int cmp_Bob_step2(uint8_t *  Bob_input, Bob_struct * Bob, OT_receiver * Bob_OT);
-int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT);
+void cmp_Alice_step1(Alice_struct * Alice, OT_sender * Alice_OT, uint8_t * Alice_input, paillier_ctx * ctx);
+void cmp_Bob_step2(Bob_struct * Bob, OT_receiver * Bob_OT, uint8_t * Bob_input, paillier_ctx * ctx);
+int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT, paillier_ctx * ctx);
 int cmp_Bob_step4(Bob_struct * Bob , OT_receiver * Bob_OT);
 
 #endif
\ No newline at end of file
@@ -10,59 +10,120 @@
 #include "time.h"
 #include "parameters.h"
 #include "hash.h"
+#include "aes_hash.h"
 #include "string.h"
 /**
-  * \fn void H(mpz_t out, mpz_t key)
-  *  \brief This function computes the hash of an mpz_t
+  * \fn void H_batch_mpz(mpz_t * out, mpz_t * key, int nb)
+  * \brief This function computes the SHA-512 hashes of nb independent mpz_t, truncated to KEY_SIZE bits, several at a time, see sha512_batch
 
-  * \param[out] out the outputted hash stocked as a mpz_t
+  * \param[out] out  mpz_t array representing the hashes of KEY_SIZE bits, it may be key
 
-  * \param[in] key the value to hash
+  * \param[in] key   mpz_t array representing the values to hash, of at most 512 bits
+  * \param[in] nb    int representing the number of values
 */
-void H(mpz_t out,mpz_t key){
- unsigned char * output=calloc(KEY_SIZE/4,sizeof(unsigned char));
- unsigned char * input=calloc(64,sizeof(unsigned char));
- mpz_export(input,NULL,1,1,0,0,key);
- sha512(output, input,KEY_SIZE/8);
- mpz_import(out,KEY_SIZE/8,-1,1,0,0,output);
- free(output);
- free(input);
+void H_batch_mpz(mpz_t * out, mpz_t * key, int nb) {
+  unsigned char * output=calloc(nb,64), * input=calloc(nb,64);
+  unsigned char ** outputs=calloc(nb,sizeof(unsigned char *)), ** inputs=calloc(nb,sizeof(unsigned char *));
+  size_t * size=calloc(nb,sizeof(size_t));
+
+  for (int i=0 ; i<nb ; i++) {
+    outputs[i]=output+64*i;
+    inputs[i]=input+64*i;
+    mpz_export(inputs[i],&size[i],1,1,0,0,key[i]);
+  }
+  sha512_batch(outputs,inputs,size,nb);
+  for (int i=0 ; i<nb ; i++) mpz_import(out[i],KEY_SIZE/8,-1,1,0,0,outputs[i]);
+
+  free(output);
+  free(input);
+  free(outputs);
+  free(inputs);
+  free(size);
 }
 
 /**
-  * \fn void gen_alea(mpz_t kA, int r)
-  * \brief function generating a random mpz_t of given size
+  * \fn block H_tweak(block key, uint64_t tweak)
+  * \brief This function computes the tweakable fixed-key AES hash of a label, see aes_hash.c
 
-  * \param[out] kA the generated alea
+  * \param[in] key    the label to hash
+  * \param[in] tweak  the tweak, distinct for each use of the label in the circuit
 
-  * \param[in] r a seed
+  * \return the hash of the label
 */
-void gen_alea(mpz_t kA, int r) {
-  //Random generator initialisation
-  gmp_randstate_t seed ;
-  gmp_randinit_default (seed);
-  gmp_randseed_ui(seed,r);
-  mpz_urandomb (kA, seed, KEY_SIZE);
-  gmp_randclear(seed);
+block H_tweak(block key, uint64_t tweak) {
+  uint8_t label[BLOCK_BYTES];
+  block_store(label,key);
+  aes_hash_tccr(label,label,tweak,1);
+  return block_load(label);
 }
 
 /**
-  * \fn void gen_input_key(mpz_t ** kA, mpz_t ** kB, mpz_t offset, int r)
-  * \brief This function generates keys for Alice and Bob
+  * \fn void H_batch(block * out, const block * in, const uint64_t * tweaks, int nb)
+  * \brief This function computes the hashes H_tweak of nb independent labels, their AES encryptions being interleaved
+
+  * \param[out] out    block array representing the hashes, it may be in
+  * \param[in] in      block array representing the labels to hash
+  * \param[in] tweaks  uint64_t array representing the tweak of each label
+  * \param[in] nb      int representing the number of labels
+*/
+void H_batch(block * out, const block * in, const uint64_t * tweaks, int nb) {
+  // a block array is the little endian bytes of its labels, in order
+  aes_hash_tccr_batch((uint8_t *) out,(const uint8_t *) in,tweaks,nb);
+}
 
-  * \param[out] kA    mpz_t double array representing Alice's keys
-  * \param[out] kB    mpz_t double array representing Bob's keys
+/**
+  * \fn void gen_labels(block * k, int nb)
+  * \brief This function generates nb random labels
 
-  * \param[in] offset mpz_t representing the offset used in freeXOR optimization
-  * \param[in] r      int representing a seed
+  * \param[out] k  block array representing the generated labels
+  * \param[in] nb  int representing the number of labels
 */
-void gen_input_key(mpz_t ** kA, mpz_t ** kB, mpz_t offset, int r) {
-  for (int i=0 ; i<PARAM_L+1 ; i++) {
-    gen_alea(kA[i][0],r+i); // Key generation for Alice
-    gen_alea(kB[i][0],r-i); // Key generation for Bob
-    mpz_xor(kA[i][1],kA[i][0],offset);
-    mpz_xor(kB[i][1],kB[i][0],offset);
-  }
+void gen_labels(block * k, int nb) {
+  uint8_t * bytes_array=calloc(nb,BLOCK_BYTES);
+  random_bytes(bytes_array,nb*BLOCK_BYTES);
+  for (int i=0 ; i<nb ; i++) k[i]=block_load(bytes_array+i*BLOCK_BYTES);
+  free(bytes_array);
+}
+
+/**
+  * \fn void gen_offset(block * offset)
+  * \brief This function generates the global offset of the freeXOR optimization
+
+  * \param[out] offset the generated offset, odd so that xoring with it changes the signal bit
+*/
+void gen_offset(block * offset) {
+  uint8_t bytes_array[BLOCK_BYTES];
+  random_bytes(bytes_array,BLOCK_BYTES);
+  bytes_array[0]|=1;
+  *offset=block_load(bytes_array);
+}
+
+/**
+  * \fn block mpz_get_block(mpz_t a)
+  * \brief This function converts a key of KEY_SIZE bits transferred by the OTs to a label
+
+  * \param[in] a  mpz_t representing the key
+
+  * \return the label whose little endian bytes are the ones of a
+*/
+block mpz_get_block(mpz_t a) {
+  uint8_t bytes_array[BLOCK_BYTES];
+  memset(bytes_array,0,BLOCK_BYTES);
+  mpz_export(bytes_array,NULL,-1,1,0,0,a);
+  return block_load(bytes_array);
+}
+
+/**
+  * \fn void mpz_set_block(mpz_t a, block b)
+  * \brief This function converts a label to a key of KEY_SIZE bits transferred by the OTs
+
+  * \param[out] a  mpz_t representing the key
+  * \param[in] b   block representing the label
+*/
+void mpz_set_block(mpz_t a, block b) {
+  uint8_t bytes_array[BLOCK_BYTES];
+  block_store(bytes_array,b);
+  mpz_import(a,BLOCK_BYTES,-1,1,0,0,bytes_array);
 }
 
 /**
@@ -92,132 +153,94 @@ uint32_t bits_to_bytes(uint32_t nb_bits) {
 }
 
 /**
-  * \fn void cmp_Bob_gen_inputs(mpz_t ct_gamma, mpz_t rho, mpz_t ct_Alice, mpz_t Bob)
+  * \fn void cmp_Bob_gen_inputs(mpz_t ct_gamma, mpz_t rho, mpz_t ct_Alice, mpz_t Bob, paillier_ctx * ctx)
   * \brief This function generate Bob's new input and Alice's new input ciphertext
 
   * \param[out] ct_gamma  mpz_t representing new Alice's input ciphertext
   * \param[out] rho       mpz_t representing the new Bob's input
   * \param[in] ct_Alice   mpz_t representing Alice's input ciphertext
   * \param[in] Bob        mpz_t representing Bob's input
+  * \param[in] ctx        paillier_ctx representing Alice's public key
 */
-void cmp_Bob_gen_inputs(mpz_t ct_gamma, mpz_t rho, mpz_t ct_Alice, mpz_t Bob) {
+void cmp_Bob_gen_inputs(mpz_t ct_gamma, mpz_t rho, mpz_t ct_Alice, mpz_t Bob, paillier_ctx * ctx) {
 
-  srand(time(NULL));
   gmp_randstate_t seed ;
-  mpz_t p,q,n,temp,n_squared;
-
-  mpz_inits(p,q,n,temp,n_squared, NULL);
-  gmp_randinit_default (seed);
-  gmp_randseed_ui(seed,time(NULL));
-
-  mpz_set_str(p,PAILLIER_SK_P,16);
-  mpz_set_str(q,PAILLIER_SK_Q,16);
-  mpz_mul(n,p,q);
-  mpz_mul(n_squared,n,n);
+  random_seed(seed);
 
   mpz_urandomb(rho,seed,PARAM_L+PARAM_K);
   mpz_ui_pow_ui(ct_gamma,2,PARAM_L);
   mpz_add(ct_gamma,ct_gamma,rho);
   mpz_sub(ct_gamma,ct_gamma,Bob);
-  paillier_encrypt(ct_gamma,ct_gamma);
-  mpz_mul(ct_gamma,ct_gamma,ct_Alice);
-  mpz_mod(ct_gamma,ct_gamma,n_squared);
+  paillier_encrypt(ct_gamma,ct_gamma,ctx);
+  paillier_add(ct_gamma,ct_gamma,ct_Alice,ctx);
 
   gmp_randclear(seed);
-  mpz_clears(p,q,n,temp,n_squared, NULL);
 }
 
 /**
-  * \fn int mpz_quad_res(mpz_t x,mpz_t q,mpz_t n)
-  * \brief This function computes quadratic residuosity
-
-  * \param[out] x mpz_t representing the quadratic residuosity
-
-  * \param[in] q  mpz_t representing the value to compute QR of
-  * \param[in] n  mpz_t representing the size of the field on which we compute the QR
-
-  * \return -1 if q is quadratic non-residue mod n,
-  * \return  1 if q is quadratic residue mod n,
-  * \return 0 if q is congruent to 0 mod n
-  */
-int mpz_quad_res(mpz_t x,mpz_t q,mpz_t n) { // https://gmplib.org/list-archives/gmp-discuss/2013-April/005303.html David Gillies
-  int leg;
-  mpz_t tmp,ofac,nr,t,r,c,b;
-  unsigned int mod4;
-  mp_bitcnt_t twofac=0,m,i,ix;
-
-  mod4=mpz_tstbit(n,0);
-  if(!mod4) // must be odd
-    return 0;
-
-  mod4+=2*mpz_tstbit(n,1);
-
-  leg=mpz_legendre(q,n);
-  if(leg!=1)
-    return leg;
-
-  mpz_init_set(tmp,n);
-
-  if(mod4==3) // directly, x = q^(n+1)/4 mod n
-    {
-    mpz_add_ui(tmp,tmp,1UL);
-    mpz_tdiv_q_2exp(tmp,tmp,2);
-    mpz_powm(x,q,tmp,n);
-    mpz_clear(tmp);
-    }
-  else // Tonelli-Shanks
-    {
-    mpz_inits(ofac,t,r,c,b,NULL);
-
-    // split n - 1 into odd number times power of 2 ofac*2^twofac
-    mpz_sub_ui(tmp,tmp,1UL);
-    twofac=mpz_scan1(tmp,twofac); // largest power of 2 divisor
-    if(twofac)
-      mpz_tdiv_q_2exp(ofac,tmp,twofac); // shift right
-
-      // look for non-residue
-    mpz_init_set_ui(nr,2UL);
-    while(mpz_legendre(nr,n)!=-1)
-      mpz_add_ui(nr,nr,1UL);
-
-    mpz_powm(c,nr,ofac,n); // c = nr^ofac mod n
-
-    mpz_add_ui(tmp,ofac,1UL);
-    mpz_tdiv_q_2exp(tmp,tmp,1);
-    mpz_powm(r,q,tmp,n); // r = q^(ofac+1)/2 mod n
-
-    mpz_powm(t,q,ofac,n);
-    mpz_mod(t,t,n); // t = q^ofac mod n
-
-    if(mpz_cmp_ui(t,1UL)!=0) // if t = 1 mod n we're done
-      {
-      m=twofac;
-      do
-              {
-              i=2;
-              ix=1;
-              while(ix<m)
-                  {
-                  // find lowest 0 < ix < m | t^2^ix = 1 mod n
-                  mpz_powm_ui(tmp,t,i,n); // repeatedly square t
-                  if(mpz_cmp_ui(tmp,1UL)==0)
-                      break;
-                  i<<=1; // i = 2, 4, 8, ...
-                  ix++; // ix is log2 i
-                  }
-              mpz_powm_ui(b,c,1<<(m-ix-1),n); // b = c^2^(m-ix-1) mod n
-              mpz_mul(r,r,b);
-              mpz_mod(r,r,n); // r = r*b mod n
-              mpz_mul(c,b,b);
-              mpz_mod(c,c,n); // c = b^2 mod n
-              mpz_mul(t,t,c);
-              mpz_mod(t,t,n); // t = t b^2 mod n
-              m=ix;
-              }while(mpz_cmp_ui(t,1UL)!=0); // while t mod n != 1
-          }
-      mpz_set(x,r);
-      mpz_clears(tmp,ofac,nr,t,r,c,b,NULL);
-      }
-
-  return 1;
+  * \fn void cmp_pack(mpz_t packed, mpz_t * values, int nb)
+  * \brief This function packs values into slots of PARAM_SLOT_SIZE bits of a single plaintext
+
+  * \param[out] packed  mpz_t representing the sum of values[i] * 2^(i*PARAM_SLOT_SIZE)
+
+  * \param[in] values   mpz_t array representing the values to pack, each smaller than 2^PARAM_SLOT_SIZE
+  * \param[in] nb       int representing the number of values
+*/
+void cmp_pack(mpz_t packed, mpz_t * values, int nb) {
+  mpz_set_ui(packed,0);
+  for (int i=nb-1 ; i>=0 ; i--) {
+    mpz_mul_2exp(packed,packed,PARAM_SLOT_SIZE);
+    mpz_add(packed,packed,values[i]);
+  }
+}
+
+/**
+  * \fn void cmp_unpack(mpz_t * values, mpz_t packed, int nb)
+  * \brief This function extracts the values packed by cmp_pack
+
+  * \param[out] values  mpz_t array representing the unpacked values
+
+  * \param[in] packed   mpz_t representing the packed plaintext
+  * \param[in] nb       int representing the number of values
+*/
+void cmp_unpack(mpz_t * values, mpz_t packed, int nb) {
+  for (int i=0 ; i<nb ; i++) {
+    mpz_tdiv_q_2exp(values[i],packed,i*PARAM_SLOT_SIZE);
+    mpz_fdiv_r_2exp(values[i],values[i],PARAM_SLOT_SIZE);
+  }
+}
+
+/**
+  * \fn void cmp_Bob_gen_packed_inputs(mpz_t ct_gamma, mpz_t * rho, mpz_t ct_Alice, mpz_t * Bob, int nb, paillier_ctx * ctx)
+  * \brief This function generates Bob's new inputs and Alice's packed new inputs ciphertext
+
+  * Slot i of the plaintext of ct_gamma holds 2^PARAM_L + rho[i] - Bob[i] + a_i, where a_i is slot i of Alice's packed input.
+
+  * \param[out] ct_gamma  mpz_t representing Alice's packed new inputs ciphertext
+  * \param[out] rho       mpz_t array representing Bob's new inputs
+  * \param[in] ct_Alice   mpz_t representing Alice's packed inputs ciphertext
+  * \param[in] Bob        mpz_t array representing Bob's inputs
+  * \param[in] nb         int representing the number of comparisons, at most PARAM_SLOTS
+  * \param[in] ctx        paillier_ctx representing Alice's public key
+*/
+void cmp_Bob_gen_packed_inputs(mpz_t ct_gamma, mpz_t * rho, mpz_t ct_Alice, mpz_t * Bob, int nb, paillier_ctx * ctx) {
+
+  gmp_randstate_t seed ;
+  mpz_t * blinded = calloc(nb,sizeof(mpz_t));
+  random_seed(seed);
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_init(blinded[i]);
+    mpz_urandomb(rho[i],seed,PARAM_L+PARAM_K);
+    mpz_ui_pow_ui(blinded[i],2,PARAM_L);
+    mpz_add(blinded[i],blinded[i],rho[i]);
+    mpz_sub(blinded[i],blinded[i],Bob[i]);
+  }
+  cmp_pack(ct_gamma,blinded,nb);
+  paillier_encrypt(ct_gamma,ct_gamma,ctx);
+  paillier_add(ct_gamma,ct_gamma,ct_Alice,ctx);
+
+  for (int i=0 ; i<nb ; i++) mpz_clear(blinded[i]);
+  free(blinded);
+  gmp_randclear(seed);
 }
@@ -21,13 +21,25 @@
 #include "gmp.h"
 #include "parameters.h"
 #include "paillier.h"
+#include "paillier_ops.h"
 #include <stdint.h>
+#include "block.h"
 
-void H(mpz_t out, mpz_t key);
-void gen_alea(mpz_t kA, int r);
-void gen_input_key(mpz_t ** kA, mpz_t ** kB, mpz_t offset, int r);
-void cmp_Bob_gen_inputs(mpz_t ct_gamma, mpz_t rho, mpz_t Alice, mpz_t Bob);
-int mpz_quad_res(mpz_t x,mpz_t q,mpz_t n);
+#if KEY_SIZE != 8*BLOCK_BYTES
+#error "the keys transferred by the OTs are the 128-bit labels of the garbled circuit"
+#endif
+
+void H_batch_mpz(mpz_t * out, mpz_t * key, int nb);
+block H_tweak(block key, uint64_t tweak);
+void H_batch(block * out, const block * in, const uint64_t * tweaks, int nb);
+void gen_labels(block * k, int nb);
+void gen_offset(block * offset);
+block mpz_get_block(mpz_t a);
+void mpz_set_block(mpz_t a, block b);
+void cmp_Bob_gen_inputs(mpz_t ct_gamma, mpz_t rho, mpz_t Alice, mpz_t Bob, paillier_ctx * ctx);
+void cmp_pack(mpz_t packed, mpz_t * values, int nb);
+void cmp_unpack(mpz_t * values, mpz_t packed, int nb);
+void cmp_Bob_gen_packed_inputs(mpz_t ct_gamma, mpz_t * rho, mpz_t ct_Alice, mpz_t * Bob, int nb, paillier_ctx * ctx);
 void random_bytes_pairs(uint8_t* x , uint8_t* y, uint32_t nb_bytes);
 uint32_t bits_to_bytes(uint32_t nb_bits);
 
@@ -0,0 +1,67 @@
+/**
+  * \file block.h
+  * \brief 128-bit wire labels of the garbled circuits, an SSE2 register or a pair of 64-bit words
+*/
+
+#ifndef BLOCK_H
+#define BLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define BLOCK_BYTES 16 /**< size of a label */
+
+#if defined(__SSE2__) && !defined(BLOCK_NO_SSE2)
+#include <emmintrin.h>
+
+/**
+  * \typedef block
+  * \brief 128-bit label, its bytes are stored little endian and its least significant bit is the signal bit
+  */
+typedef __m128i block;
+
+/** \brief This function returns the label 0 */
+static inline block block_zero(void) { return _mm_setzero_si128(); }
+/** \brief This function returns a ^ b */
+static inline block block_xor(block a, block b) { return _mm_xor_si128(a, b); }
+/** \brief This function returns a if bit is 1, the label 0 otherwise */
+static inline block block_select(block a, int bit) { return _mm_and_si128(a, _mm_set1_epi32(-(bit&1))); }
+/** \brief This function returns the least significant bit of a, the signal bit */
+static inline int block_lsb(block a) { return _mm_cvtsi128_si32(a) & 1; }
+/** \brief This function returns 1 if a and b are equal */
+static inline int block_equal(block a, block b) { return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xffff; }
+/** \brief This function reads a label from BLOCK_BYTES bytes */
+static inline block block_load(const uint8_t * in) { return _mm_loadu_si128((const __m128i *) in); }
+/** \brief This function writes a label to BLOCK_BYTES bytes */
+static inline void block_store(uint8_t * out, block a) { _mm_storeu_si128((__m128i *) out, a); }
+
+#else
+
+/**
+  * \typedef block
+  * \brief 128-bit label, its bytes are stored little endian and its least significant bit is the signal bit
+  */
+typedef struct block {
+	uint64_t w[2] __attribute__((aligned(16))) ; /**< the bytes of the label, in memory order */
+} block ;
+
+/** \brief This function returns the label 0 */
+static inline block block_zero(void) { block r = {{0, 0}}; return r; }
+/** \brief This function returns a ^ b */
+static inline block block_xor(block a, block b) { block r = {{a.w[0]^b.w[0], a.w[1]^b.w[1]}}; return r; }
+/** \brief This function returns a if bit is 1, the label 0 otherwise */
+static inline block block_select(block a, int bit) { uint64_t m = -(uint64_t) (bit&1); block r = {{a.w[0]&m, a.w[1]&m}}; return r; }
+/** \brief This function returns the least significant bit of a, the signal bit */
+static inline int block_lsb(block a) { uint8_t b; memcpy(&b, a.w, 1); return b & 1; }
+/** \brief This function returns 1 if a and b are equal */
+static inline int block_equal(block a, block b) { return ((a.w[0]^b.w[0]) | (a.w[1]^b.w[1])) == 0; }
+/** \brief This function reads a label from BLOCK_BYTES bytes */
+static inline block block_load(const uint8_t * in) { block r; memcpy(r.w, in, BLOCK_BYTES); return r; }
+/** \brief This function writes a label to BLOCK_BYTES bytes */
+static inline void block_store(uint8_t * out, block a) { memcpy(out, a.w, BLOCK_BYTES); }
+
+#endif
+
+_Static_assert(sizeof(block) == BLOCK_BYTES, "a block array is the bytes of its labels");
+
+#endif
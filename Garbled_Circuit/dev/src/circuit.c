@@ -0,0 +1,563 @@
+/**
+  * \file circuit.c
+  * \brief implementation of the Bristol Fashion circuits, their builders and their generic garbling and evaluation
+
+  * A Bristol Fashion file starts with the number of gates and of wires, then the number of inputs followed by
+  * their sizes in bits, and the number of outputs followed by their sizes. Each gate is then a line
+  * "nb_in nb_out in... out TYPE", with the types XOR, AND, INV, EQW (copy) and EQ (the input is a constant).
+  * The circuits are garbled with freeXOR, only the label of value 0 of each wire is kept by the garbler.
+*/
+
+#include "circuit.h"
+
+/**
+	* \fn circuit * circuit_init()
+	* \brief This function initializes an empty circuit, to be set by circuit_load or by one of the builders
+
+	* \return C an initialized circuit variable
+*/
+circuit * circuit_init() {
+  circuit * C = (circuit *) calloc(1,sizeof(circuit));
+  return C;
+}
+
+/**
+  * \fn void circuit_clear(circuit * C)
+  * \brief This function clears a circuit variable
+
+  * \param[in] C the structure to release
+*/
+void circuit_clear(circuit * C) {
+  free(C->type);
+  free(C->in0);
+  free(C->in1);
+  free(C->out);
+  free(C);
+}
+
+/**
+  * \fn static void circuit_push(circuit * C, int type, uint32_t a, uint32_t b, uint32_t o)
+  * \brief This function appends the gate o = type(a, b) to the circuit, growing its arrays if needed
+*/
+static void circuit_push(circuit * C, int type, uint32_t a, uint32_t b, uint32_t o) {
+  if (C->nb_gates==C->capacity) {
+    C->capacity=C->capacity ? 2*C->capacity : 1024;
+    C->type=realloc(C->type,C->capacity*sizeof(uint8_t));
+    C->in0=realloc(C->in0,C->capacity*sizeof(uint32_t));
+    C->in1=realloc(C->in1,C->capacity*sizeof(uint32_t));
+    C->out=realloc(C->out,C->capacity*sizeof(uint32_t));
+  }
+  C->type[C->nb_gates]=type;
+  C->in0[C->nb_gates]=a;
+  C->in1[C->nb_gates]=b;
+  C->out[C->nb_gates]=o;
+  C->nb_gates++;
+  C->nb_and+=(type==CIRCUIT_AND);
+}
+
+/**
+  * \fn static int circuit_set_io(int * sizes, int * nb, int * nb_wires, int nb_values, const int * values)
+  * \brief This function sets the sizes of the inputs or of the outputs of a circuit
+
+  * \return 0 if the sizes are set
+  * \return 2 if there are more than CIRCUIT_MAX_IO values or a size is not positive
+*/
+static int circuit_set_io(int * sizes, int * nb, int * nb_wires, int nb_values, const int * values) {
+  if (nb_values<0 || nb_values>CIRCUIT_MAX_IO) return 2;
+  *nb=nb_values;
+  *nb_wires=0;
+  for (int i=0 ; i<nb_values ; i++) {
+    if (values[i]<=0) return 2;
+    sizes[i]=values[i];
+    *nb_wires+=values[i];
+  }
+  return 0;
+}
+
+/**
+  * \fn int circuit_load(circuit * C, char * path)
+  * \brief This function sets a circuit from a Bristol Fashion file
+
+  * The gates must be in topological order, every wire being set by a single gate, as in the files of the format.
+
+  * \param[out] C     circuit freshly initialized, set to the stored circuit
+
+  * \param[in] path   char array representing the path of the file
+
+  * \return 0 if the circuit is loaded
+  * \return 1 if the file can not be read
+  * \return 2 if the file is not a Bristol Fashion circuit, or uses a gate other than XOR, AND, INV, EQW and EQ
+*/
+int circuit_load(circuit * C, char * path) {
+
+  int nb_gates, nb_wires, nb, sizes[CIRCUIT_MAX_IO], nb_in, nb_out, w[3], error=0;
+  char name[8];
+  uint8_t * set;
+  FILE * file=fopen(path,"r");
+  if (file==NULL) return 1;
+
+  if (fscanf(file,"%d %d",&nb_gates,&nb_wires)!=2 || nb_gates<0 || nb_wires<=0) error=2;
+  if (!error && (fscanf(file,"%d",&nb)!=1 || nb<0 || nb>CIRCUIT_MAX_IO)) error=2;
+  for (int i=0 ; i<nb && !error ; i++) if (fscanf(file,"%d",&sizes[i])!=1) error=2;
+  if (!error) error=circuit_set_io(C->input_sizes,&C->nb_inputs,&C->nb_input_wires,nb,sizes);
+  if (!error && (fscanf(file,"%d",&nb)!=1 || nb<0 || nb>CIRCUIT_MAX_IO)) error=2;
+  for (int i=0 ; i<nb && !error ; i++) if (fscanf(file,"%d",&sizes[i])!=1) error=2;
+  if (!error) error=circuit_set_io(C->output_sizes,&C->nb_outputs,&C->nb_output_wires,nb,sizes);
+  if (!error && C->nb_input_wires+C->nb_output_wires>nb_wires) error=2;
+  if (error) {
+    fclose(file);
+    return error;
+  }
+
+  //Every input of a gate must be an input of the circuit or the output of a previous gate
+  set=calloc(nb_wires,sizeof(uint8_t));
+  memset(set,1,C->nb_input_wires);
+  for (int g=0 ; g<nb_gates && !error ; g++) {
+    if (fscanf(file,"%d %d",&nb_in,&nb_out)!=2 || nb_in<1 || nb_in>2 || nb_out!=1) {
+      error=2;
+      break;
+    }
+    for (int i=0 ; i<nb_in+1 && !error ; i++) if (fscanf(file,"%d",&w[i])!=1 || w[i]<0 || w[i]>=nb_wires) error=2;
+    if (error || fscanf(file,"%7s",name)!=1) {
+      error=2;
+      break;
+    }
+    int type=-1, o=w[nb_in];
+    if (nb_in==2 && !strcmp(name,"XOR")) type=CIRCUIT_XOR;
+    if (nb_in==2 && !strcmp(name,"AND")) type=CIRCUIT_AND;
+    if (nb_in==1 && !strcmp(name,"INV")) type=CIRCUIT_INV;
+    if (nb_in==1 && !strcmp(name,"EQW")) type=CIRCUIT_EQW;
+    if (nb_in==1 && !strcmp(name,"EQ") && w[0]<2) type=CIRCUIT_EQ;
+    if (type<0 || set[o] || (type!=CIRCUIT_EQ && !set[w[0]]) || (nb_in==2 && !set[w[1]])) {
+      error=2;
+      break;
+    }
+    set[o]=1;
+    circuit_push(C,type,w[0],nb_in==2 ? w[1] : 0,o);
+  }
+  for (int i=nb_wires-C->nb_output_wires ; i<nb_wires && !error ; i++) if (!set[i]) error=2;
+  C->nb_wires=nb_wires;
+
+  free(set);
+  fclose(file);
+  return error;
+}
+
+/**
+  * \fn int circuit_save(const circuit * C, char * path)
+  * \brief This function writes a circuit to a Bristol Fashion file, read back by circuit_load
+
+  * \param[in] C      circuit to write
+  * \param[in] path   char array representing the path of the file
+
+  * \return 0 if the circuit is written
+  * \return 1 if the file can not be written
+*/
+int circuit_save(const circuit * C, char * path) {
+
+  static const char * names[5]={"XOR","AND","INV","EQW","EQ"};
+  int error=0;
+  FILE * file=fopen(path,"w");
+  if (file==NULL) return 1;
+
+  error|=(fprintf(file,"%d %d\n%d",C->nb_gates,C->nb_wires,C->nb_inputs)<0);
+  for (int i=0 ; i<C->nb_inputs ; i++) error|=(fprintf(file," %d",C->input_sizes[i])<0);
+  error|=(fprintf(file,"\n%d",C->nb_outputs)<0);
+  for (int i=0 ; i<C->nb_outputs ; i++) error|=(fprintf(file," %d",C->output_sizes[i])<0);
+  error|=(fprintf(file,"\n\n")<0);
+  for (int g=0 ; g<C->nb_gates ; g++) {
+    if (C->type[g]==CIRCUIT_XOR || C->type[g]==CIRCUIT_AND) error|=(fprintf(file,"2 1 %u %u %u %s\n",C->in0[g],C->in1[g],C->out[g],names[C->type[g]])<0);
+    else error|=(fprintf(file,"1 1 %u %u %s\n",C->in0[g],C->out[g],names[C->type[g]])<0);
+  }
+
+  error|=(fclose(file)!=0);
+  return error;
+}
+
+/*
+  Builders. A wire is an int, -1 standing for the constant 0, so that the gates with a constant input are
+  simplified away instead of being garbled.
+*/
+
+/**
+  * \fn static int circuit_gate(circuit * C, int type, int a, int b)
+  * \brief This function appends the gate type(a, b) on a new wire and returns the wire
+*/
+static int circuit_gate(circuit * C, int type, int a, int b) {
+  circuit_push(C,type,a,b,C->nb_wires);
+  return C->nb_wires++;
+}
+
+/**
+  * \fn static int circuit_xor(circuit * C, int a, int b)
+  * \brief This function returns a wire of a ^ b
+*/
+static int circuit_xor(circuit * C, int a, int b) {
+  if (a<0) return b;
+  if (b<0) return a;
+  return circuit_gate(C,CIRCUIT_XOR,a,b);
+}
+
+/**
+  * \fn static int circuit_and(circuit * C, int a, int b)
+  * \brief This function returns a wire of a & b
+*/
+static int circuit_and(circuit * C, int a, int b) {
+  if (a<0 || b<0) return -1;
+  return circuit_gate(C,CIRCUIT_AND,a,b);
+}
+
+/**
+  * \fn static int circuit_not(circuit * C, int a)
+  * \brief This function returns a wire of !a
+*/
+static int circuit_not(circuit * C, int a) {
+  if (a<0) return circuit_gate(C,CIRCUIT_EQ,1,0);
+  return circuit_gate(C,CIRCUIT_INV,a,0);
+}
+
+/**
+  * \fn static int circuit_mux(circuit * C, int s, int a, int b)
+  * \brief This function returns a wire of b if s is 1, of a otherwise, with one AND gate
+*/
+static int circuit_mux(circuit * C, int s, int a, int b) {
+  return circuit_xor(C,a,circuit_and(C,s,circuit_xor(C,a,b)));
+}
+
+/**
+  * \fn static void circuit_begin(circuit * C, int nb, const int * sizes)
+  * \brief This function starts a circuit with nb inputs, its first wires
+*/
+static void circuit_begin(circuit * C, int nb, const int * sizes) {
+  circuit_set_io(C->input_sizes,&C->nb_inputs,&C->nb_input_wires,nb,sizes);
+  C->nb_wires=C->nb_input_wires;
+}
+
+/**
+  * \fn static void circuit_end(circuit * C, const int * wires, int nb, const int * sizes)
+  * \brief This function copies the wires of the nb outputs to the last wires of the circuit
+*/
+static void circuit_end(circuit * C, const int * wires, int nb, const int * sizes) {
+  circuit_set_io(C->output_sizes,&C->nb_outputs,&C->nb_output_wires,nb,sizes);
+  for (int i=0 ; i<C->nb_output_wires ; i++) {
+    if (wires[i]<0) circuit_gate(C,CIRCUIT_EQ,0,0);
+    else circuit_gate(C,CIRCUIT_EQW,wires[i],0);
+  }
+}
+
+/**
+  * \fn static int circuit_cmp_chain(circuit * C, int a, int b, int l, int x, int use_b)
+  * \brief This function compares the l bits from the wires a and b, least significant first, with one AND gate per bit
+
+  * The carry x becomes ((a_i ^ x) & (b_i ^ x)) ^ b_i (use_b) or ^ a_i, that is b_i (or a_i) if a_i != b_i and x otherwise.
+*/
+static int circuit_cmp_chain(circuit * C, int a, int b, int l, int x, int use_b) {
+  for (int i=0 ; i<l ; i++) {
+    int A=circuit_and(C,circuit_xor(C,a+i,x),circuit_xor(C,b+i,x));
+    x=circuit_xor(C,A,use_b ? b+i : a+i);
+  }
+  return x;
+}
+
+/**
+  * \fn void circuit_cmp(circuit * C, int l, int ineq)
+  * \brief This function builds the comparison circuit of the protocol
+
+  * Its inputs are the l+1 bits of Alice and the l+1 bits of Bob, its output is the carry of the l first bits, as
+  * selected by ineq (see PARAM_INEQ), xored with the bits l of both inputs. It has l AND gates.
+
+  * \param[out] C     circuit freshly initialized
+
+  * \param[in] l      int representing the size of the compared values
+  * \param[in] ineq   int representing the inequation, as PARAM_INEQ
+*/
+void circuit_cmp(circuit * C, int l, int ineq) {
+  int sizes[2]={l+1,l+1}, one=1, out;
+  circuit_begin(C,2,sizes);
+  out=circuit_cmp_chain(C,0,l+1,l,-1,ineq % 4 > 1);
+  out=circuit_xor(C,l,circuit_xor(C,2*l+1,out));
+  circuit_end(C,&out,1,&one);
+}
+
+/**
+  * \fn void circuit_eq(circuit * C, int l)
+  * \brief This function builds the equality test of two values of l bits, with l-1 AND gates in a tree
+
+  * \param[out] C     circuit freshly initialized
+
+  * \param[in] l      int representing the size of the values
+*/
+void circuit_eq(circuit * C, int l) {
+  int sizes[2]={l,l}, one=1, * e=calloc(l,sizeof(int));
+  circuit_begin(C,2,sizes);
+  for (int i=0 ; i<l ; i++) e[i]=circuit_not(C,circuit_xor(C,i,l+i));
+  for (int n=l ; n>1 ; n=(n+1)/2) {
+    for (int i=0 ; i<n/2 ; i++) e[i]=circuit_and(C,e[2*i],e[2*i+1]);
+    if (n%2) e[n/2]=e[n-1];
+  }
+  circuit_end(C,e,1,&one);
+  free(e);
+}
+
+/**
+  * \fn void circuit_add(circuit * C, int l)
+  * \brief This function builds the addition of two values of l bits, ripple carry with one AND gate per bit
+
+  * \param[out] C     circuit freshly initialized, its output has l+1 bits
+
+  * \param[in] l      int representing the size of the values
+*/
+void circuit_add(circuit * C, int l) {
+  int sizes[2]={l,l}, size=l+1, c=-1, * s=calloc(l+1,sizeof(int));
+  circuit_begin(C,2,sizes);
+  for (int i=0 ; i<l ; i++) {
+    s[i]=circuit_xor(C,circuit_xor(C,i,l+i),c);
+    c=circuit_xor(C,c,circuit_and(C,circuit_xor(C,i,c),circuit_xor(C,l+i,c)));
+  }
+  s[l]=c;
+  circuit_end(C,s,1,&size);
+  free(s);
+}
+
+/**
+  * \fn void circuit_max(circuit * C, int l)
+  * \brief This function builds the maximum of two values of l bits, a comparison then a selection, 2 l AND gates
+
+  * \param[out] C     circuit freshly initialized
+
+  * \param[in] l      int representing the size of the values
+*/
+void circuit_max(circuit * C, int l) {
+  int sizes[2]={l,l}, lt, * m=calloc(l,sizeof(int));
+  circuit_begin(C,2,sizes);
+  lt=circuit_cmp_chain(C,0,l,l,-1,1);
+  for (int i=0 ; i<l ; i++) m[i]=circuit_mux(C,lt,i,l+i);
+  circuit_end(C,m,1,&l);
+  free(m);
+}
+
+/**
+  * \fn static void gf256_reduce(circuit * C, int * r, int * p)
+  * \brief This function reduces the 15 coefficients p modulo x^8 + x^4 + x^3 + x + 1 into the 8 wires r
+*/
+static void gf256_reduce(circuit * C, int * r, int * p) {
+  for (int k=14 ; k>=8 ; k--) {
+    p[k-4]=circuit_xor(C,p[k-4],p[k]);
+    p[k-5]=circuit_xor(C,p[k-5],p[k]);
+    p[k-7]=circuit_xor(C,p[k-7],p[k]);
+    p[k-8]=circuit_xor(C,p[k-8],p[k]);
+  }
+  memcpy(r,p,8*sizeof(int));
+}
+
+/**
+  * \fn static void gf256_mul(circuit * C, int * r, const int * a, const int * b)
+  * \brief This function sets the 8 wires r to the product a b in GF(2^8), with 64 AND gates
+*/
+static void gf256_mul(circuit * C, int * r, const int * a, const int * b) {
+  int p[15];
+  for (int k=0 ; k<15 ; k++) p[k]=-1;
+  for (int i=0 ; i<8 ; i++) for (int j=0 ; j<8 ; j++) p[i+j]=circuit_xor(C,p[i+j],circuit_and(C,a[i],b[j]));
+  gf256_reduce(C,r,p);
+}
+
+/**
+  * \fn static void gf256_square(circuit * C, int * r, const int * a, int n)
+  * \brief This function sets the 8 wires r to a^(2^n) in GF(2^8), squaring is linear and has no AND gate
+*/
+static void gf256_square(circuit * C, int * r, const int * a, int n) {
+  int p[15], t[8];
+  memcpy(t,a,8*sizeof(int));
+  for (int k=0 ; k<n ; k++) {
+    for (int i=0 ; i<15 ; i++) p[i]=(i%2) ? -1 : t[i/2];
+    gf256_reduce(C,t,p);
+  }
+  memcpy(r,t,8*sizeof(int));
+}
+
+/**
+  * \fn static void aes_sbox(circuit * C, int * r, const int * a)
+  * \brief This function sets the 8 wires r to the AES S-box of a, the inverse a^254 then the affine map, 256 AND gates
+*/
+static void aes_sbox(circuit * C, int * r, const int * a) {
+  int a2[8], a3[8], a12[8], a15[8], a240[8], t[8];
+  gf256_square(C,a2,a,1);
+  gf256_mul(C,a3,a2,a);
+  gf256_square(C,a12,a3,2);
+  gf256_mul(C,a15,a12,a3);
+  gf256_square(C,a240,a15,4);
+  gf256_mul(C,t,a240,a12);
+  gf256_mul(C,t,t,a2);
+  for (int i=0 ; i<8 ; i++) {
+    r[i]=t[i];
+    for (int j=4 ; j<8 ; j++) r[i]=circuit_xor(C,r[i],t[(i+j)%8]);
+    if ((0x63>>i) & 1) r[i]=circuit_not(C,r[i]);
+  }
+}
+
+/**
+  * \fn static void aes_xtime(circuit * C, int * r, const int * a)
+  * \brief This function sets the 8 wires r to x a in GF(2^8)
+*/
+static void aes_xtime(circuit * C, int * r, const int * a) {
+  int t[8]={a[7],circuit_xor(C,a[0],a[7]),a[1],circuit_xor(C,a[2],a[7]),circuit_xor(C,a[3],a[7]),a[4],a[5],a[6]};
+  memcpy(r,t,8*sizeof(int));
+}
+
+/**
+  * \fn static void aes_add_round_key(circuit * C, int s[16][8], int k[16][8])
+  * \brief This function xors the round key k to the state s
+*/
+static void aes_add_round_key(circuit * C, int s[16][8], int k[16][8]) {
+  for (int i=0 ; i<16 ; i++) for (int j=0 ; j<8 ; j++) s[i][j]=circuit_xor(C,s[i][j],k[i][j]);
+}
+
+/**
+  * \fn static void aes_next_round_key(circuit * C, int k[16][8], int rcon)
+  * \brief This function replaces the round key k by the next one of the AES-128 key schedule
+*/
+static void aes_next_round_key(circuit * C, int k[16][8], int rcon) {
+  int t[4][8];
+  for (int i=0 ; i<4 ; i++) aes_sbox(C,t[i],k[12+(i+1)%4]);
+  for (int j=0 ; j<8 ; j++) if ((rcon>>j) & 1) t[0][j]=circuit_not(C,t[0][j]);
+  for (int c=0 ; c<4 ; c++) for (int i=0 ; i<4 ; i++) for (int j=0 ; j<8 ; j++) {
+    k[4*c+i][j]=circuit_xor(C,k[4*c+i][j],t[i][j]);
+    t[i][j]=k[4*c+i][j];
+  }
+}
+
+/**
+  * \fn void circuit_aes128(circuit * C)
+  * \brief This function builds the AES-128 encryption, key schedule included
+
+  * Its inputs are the key and the plaintext, its output the ciphertext, the bit j of the byte i being the wire
+  * 8 i + j of each value. The S-boxes are computed as inverses in GF(2^8) with 4 multiplications, the circuit has
+  * 200 S-boxes and 51200 AND gates, more than the 6400 of the tower field S-boxes of the reference Bristol file.
+
+  * \param[out] C     circuit freshly initialized
+*/
+void circuit_aes128(circuit * C) {
+  static const int rcon[10]={0x01,0x02,0x04,0x08,0x10,0x20,0x40,0x80,0x1b,0x36};
+  int sizes[2]={128,128}, size=128, s[16][8], k[16][8], t[16][8], col[4][8], x[4][8];
+  circuit_begin(C,2,sizes);
+  for (int i=0 ; i<16 ; i++) for (int j=0 ; j<8 ; j++) {
+    k[i][j]=8*i+j;
+    s[i][j]=128+8*i+j;
+  }
+
+  aes_add_round_key(C,s,k);
+  for (int round=0 ; round<10 ; round++) {
+    //SubBytes and ShiftRows, the byte i is the row i%4 of the column i/4
+    for (int i=0 ; i<16 ; i++) aes_sbox(C,t[i],s[(i%4)+4*((i/4+i%4)%4)]);
+    //MixColumns, except in the last round
+    for (int c=0 ; c<4 && round<9 ; c++) {
+      for (int i=0 ; i<4 ; i++) {
+        memcpy(col[i],t[4*c+i],8*sizeof(int));
+        aes_xtime(C,x[i],col[i]);
+      }
+      for (int i=0 ; i<4 ; i++) for (int j=0 ; j<8 ; j++) {
+        int v=circuit_xor(C,x[i][j],circuit_xor(C,x[(i+1)%4][j],col[(i+1)%4][j]));
+        t[4*c+i][j]=circuit_xor(C,v,circuit_xor(C,col[(i+2)%4][j],col[(i+3)%4][j]));
+      }
+    }
+    memcpy(s,t,sizeof(s));
+    aes_next_round_key(C,k,rcon[round]);
+    aes_add_round_key(C,s,k);
+  }
+  circuit_end(C,&s[0][0],1,&size);
+}
+
+/**
+  * \fn void circuit_eval_plain(const circuit * C, const uint8_t * in, uint8_t * out)
+  * \brief This function evaluates a circuit in the clear
+
+  * \param[out] out   uint8_t array representing the output bits, one per byte
+
+  * \param[in] C      circuit to evaluate
+  * \param[in] in     uint8_t array representing the input bits, one per byte
+*/
+void circuit_eval_plain(const circuit * C, const uint8_t * in, uint8_t * out) {
+  uint8_t * W=malloc(C->nb_wires);
+  memcpy(W,in,C->nb_input_wires);
+  for (int g=0 ; g<C->nb_gates ; g++) {
+    uint32_t a=C->in0[g], b=C->in1[g], o=C->out[g];
+    switch (C->type[g]) {
+      case CIRCUIT_XOR: W[o]=W[a]^W[b]; break;
+      case CIRCUIT_AND: W[o]=W[a]&W[b]; break;
+      case CIRCUIT_INV: W[o]=W[a]^1; break;
+      case CIRCUIT_EQW: W[o]=W[a]; break;
+      case CIRCUIT_EQ: W[o]=a; break;
+    }
+  }
+  memcpy(out,W+C->nb_wires-C->nb_output_wires,C->nb_output_wires);
+  free(W);
+}
+
+/**
+  * \fn void circuit_garble(const circuit * C, const block * in, block * out, uint8_t * ct_AND, block offset)
+  * \brief This function garbles a circuit, its k-th AND gate with the tweaks of the gate k
+
+  * The label of value 1 of a wire is its label of value 0 xored with offset. An INV gate xors the offset, a
+  * constant c gets the label 0 for its value, public, so the evaluator needs no input for it.
+
+  * \param[out] out     block array representing the labels of value 0 of the output wires
+  * \param[out] ct_AND  bytes array representing the AND gates ciphertexts, GATE_AND_BYTES per gate
+
+  * \param[in] C        circuit to garble
+  * \param[in] in       block array representing the labels of value 0 of the input wires
+  * \param[in] offset   block representing the offset used in freeXOR optimization
+*/
+void circuit_garble(const circuit * C, const block * in, block * out, uint8_t * ct_AND, block offset) {
+  block * W=malloc(C->nb_wires*sizeof(block)), A[2], B[2];
+  uint64_t k=0;
+  memcpy(W,in,C->nb_input_wires*sizeof(block));
+  for (int g=0 ; g<C->nb_gates ; g++) {
+    uint32_t a=C->in0[g], b=C->in1[g], o=C->out[g];
+    switch (C->type[g]) {
+      case CIRCUIT_XOR: gate_xor_eval(&W[o],W[a],W[b]); break;
+      case CIRCUIT_AND:
+        A[0]=W[a];
+        A[1]=block_xor(W[a],offset);
+        B[0]=W[b];
+        B[1]=block_xor(W[b],offset);
+        gate_and_garb(&W[o],ct_AND+k*GATE_AND_BYTES,A,B,offset,k);
+        k++;
+        break;
+      case CIRCUIT_INV: W[o]=block_xor(W[a],offset); break;
+      case CIRCUIT_EQW: W[o]=W[a]; break;
+      case CIRCUIT_EQ: W[o]=block_select(offset,a); break;
+    }
+  }
+  memcpy(out,W+C->nb_wires-C->nb_output_wires,C->nb_output_wires*sizeof(block));
+  free(W);
+}
+
+/**
+  * \fn void circuit_eval(const circuit * C, const block * in, block * out, const uint8_t * ct_AND)
+  * \brief This function evaluates a circuit garbled by circuit_garble
+
+  * \param[out] out     block array representing the labels of the output wires
+
+  * \param[in] C        circuit to evaluate
+  * \param[in] in       block array representing the labels of the input wires
+  * \param[in] ct_AND   bytes array representing the AND gates ciphertexts, GATE_AND_BYTES per gate
+*/
+void circuit_eval(const circuit * C, const block * in, block * out, const uint8_t * ct_AND) {
+  block * W=malloc(C->nb_wires*sizeof(block));
+  uint64_t k=0;
+  memcpy(W,in,C->nb_input_wires*sizeof(block));
+  for (int g=0 ; g<C->nb_gates ; g++) {
+    uint32_t a=C->in0[g], b=C->in1[g], o=C->out[g];
+    switch (C->type[g]) {
+      case CIRCUIT_XOR: gate_xor_eval(&W[o],W[a],W[b]); break;
+      case CIRCUIT_AND:
+        gate_and_eval(&W[o],W[a],W[b],ct_AND+k*GATE_AND_BYTES,k);
+        k++;
+        break;
+      case CIRCUIT_INV: case CIRCUIT_EQW: W[o]=W[a]; break;
+      case CIRCUIT_EQ: W[o]=block_zero(); break;
+    }
+  }
+  memcpy(out,W+C->nb_wires-C->nb_output_wires,C->nb_output_wires*sizeof(block));
+  free(W);
+}
@@ -0,0 +1,63 @@
+/**
+  * \file circuit.h
+  * \brief Boolean circuits in the Bristol Fashion format, their generic garbling and evaluation
+*/
+
+#ifndef CIRCUIT_H
+#define CIRCUIT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gate_functions.h"
+
+#define CIRCUIT_XOR 0 /**< gate computing in0 ^ in1, free */
+#define CIRCUIT_AND 1 /**< gate computing in0 & in1, GATE_AND_BYTES of ciphertexts */
+#define CIRCUIT_INV 2 /**< gate computing !in0, free */
+#define CIRCUIT_EQW 3 /**< gate copying the wire in0, free */
+#define CIRCUIT_EQ 4 /**< gate setting the public constant in0, 0 or 1, free */
+
+#define CIRCUIT_MAX_IO 64 /**< Largest number of inputs or outputs of a circuit */
+
+/**
+  * \typedef circuit
+  * \brief Structure of a circuit, its gates are stored in topological order as a struct of arrays
+
+  * As in the Bristol Fashion format, the input wires are the first wires, the inputs one after the other,
+  * and the output wires are the last ones. The bit j of an input or output value is its j-th wire.
+  */
+typedef struct circuit {
+  int nb_gates ; /**< Number of gates */
+  int nb_wires ; /**< Number of wires */
+  int nb_and ; /**< Number of AND gates, the only ones with ciphertexts */
+  int nb_inputs ; /**< Number of input values */
+  int input_sizes[CIRCUIT_MAX_IO] ; /**< Size in bits of each input value */
+  int nb_input_wires ; /**< Number of input wires, the sum of input_sizes */
+  int nb_outputs ; /**< Number of output values */
+  int output_sizes[CIRCUIT_MAX_IO] ; /**< Size in bits of each output value */
+  int nb_output_wires ; /**< Number of output wires, the sum of output_sizes */
+  uint8_t * type ; /**< Type of each gate, CIRCUIT_XOR, CIRCUIT_AND, ... */
+  uint32_t * in0 ; /**< First input wire of each gate, or the constant of a CIRCUIT_EQ gate */
+  uint32_t * in1 ; /**< Second input wire of each gate, 0 for the gates with one input */
+  uint32_t * out ; /**< Output wire of each gate */
+  int capacity ; /**< Number of gates the arrays can hold */
+} circuit ;
+
+circuit * circuit_init();
+void circuit_clear(circuit * C);
+int circuit_load(circuit * C, char * path);
+int circuit_save(const circuit * C, char * path);
+
+void circuit_cmp(circuit * C, int l, int ineq);
+void circuit_eq(circuit * C, int l);
+void circuit_add(circuit * C, int l);
+void circuit_max(circuit * C, int l);
+void circuit_aes128(circuit * C);
+
+void circuit_eval_plain(const circuit * C, const uint8_t * in, uint8_t * out);
+void circuit_garble(const circuit * C, const block * in, block * out, uint8_t * ct_AND, block offset);
+void circuit_eval(const circuit * C, const block * in, block * out, const uint8_t * ct_AND);
+
+#endif
@@ -38,25 +38,61 @@ void step1_clear(uint8_t * ct_Alice, uint8_t * sen_y, mpz_t Alice, mpz_t y) {
 }
 
 /**
-  * \fn void cmp_Alice_step1(Alice_struct * Alice, OT_sender * Alice_OT, uint8_t * Alice_input)
+  * \fn static void cmp_Alice_ot_setup(OT_sender * Alice_OT, mpz_t y)
+  * \brief This function sets up the base OTs of a comparison, reusing the values of Alice_OT->sen_session if any
+*/
+static void cmp_Alice_ot_setup(OT_sender * Alice_OT, mpz_t y) {
+
+  if (Alice_OT->sen_session==NULL) OT_sender_setup(Alice_OT->sen_enc_S,y,Alice_OT->sen_S,Alice_OT->sen_T);
+  else OT_sender_session_setup(Alice_OT->sen_session,Alice_OT->sen_enc_S,y,Alice_OT->sen_S,Alice_OT->sen_T);
+}
+
+/**
+  * \fn void cmp_Alice_step1(Alice_struct * Alice, OT_sender * Alice_OT, uint8_t * Alice_input, paillier_ctx * ctx)
   * \brief This function gathers subfunctions used by Alice in the first step
 
   * \param[out] Alice       Alice_struct stocking Alice's Values
   * \param[out] Alice_OT s  OT_sender stocking Alice's values for the oblivious transfer
 
   * \param[in] Alice_input  bytes array representing Alice's input
+  * \param[in] ctx          paillier_ctx representing Alice's Paillier key
 */
-void cmp_Alice_step1(Alice_struct * Alice, OT_sender * Alice_OT, uint8_t * Alice_input) {
+void cmp_Alice_step1(Alice_struct * Alice, OT_sender * Alice_OT, uint8_t * Alice_input, paillier_ctx * ctx) {
 
   mpz_t mpz_Alice, mpz_y;
   step1_init(mpz_Alice, mpz_y, Alice_input);
 
-  paillier_encrypt(mpz_Alice,mpz_Alice);
-  OT_sender_setup(Alice_OT->sen_enc_S, mpz_y,Alice_OT->sen_S,Alice_OT->sen_T);
+  paillier_encrypt(mpz_Alice,mpz_Alice,ctx);
+  if (Alice_OT->sen_ext==NULL) cmp_Alice_ot_setup(Alice_OT, mpz_y);
 
   step1_clear(Alice->ct_Alice,Alice_OT->sen_y,mpz_Alice,mpz_y);
 }
 
+/**
+  * \fn void cmp_Alice_step1_ct(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t ct_input, paillier_ctx * ctx)
+  * \brief This function gathers subfunctions used by Alice in the first step when her input is already encrypted
+
+  * The ciphertext, for instance the output of paillier_enc_dot, is rerandomized and takes the place of the
+  * encryption of Alice's input. Its plaintext must lie in [0, 2^PARAM_L).
+
+  * \param[out] Alice       Alice_struct stocking Alice's Values
+  * \param[out] Alice_OT    OT_sender stocking Alice's values for the oblivious transfer
+
+  * \param[in] ct_input     mpz_t representing the ciphertext of Alice's input under her key
+  * \param[in] ctx          paillier_ctx representing Alice's Paillier key
+*/
+void cmp_Alice_step1_ct(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t ct_input, paillier_ctx * ctx) {
+
+  mpz_t mpz_ct_Alice, mpz_y;
+  mpz_inits(mpz_ct_Alice, mpz_y, NULL);
+
+  paillier_rerandomize(mpz_ct_Alice,ct_input,ctx);
+  if (Alice_OT->sen_ext==NULL) cmp_Alice_ot_setup(Alice_OT, mpz_y);
+
+  memset(Alice->ct_Alice, 0, PAILLIER_MAX_KEY_SIZE/4);
+  step1_clear(Alice->ct_Alice,Alice_OT->sen_y,mpz_ct_Alice,mpz_y);
+}
+
 /**
   * \fn void step2_init(mpz_t * x, mpz_t mpz_Bob, mpz_t ct_Alice, mpz_t rho, mpz_t ct_gamma, Bob_struct * Bob, uint8_t * Bob_input)
   * \brief This function imports mpz_t values from bytes arrays and allocates memory
@@ -76,7 +112,7 @@ void step2_init(mpz_t * x, mpz_t mpz_Bob, mpz_t ct_Alice, mpz_t rho, mpz_t ct_ga
   for (int i = 0; i < PARAM_L+1; ++i) mpz_init(x[i]);
 
   mpz_import(mpz_Bob,1,-1,bits_to_bytes(PARAM_L),0,0,Bob_input);
-  mpz_import(ct_Alice,1,-1,PAILLIER_KEY_SIZE/4,0,0,Bob->ct_Alice);
+  mpz_import(ct_Alice,1,-1,PAILLIER_MAX_KEY_SIZE/4,0,0,Bob->ct_Alice);
 
   gmp_printf("%Zu ) = ",mpz_Bob);
 }
@@ -106,248 +142,507 @@ void step2_clear(Bob_struct * Bob, OT_receiver * Bob_OT, mpz_t * x, mpz_t mpz_Bo
 }
 
 /**
-  * \fn void cmp_Bob_step2(Bob_struct * Bob, OT_receiver * Bob_OT, uint8_t * Bob_input)
+  * \fn static int cmp_Bob_ot_choose(OT_receiver * Bob_OT, mpz_t * x, mpz_t rho)
+  * \brief This function chooses the base OTs of a comparison, S being decoded once per Bob_OT->rec_session if any
+*/
+static int cmp_Bob_ot_choose(OT_receiver * Bob_OT, mpz_t * x, mpz_t rho) {
+
+  if (Bob_OT->rec_session==NULL) return OT_receiver_choose(Bob_OT->rec_enc_R,x,Bob_OT->rec_R,Bob_OT->rec_enc_S,rho);
+  if (OT_receiver_session_update(Bob_OT->rec_session,Bob_OT->rec_enc_S)) return 1;
+  return OT_receiver_choose_point(Bob_OT->rec_enc_R,x,Bob_OT->rec_R,Bob_OT->rec_session->S,rho);
+}
+
+/**
+  * \fn int cmp_Bob_step2(Bob_struct * Bob, OT_receiver * Bob_OT, uint8_t * Bob_input, paillier_ctx * ctx)
   * \brief This function gathers subfunctions used by Bob in the second step
 
   * \param[out] Bob       Bob_struct stocking Bob's Values
   * \param[out] Bob_OT    OT_receiver stocking Bob's values for the oblivious transfer
 
   * \param[in] Bob_input Bob's input
+  * \param[in] ctx       paillier_ctx representing Alice's public key
+
+  * \return 0 if the computation succeed
+  * \return 1 if the OTs can not be chosen, Alice's point S being invalid or the extension session used up
 */
-void cmp_Bob_step2(Bob_struct * Bob, OT_receiver * Bob_OT, uint8_t * Bob_input) {
+int cmp_Bob_step2(Bob_struct * Bob, OT_receiver * Bob_OT, uint8_t * Bob_input, paillier_ctx * ctx) {
 
   mpz_t * x=calloc(PARAM_L+1,sizeof(mpz_t));
   mpz_t mpz_Bob , mpz_ct_Alice , mpz_rho , mpz_ct_gamma;
+  int error;
 
   step2_init(x, mpz_Bob, mpz_ct_Alice, mpz_rho, mpz_ct_gamma, Bob, Bob_input);
 
-  cmp_Bob_gen_inputs(mpz_ct_gamma,mpz_rho,mpz_ct_Alice, mpz_Bob);
-  OT_receiver_choose(Bob_OT->rec_enc_R,x,Bob_OT->rec_R,Bob_OT->rec_enc_S,mpz_rho);
+  cmp_Bob_gen_inputs(mpz_ct_gamma,mpz_rho,mpz_ct_Alice, mpz_Bob, ctx);
+  if (Bob_OT->rec_ext==NULL) error=cmp_Bob_ot_choose(Bob_OT, x, mpz_rho);
+  else error=cmp_Bob_ext_choose(&Bob_OT, &mpz_rho, 1);
 
   step2_clear(Bob, Bob_OT, x, mpz_Bob, mpz_ct_Alice, mpz_rho, mpz_ct_gamma);
+  return error;
 }
 
 /**
-  * \fn void step3_init(mpz_t gamma, mpz_t ct_gamma, mpz_t y, mpz_t ** keys, mpz_t ** kA, mpz_t ** kB, mpz_t ** ct_AND, mpz_t * input_keys, mpz_t * trans_table, Alice_struct * Alice, OT_sender * Alice_OT)
+  * \fn void step3_init(mpz_t y, mpz_t ** keys, mpz_t ** kB, OT_sender * Alice_OT)
   * \brief This function imports mpz_t values from bytes arrays and allocates memory
 
-  * \param[out] gamma       mpz_t representing Alice's new input
-  * \param[out] ct_gamma    mpz_t representing Alice's new input ciphertext
   * \param[out] y           mpz_t representing the random value generated by Alice
   * \param[out] keys        mpz_t double array representing the keys generated during the oblivious transfers
-  * \param[out] kA          mpz_t double array representing Alice's input keys
-  * \param[out] kB          mpz_t double array representing Bob's input keys
-  * \param[out] ct_AND      mpz_t double array representing the ciphertexts for the AND gates
-  * \param[out] input_keys  mpz_t array representing the Alice's input keys sent to Bob
-  * \param[out] trans_table mpz_t array representing the translation table
-
-  * \param[in] Alice       Alice_struct stocking Alice's Values
-  * \param[in] Alice_OT s  OT_sender stocking Alice's values for the oblivious transfer
+  * \param[out] kB          mpz_t double array representing Bob's input keys transferred by the oblivious transfers
+
+  * \param[in] Alice_OT     OT_sender stocking Alice's values for the oblivious transfer
 */
-void step3_init(mpz_t gamma, mpz_t ct_gamma, mpz_t y, mpz_t ** keys, mpz_t ** kA, mpz_t ** kB, mpz_t ** ct_AND, mpz_t * input_keys, mpz_t * trans_table, Alice_struct * Alice, OT_sender * Alice_OT) {
-  mpz_inits(gamma, ct_gamma, y,NULL);
-  mpz_import(ct_gamma,1,-1,PAILLIER_KEY_SIZE/4,0,0,Alice->ct_gamma);
+void step3_init(mpz_t y, mpz_t ** keys, mpz_t ** kB, OT_sender * Alice_OT) {
+  mpz_init(y);
   mpz_import(y,1,-1,bits_to_bytes(255),0,0,Alice_OT->sen_y);
 
-  for (int i=0;i<PARAM_L;i++) {
+  for (int i=0;i<PARAM_L+1;i++) {
     keys[i]=calloc(2,sizeof(mpz_t));
-    kA[i]=calloc(2,sizeof(mpz_t));
     kB[i]=calloc(2,sizeof(mpz_t));
-    ct_AND[i]=calloc(2,sizeof(mpz_t));
-    mpz_inits(keys[i][0],keys[i][1],kA[i][0],kA[i][1],kB[i][0],kB[i][1],ct_AND[i][0],ct_AND[i][1],input_keys[i],NULL);
+    mpz_inits(keys[i][0],keys[i][1],kB[i][0],kB[i][1],NULL);
   }
-
-  keys[PARAM_L]=calloc(2,sizeof(mpz_t));
-  kA[PARAM_L]=calloc(2,sizeof(mpz_t));
-  kB[PARAM_L]=calloc(2,sizeof(mpz_t));
-  mpz_inits(kA[PARAM_L][0],kA[PARAM_L][1],kB[PARAM_L][0],kB[PARAM_L][1],input_keys[PARAM_L],keys[PARAM_L][0],keys[PARAM_L][1],NULL);
-  mpz_inits(trans_table[0],trans_table[1],NULL);
 }
 
 /**
-  * \fn void step3_clear(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t gamma, mpz_t ct_gamma, mpz_t y, mpz_t ** keys, mpz_t ** kA, mpz_t ** kB, mpz_t ** ct_AND, mpz_t * input_keys, mpz_t * trans_table)
-  * \brief This function exports mpz_t values to bytes arrays and allocates memory
+  * \fn void step3_clear(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t y, mpz_t ** keys, mpz_t ** kB, block * trans_table)
+  * \brief This function exports the garbled circuit and the OT keys to bytes arrays and releases memory
 
   * \param[out] Alice       Alice_struct stocking Alice's Values
   * \param[out] Alice_OT s  OT_sender stocking Alice's values for the oblivious transfer
 
-  * \param[in] gamma       mpz_t representing Alice's new input
-  * \param[in] ct_gamma    mpz_t representing Alice's new input ciphertext
   * \param[in] y           mpz_t representing the random value generated by Alice
   * \param[in] keys        mpz_t double array representing the keys generated during the oblivious transfers
-  * \param[in] kA          mpz_t double array representing Alice's input keys
-  * \param[in] kB          mpz_t double array representing Bob's input keys
-  * \param[in] ct_AND      mpz_t double array representing the ciphertexts for the AND gates
-  * \param[in] input_keys  mpz_t array representing the Alice's input keys sent to Bob
-  * \param[in] trans_table mpz_t array representing the translation table
-
+  * \param[in] kB          mpz_t double array representing Bob's input keys transferred by the oblivious transfers
+  * \param[in] trans_table block array representing the translation table
 */
-void step3_clear(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t gamma, mpz_t ct_gamma, mpz_t y, mpz_t ** keys, mpz_t ** kA, mpz_t ** kB, mpz_t ** ct_AND, mpz_t * input_keys, mpz_t * trans_table) {
+void step3_clear(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t y, mpz_t ** keys, mpz_t ** kB, block * trans_table) {
 
-  for (int i=0 ; i<2*PARAM_L ; i++) mpz_export(Alice->ct_AND[i/2][i%2],NULL,-1,1,0,0,ct_AND[i/2][i%2]);
-
-  mpz_export(Alice->trans_table[0],NULL,-1,1,0,0,trans_table[0]);
-  mpz_export(Alice->trans_table[1],NULL,-1,1,0,0,trans_table[1]);
-  for (int i=0 ; i<PARAM_L+1; i++) for(int j=0;j<2;j++) mpz_export(Alice_OT->sen_keys[i][j],NULL,-1,1,0,0,keys[i][j]);
+  for (int i=0 ; i<2 ; i++) block_store(Alice->trans_table+i*BLOCK_BYTES,trans_table[i]);
+  for (int i=0 ; i<PARAM_L+1; i++) for(int j=0;j<2;j++) {
+    memset(Alice_OT->sen_keys[i][j],0,bits_to_bytes(KEY_SIZE));
+    mpz_export(Alice_OT->sen_keys[i][j],NULL,-1,1,0,0,keys[i][j]);
+  }
 
-  mpz_clears(trans_table[0],trans_table[1],NULL);
-  mpz_clears(gamma, ct_gamma, y,NULL);
-  for (int i=0 ; i<PARAM_L ; i++) {
-    mpz_clears(keys[i][0],keys[i][1],kA[i][0],kA[i][1],kB[i][0],kB[i][1],ct_AND[i][0],ct_AND[i][1],input_keys[i],NULL);
-    free(kA[i]);
+  mpz_clear(y);
+  for (int i=0 ; i<PARAM_L+1 ; i++) {
+    mpz_clears(keys[i][0],keys[i][1],kB[i][0],kB[i][1],NULL);
     free(kB[i]);
     free(keys[i]);
-    free(ct_AND[i]);
   }
-  mpz_clears(kA[PARAM_L][0],kA[PARAM_L][1],kB[PARAM_L][0],kB[PARAM_L][1],input_keys[PARAM_L],keys[PARAM_L][0],keys[PARAM_L][1],NULL);
-  free(keys[PARAM_L]);
-  free(kA[PARAM_L]);
-  free(kB[PARAM_L]);
   free(keys);
-  free(kA);
   free(kB);
-  free(ct_AND);
-  free(input_keys);
-  free(trans_table);
 }
 
 /**
-  * \fn int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT)
+  * \fn int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT, paillier_ctx * ctx)
   * \brief This function gathers subfunctions used by Alice in the third step
 
   * \param[out] Alice variable stocking Alice's Values
   * \param[out] Alice_OT s variable stocking ALice's values for the oblivious transfer
+
+  * \param[in] ctx paillier_ctx representing Alice's Paillier key
+
+  * \return 0 if the computation succeed
+  * \return 1 if the extension session can not expand the OTs of the comparison or the OT keys can not be derived, nothing is garbled then
 */
-int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT) {
+int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT, paillier_ctx * ctx) {
 
-  mpz_t mpz_gamma, mpz_ct_gamma, mpz_y;
+  mpz_t mpz_gamma, mpz_ct_gamma;
+  int error=0;
+  mpz_inits(mpz_gamma, mpz_ct_gamma, NULL);
+  mpz_import(mpz_ct_gamma,1,-1,PAILLIER_MAX_KEY_SIZE/4,0,0,Alice->ct_gamma);
+
+  paillier_decrypt(mpz_gamma, mpz_ct_gamma, ctx);
+  if (Alice_OT->sen_ext!=NULL) error=cmp_Alice_ext_expand(&Alice_OT, 1);
+  if (!error) error=cmp_Alice_step3_garbling(Alice, Alice_OT, mpz_gamma);
+
+  mpz_clears(mpz_gamma, mpz_ct_gamma, NULL);
+  return error ;
+}
+
+/**
+  * \fn static int cmp_Alice_ot_keys(OT_sender * Alice_OT, mpz_t ** K, mpz_t ** kB, mpz_t y, mpz_t offset)
+  * \brief This function runs the sender's side of the PARAM_L+1 OTs of a comparison with the OTs set in Alice_OT
+
+  * With PARAM_OT_CORRELATED and an extension the keys kB are set by the OTs from offset, otherwise they are inputs of the OTs.
+*/
+static int cmp_Alice_ot_keys(OT_sender * Alice_OT, mpz_t ** K, mpz_t ** kB, mpz_t y, mpz_t offset) {
+
+  OT_ext_sender * ext = Alice_OT->sen_ext;
+  int index = Alice_OT->sen_ext_index;
+
+  if (ext==NULL) return OT_sender_key_derivation(K,kB,Alice_OT->sen_enc_R,Alice_OT->sen_T,y);
+
+  if (ext->nb_random>0 && PARAM_OT_CORRELATED) OT_ext_sender_derandomize_correlated(ext, K, kB, offset, Alice_OT->sen_corrections, index, PARAM_L+1);
+  else if (ext->nb_random>0) OT_ext_sender_derandomize(ext, K, kB, Alice_OT->sen_corrections, index, PARAM_L+1);
+  else if (PARAM_OT_CORRELATED) OT_ext_sender_correlated(ext, K, kB, offset, index, PARAM_L+1);
+  else OT_ext_sender_transfer(ext, K, kB, index, PARAM_L+1);
+  return 0;
+}
+
+/**
+  * \fn int cmp_Alice_step3_garbling(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t gamma)
+  * \brief This function gathers the subfunctions used by Alice in the third step once her new input is decrypted
+
+  * \param[out] Alice     Alice_struct stocking Alice's Values
+  * \param[out] Alice_OT  OT_sender stocking Alice's values for the oblivious transfer
+
+  * \param[in] gamma      mpz_t representing Alice's new input
+
+  * \return 0 if the computation succeed
+  * \return 1 if the OT keys can not be derived, nothing is garbled then and the buffers sent to Bob are cleared
+*/
+int cmp_Alice_step3_garbling(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t gamma) {
+
+  mpz_t mpz_y, mpz_offset;
   mpz_t ** mpz_keys=calloc(PARAM_L+1,sizeof(mpz_t*));
-  mpz_t ** kA=calloc(PARAM_L+1,sizeof(mpz_t *));
-  mpz_t ** kB=calloc(PARAM_L+1,sizeof(mpz_t *));
-  mpz_t ** mpz_ct_AND=calloc(PARAM_L,sizeof(mpz_t*));
-  mpz_t * mpz_input_keys=calloc(PARAM_L+1,sizeof(mpz_t));
-  mpz_t * mpz_trans_table=calloc(2,sizeof(mpz_t));
+  mpz_t ** mpz_kB=calloc(PARAM_L+1,sizeof(mpz_t *));
+  block kA[PARAM_L+1], kB[PARAM_L+1], trans_table[2], offset;
+  int correlated = PARAM_OT_CORRELATED && Alice_OT->sen_ext!=NULL;
+  int error;
+
+  step3_init(mpz_y, mpz_keys, mpz_kB, Alice_OT);
+
+  // The OTs run before the garbling, correlated OTs of an extension set Bob's keys with the offset of the circuit
+  mpz_init(mpz_offset);
+  gen_offset(&offset);
+  mpz_set_block(mpz_offset,offset);
+  gen_labels(kA,PARAM_L+1);
+  if (!correlated) {
+    gen_labels(kB,PARAM_L+1);
+    for (int i=0 ; i<PARAM_L+1 ; i++) {
+      mpz_set_block(mpz_kB[i][0],kB[i]);
+      mpz_set_block(mpz_kB[i][1],block_xor(kB[i],offset));
+    }
+  }
+  error=cmp_Alice_ot_keys(Alice_OT, mpz_keys, mpz_kB, mpz_y, mpz_offset);
+  mpz_clear(mpz_offset);
+
+  if (error) {
+    memset(trans_table,0,sizeof(trans_table));
+    memset(Alice->ct_AND,0,PARAM_L*GATE_AND_BYTES);
+    memset(Alice->Alice_keys,0,(PARAM_L+1)*BLOCK_BYTES);
+    for (int i=0 ; i<PARAM_L+1 ; i++) for (int b=0 ; b<2 ; b++) mpz_set_ui(mpz_keys[i][b],0);
+  }
+  else {
+    if (correlated) for (int i=0 ; i<PARAM_L+1 ; i++) kB[i]=mpz_get_block(mpz_kB[i][0]);
+    cmp_Alice_garbling_offset(kA,kB,trans_table,Alice->ct_AND,offset);
+    cmp_Alice_set_keys(Alice->Alice_keys, kA, offset, gamma);
+  }
+
+  step3_clear(Alice, Alice_OT, mpz_y, mpz_keys, mpz_kB, trans_table);
+
+  return error ;
+}
+
+/**
+  * \fn int cmp_Bob_ext_choose(OT_receiver ** Bob_OT, mpz_t * rho, int nb)
+  * \brief This function runs the receiver's side of one OT extension for the PARAM_L+1 OTs of nb comparisons
+
+  * The comparisons share the extension session of Bob_OT[0], the OTs of the comparison i start at index i*(PARAM_L+1).
+  * If the session holds precomputed random OTs, they are consumed instead and each Bob_OT[i]->rec_corrections is
+  * sent to Alice in place of the matrix U.
+
+  * \param[out] Bob_OT  OT_receiver array whose extension session holds the matrix U sent to Alice
+  * \param[in] rho      mpz_t array representing Bob's new inputs, the choice bits
+  * \param[in] nb       int representing the number of comparisons
+
+  * \return 0 if the computation succeed
+  * \return 1 if the session cannot extend nb*(PARAM_L+1) OTs at once, or has not enough random OTs left
+*/
+int cmp_Bob_ext_choose(OT_receiver ** Bob_OT, mpz_t * rho, int nb) {
 
+  int nb_ot = nb*(PARAM_L+1), result;
 
-  step3_init(mpz_gamma, mpz_ct_gamma, mpz_y, mpz_keys, kA, kB, mpz_ct_AND, mpz_input_keys, mpz_trans_table, Alice, Alice_OT);
+  if (Bob_OT[0]->rec_ext->nb_random>0) {
+    for (int i=0 ; i<nb ; i++) {
+      Bob_OT[i]->rec_ext_index = OT_ext_receiver_correct(Bob_OT[0]->rec_ext, Bob_OT[i]->rec_corrections, rho[i], PARAM_L+1);
+      if (Bob_OT[i]->rec_ext_index<0) return 1;
+    }
+    return 0;
+  }
+  uint8_t * choices = calloc(bits_to_bytes(nb_ot), sizeof(uint8_t));
+
+  for (int i=0 ; i<nb ; i++) {
+    Bob_OT[i]->rec_ext_index = i*(PARAM_L+1);
+    for (int j=0 ; j<PARAM_L+1 ; j++) {
+      int k = i*(PARAM_L+1)+j;
+      choices[k/8] |= mpz_tstbit(rho[i],j) << (k%8);
+    }
+  }
+  result = OT_ext_receiver_choose(Bob_OT[0]->rec_ext, choices, nb_ot);
+
+  free(choices);
+  return result;
+}
 
-  paillier_decrypt(mpz_gamma, mpz_ct_gamma);
-  cmp_Alice_garbling(kA,kB,mpz_trans_table,mpz_ct_AND);
-  OT_sender_key_derivation(mpz_keys,kB,Alice_OT->sen_enc_R,Alice_OT->sen_T,mpz_y);
-  cmp_Alice_set_keys(Alice->Alice_keys, kA, mpz_gamma);
+/**
+  * \fn int cmp_Alice_ext_expand(OT_sender ** Alice_OT, int nb)
+  * \brief This function runs the sender's side of one OT extension for the PARAM_L+1 OTs of nb comparisons, or consumes precomputed random OTs
 
-  step3_clear(Alice, Alice_OT, mpz_gamma, mpz_ct_gamma, mpz_y, mpz_keys, kA, kB, mpz_ct_AND, mpz_input_keys, mpz_trans_table);
+  * \param[out] Alice_OT  OT_sender array whose extension session has received the matrix U from Bob
+  * \param[in] nb         int representing the number of comparisons
 
-  return 0 ;
+  * \return 0 if the computation succeed
+  * \return 1 if the session cannot extend nb*(PARAM_L+1) OTs at once, or has not enough random OTs left
+*/
+int cmp_Alice_ext_expand(OT_sender ** Alice_OT, int nb) {
+
+  if (Alice_OT[0]->sen_ext->nb_random>0) {
+    for (int i=0 ; i<nb ; i++) {
+      Alice_OT[i]->sen_ext_index = OT_ext_sender_reserve(Alice_OT[0]->sen_ext, PARAM_L+1);
+      if (Alice_OT[i]->sen_ext_index<0) return 1;
+    }
+    return 0;
+  }
+  for (int i=0 ; i<nb ; i++) Alice_OT[i]->sen_ext_index = i*(PARAM_L+1);
+  return OT_ext_sender_expand(Alice_OT[0]->sen_ext, nb*(PARAM_L+1));
 }
 
 /**
-  * \fn void step4_init(mpz_t rho, mpz_t * x, mpz_t * trans_table, mpz_t ** ct_AND, mpz_t * Bob_keys, mpz_t * Alice_keys, mpz_t ** keys, Bob_struct * Bob, OT_receiver * Bob_OT)
-  * \brief This function imports mpz_t values from bytes arrays and allocates memory
+  * \fn int cmp_Alice_batch_step1(OT_sender ** Alice_OT, uint8_t ** Alice_inputs, int nb, uint8_t * ct_packed, paillier_ctx * ctx)
+  * \brief This function gathers subfunctions used by Alice in the first step of nb comparisons sharing one Paillier ciphertext
+
+  * \param[out] Alice_OT      OT_sender array stocking Alice's values for each oblivious transfer
+  * \param[out] ct_packed     bytes array representing the ciphertext of Alice's packed inputs
+
+  * \param[in] Alice_inputs   bytes double array representing Alice's inputs
+  * \param[in] nb             int representing the number of comparisons, at most PARAM_SLOTS
+  * \param[in] ctx            paillier_ctx representing Alice's Paillier key
+
+  * \return 0 if the computation succeed
+  * \return 1 if nb is larger than PARAM_SLOTS
+*/
+int cmp_Alice_batch_step1(OT_sender ** Alice_OT, uint8_t ** Alice_inputs, int nb, uint8_t * ct_packed, paillier_ctx * ctx) {
+
+  if (nb>PARAM_SLOTS) return 1;
+
+  mpz_t packed, y;
+  mpz_t * inputs=calloc(nb,sizeof(mpz_t));
+  mpz_inits(packed, y, NULL);
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_init(inputs[i]);
+    mpz_import(inputs[i],1,-1,bits_to_bytes(PARAM_L),0,0,Alice_inputs[i]);
+    if (Alice_OT[i]->sen_ext!=NULL) continue;
+    cmp_Alice_ot_setup(Alice_OT[i], y);
+    mpz_export(Alice_OT[i]->sen_y,NULL,-1,1,0,0,y);
+  }
+
+  cmp_pack(packed, inputs, nb);
+  paillier_encrypt(packed, packed, ctx);
+  memset(ct_packed, 0, PAILLIER_MAX_KEY_SIZE/4);
+  mpz_export(ct_packed,NULL,-1,1,0,0,packed);
+
+  for (int i=0 ; i<nb ; i++) mpz_clear(inputs[i]);
+  mpz_clears(packed, y, NULL);
+  free(inputs);
+  return 0;
+}
+
+/**
+  * \fn int cmp_Bob_batch_step2(Bob_struct ** Bob, OT_receiver ** Bob_OT, uint8_t ** Bob_inputs, int nb, uint8_t * ct_Alice_packed, uint8_t * ct_gamma_packed, paillier_ctx * ctx)
+  * \brief This function gathers subfunctions used by Bob in the second step of nb comparisons sharing one Paillier ciphertext
+
+  * \param[out] Bob              Bob_struct array stocking Bob's values for each comparison
+  * \param[out] Bob_OT           OT_receiver array stocking Bob's values for each oblivious transfer
+  * \param[out] ct_gamma_packed  bytes array representing the ciphertext of Alice's packed new inputs
+
+  * \param[in] Bob_inputs        bytes double array representing Bob's inputs
+  * \param[in] nb                int representing the number of comparisons, at most PARAM_SLOTS
+  * \param[in] ct_Alice_packed   bytes array representing the ciphertext of Alice's packed inputs
+  * \param[in] ctx               paillier_ctx representing Alice's public key
+
+  * \return 0 if the computation succeed
+  * \return 1 if nb is larger than PARAM_SLOTS
+  * \return 2 if the OTs can not be chosen, Alice's point S being invalid or the extension session used up
+*/
+int cmp_Bob_batch_step2(Bob_struct ** Bob, OT_receiver ** Bob_OT, uint8_t ** Bob_inputs, int nb, uint8_t * ct_Alice_packed, uint8_t * ct_gamma_packed, paillier_ctx * ctx) {
+
+  if (nb>PARAM_SLOTS) return 1;
+
+  mpz_t ct_Alice, ct_gamma;
+  mpz_t * inputs=calloc(nb,sizeof(mpz_t));
+  mpz_t * rho=calloc(nb,sizeof(mpz_t));
+  mpz_t * x=calloc(PARAM_L+1,sizeof(mpz_t));
+  int error=0;
+  mpz_inits(ct_Alice, ct_gamma, NULL);
+  for (int j=0 ; j<PARAM_L+1 ; j++) mpz_init(x[j]);
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_inits(inputs[i], rho[i], NULL);
+    mpz_import(inputs[i],1,-1,bits_to_bytes(PARAM_L),0,0,Bob_inputs[i]);
+  }
+  mpz_import(ct_Alice,1,-1,PAILLIER_MAX_KEY_SIZE/4,0,0,ct_Alice_packed);
+
+  cmp_Bob_gen_packed_inputs(ct_gamma, rho, ct_Alice, inputs, nb, ctx);
+  if (Bob_OT[0]->rec_ext!=NULL) error|=cmp_Bob_ext_choose(Bob_OT, rho, nb);
+  for (int i=0 ; i<nb ; i++) {
+    memset(Bob[i]->rho, 0, bits_to_bytes(PARAM_L+PARAM_K));
+    mpz_export(Bob[i]->rho,NULL,-1,1,0,0,rho[i]);
+    if (Bob_OT[i]->rec_ext!=NULL) continue;
+    error|=cmp_Bob_ot_choose(Bob_OT[i], x, rho[i]);
+    for (int j=0 ; j<PARAM_L+1 ; j++) mpz_export(Bob_OT[i]->rec_x[j],NULL,-1,1,0,0,x[j]);
+  }
+
+  memset(ct_gamma_packed, 0, PAILLIER_MAX_KEY_SIZE/4);
+  mpz_export(ct_gamma_packed,NULL,-1,1,0,0,ct_gamma);
+
+  for (int i=0 ; i<nb ; i++) mpz_clears(inputs[i], rho[i], NULL);
+  for (int j=0 ; j<PARAM_L+1 ; j++) mpz_clear(x[j]);
+  mpz_clears(ct_Alice, ct_gamma, NULL);
+  free(inputs);
+  free(rho);
+  free(x);
+  return error ? 2 : 0;
+}
+
+/**
+  * \fn int cmp_Alice_batch_step3(Alice_struct ** Alice, OT_sender ** Alice_OT, int nb, uint8_t * ct_gamma_packed, paillier_ctx * ctx)
+  * \brief This function gathers subfunctions used by Alice in the third step of nb comparisons sharing one Paillier ciphertext
 
+  * \param[out] Alice            Alice_struct array stocking Alice's values for each comparison
+  * \param[out] Alice_OT         OT_sender array stocking Alice's values for each oblivious transfer
+
+  * \param[in] nb                int representing the number of comparisons, at most PARAM_SLOTS
+  * \param[in] ct_gamma_packed   bytes array representing the ciphertext of Alice's packed new inputs
+  * \param[in] ctx               paillier_ctx representing Alice's Paillier key
+
+  * \return 0 if the computation succeed
+  * \return 1 if nb is larger than PARAM_SLOTS
+  * \return 2 if the extension session can not expand the OTs of the comparisons or the OT keys of one of them can not be derived
+*/
+int cmp_Alice_batch_step3(Alice_struct ** Alice, OT_sender ** Alice_OT, int nb, uint8_t * ct_gamma_packed, paillier_ctx * ctx) {
+
+  if (nb>PARAM_SLOTS) return 1;
+
+  mpz_t packed;
+  mpz_t * gamma=calloc(nb,sizeof(mpz_t));
+  int error=0;
+  mpz_init(packed);
+  for (int i=0 ; i<nb ; i++) mpz_init(gamma[i]);
+
+  mpz_import(packed,1,-1,PAILLIER_MAX_KEY_SIZE/4,0,0,ct_gamma_packed);
+  paillier_decrypt(packed, packed, ctx);
+  cmp_unpack(gamma, packed, nb);
+  if (Alice_OT[0]->sen_ext!=NULL) error=cmp_Alice_ext_expand(Alice_OT, nb);
+  for (int i=0 ; i<nb && !error ; i++) error=cmp_Alice_step3_garbling(Alice[i], Alice_OT[i], gamma[i]);
+
+  for (int i=0 ; i<nb ; i++) mpz_clear(gamma[i]);
+  mpz_clear(packed);
+  free(gamma);
+  return error ? 2 : 0;
+}
+
+/**
+  * \fn void step4_init(mpz_t rho, mpz_t * x, mpz_t ** keys, mpz_t * Bob_keys, block * Alice_keys, block * trans_table, Bob_struct * Bob, OT_receiver * Bob_OT)
+  * \brief This function imports mpz_t values and labels from bytes arrays and allocates memory
 
   * \param[out] rho         mpz_t representing the random new input generated by Bob
   * \param[out] x           mpz_t array representing the random values generated by Bob
-  * \param[out] trans_table mpz_t array representing the translation table
-  * \param[out] ct_AND      mpz_t double array representing the ciphertexts for the AND gates
-  * \param[out] Bob_keys    mpz_t array representing the Bob's input keys
-  * \param[out] Alice_keys  mpz_t array representing the Alice's input keys
   * \param[out] keys        mpz_t double array representing the keys generated during the oblivious transfers
+  * \param[out] Bob_keys    mpz_t array representing the Bob's input keys retrieved by the oblivious transfers
+  * \param[out] Alice_keys  block array representing the Alice's input keys
+  * \param[out] trans_table block array representing the translation table
 
   * \param[in] Bob          Bob_struct stocking Bob's values
   * \param[in] Bob_OT       OT_receiver stocking Bob's values for the oblivious transfers
 */
-void step4_init(mpz_t rho, mpz_t * x, mpz_t * trans_table, mpz_t ** ct_AND, mpz_t * Bob_keys, mpz_t * Alice_keys, mpz_t ** keys, Bob_struct * Bob, OT_receiver * Bob_OT) {
-  mpz_inits(rho,trans_table[0],trans_table[1],NULL);
+void step4_init(mpz_t rho, mpz_t * x, mpz_t ** keys, mpz_t * Bob_keys, block * Alice_keys, block * trans_table, Bob_struct * Bob, OT_receiver * Bob_OT) {
+  mpz_init(rho);
 
   for (int i=0 ; i<PARAM_L+1 ; i++) {
-
   	keys[i]=calloc(2,sizeof(mpz_t));
-    mpz_inits(Alice_keys[i],Bob_keys[i],x[i],keys[i][0],keys[i][1],NULL);
-    mpz_import(Alice_keys[i],1,-1,bits_to_bytes(KEY_SIZE),0,0,Bob->Alice_keys[i]);
+    mpz_inits(Bob_keys[i],x[i],keys[i][0],keys[i][1],NULL);
     mpz_import(x[i],1,-1,32,0,0,Bob_OT->rec_x[i]);
   	mpz_import(keys[i][0],1,-1,bits_to_bytes(KEY_SIZE),0,0,Bob_OT->rec_keys[i][0]);
   	mpz_import(keys[i][1],1,-1,bits_to_bytes(KEY_SIZE),0,0,Bob_OT->rec_keys[i][1]);
-  	mpz_import(trans_table[0],1,-1,bits_to_bytes(KEY_SIZE),0,0,Bob->trans_table[0]);
-  	mpz_import(trans_table[1],1,-1,bits_to_bytes(KEY_SIZE),0,0,Bob->trans_table[1]);
-
-  	if (i<PARAM_L) {
-  		ct_AND[i]=calloc(2,sizeof(mpz_t));
-  		for (int j=0 ; j<2 ; j++ ) {
-  			mpz_init(ct_AND[i][j]);
-  			mpz_import(ct_AND[i][j],1,-1,bits_to_bytes(KEY_SIZE),0,0,Bob->ct_AND[i][j]);
-  		}
-  	}
+    Alice_keys[i]=block_load(Bob->Alice_keys+i*BLOCK_BYTES);
   }
-
-  for (int i=0 ; i<2 ;i++) mpz_import(trans_table[i],1,-1,bits_to_bytes(KEY_SIZE),0,0,Bob->trans_table[i]);
+  for (int i=0 ; i<2 ; i++) trans_table[i]=block_load(Bob->trans_table+i*BLOCK_BYTES);
 
   mpz_import(rho,1,-1,bits_to_bytes(PARAM_L+PARAM_K),0,0,Bob->rho);
 }
 
 /**
-  * \fn void step4_clear(Bob_struct * Bob, OT_receiver * Bob_OT, mpz_t rho, mpz_t * x, mpz_t * trans_table, mpz_t ** ct_AND, mpz_t * Bob_keys, mpz_t * Alice_keys, mpz_t ** keys)
-  * \brief This function exports mpz_t values to bytes arrays and allocates memory
-
-  * \param[out] Bob        Bob_struct stocking Bob's values
-  * \param[out] Bob_OT     OT_receiver stocking Bob's values for the oblivious transfers
+  * \fn void step4_clear(mpz_t rho, mpz_t * x, mpz_t ** keys, mpz_t * Bob_keys)
+  * \brief This function releases memory
 
   * \param[in] rho         mpz_t representing the random new input generated by Bob
   * \param[in] x           mpz_t array representing the random values generated by Bob
-  * \param[in] trans_table mpz_t array representing the translation table
-  * \param[in] ct_AND      mpz_t double array representing the ciphertexts for the AND gates
-  * \param[in] Bob_keys    mpz_t array representing the Bob's input keys
-  * \param[in] Alice_keys  mpz_t array representing the Alice's input keys
   * \param[in] keys        mpz_t double array representing the keys generated during the oblivious transfers
+  * \param[in] Bob_keys    mpz_t array representing the Bob's input keys retrieved by the oblivious transfers
 */
-void step4_clear(Bob_struct * Bob, OT_receiver * Bob_OT, mpz_t rho, mpz_t * x, mpz_t * trans_table, mpz_t ** ct_AND, mpz_t * Bob_keys, mpz_t * Alice_keys, mpz_t ** keys) {
+void step4_clear(mpz_t rho, mpz_t * x, mpz_t ** keys, mpz_t * Bob_keys) {
   for (int i=0 ; i<PARAM_L+1 ; i++) {
-    mpz_clears(Alice_keys[i],Bob_keys[i],x[i],keys[i][0],keys[i][1],NULL);
+    mpz_clears(Bob_keys[i],x[i],keys[i][0],keys[i][1],NULL);
     free(keys[i]);
-    if (i<PARAM_L) {
-     mpz_clears(ct_AND[i][0],ct_AND[i][1],NULL);
-  	 	free(ct_AND[i]);
-  	}
   }
-  mpz_clears(rho,trans_table[0],trans_table[1],NULL);
+  mpz_clear(rho);
   free(x);
-  free(trans_table);
-  free(ct_AND);
   free(Bob_keys);
-  free(Alice_keys);
   free(keys);
 }
 
+/**
+  * \fn static int cmp_Bob_ot_keys(OT_receiver * Bob_OT, mpz_t * Bob_keys, mpz_t ** K, mpz_t * x, mpz_t rho)
+  * \brief This function runs the receiver's side of the PARAM_L+1 OTs of a comparison with the OTs set in Bob_OT
+*/
+static int cmp_Bob_ot_keys(OT_receiver * Bob_OT, mpz_t * Bob_keys, mpz_t ** K, mpz_t * x, mpz_t rho) {
+
+  OT_ext_receiver * ext = Bob_OT->rec_ext;
+  int index = Bob_OT->rec_ext_index;
+
+  OT_receiver_session * session = Bob_OT->rec_session;
+
+  if (ext==NULL && session!=NULL) {
+    // The session may have been rotated since this comparison's S was decoded
+    if (OT_receiver_session_update(session,Bob_OT->rec_enc_S)) return 1;
+    return OT_receiver_retrieve_session(Bob_keys,K,x,session,rho);
+  }
+  if (ext==NULL) return OT_receiver_retrieve(Bob_keys,K,x,Bob_OT->rec_enc_S,rho);
+
+  if (ext->nb_random>0 && PARAM_OT_CORRELATED) OT_ext_receiver_derandomize_correlated(ext, Bob_keys, K, rho, index, PARAM_L+1);
+  else if (ext->nb_random>0) OT_ext_receiver_derandomize(ext, Bob_keys, K, rho, index, PARAM_L+1);
+  else if (PARAM_OT_CORRELATED) OT_ext_receiver_retrieve_correlated(ext, Bob_keys, K, rho, index, PARAM_L+1);
+  else OT_ext_receiver_retrieve(ext, Bob_keys, K, rho, index, PARAM_L+1);
+  return 0;
+}
+
 /**
   * \fn int cmp_Bob_step4(Bob_struct * Bob, OT_receiver * Bob_OT)
   * \brief This function gathers subfunctions used by Bob in the fourth step
 
   * \param[out] Bob variable stocking Bob's Values
   * \param[out] Bob_OT s variable stocking Bob's values for the oblivious transfer
+
+  * \return the result of the comparison, 0 or 1
+  * \return -1 if the OT keys can not be retrieved or the output key has no match in the translation table
 */
 int cmp_Bob_step4(Bob_struct * Bob , OT_receiver * Bob_OT) {
 
   int result;
   mpz_t mpz_rho;
   mpz_t * mpz_x=calloc(PARAM_L+1,sizeof(mpz_t));
-  mpz_t * mpz_trans_table=calloc(2,sizeof(mpz_t));
-  mpz_t ** mpz_ct_AND=calloc(PARAM_L,sizeof(mpz_t*));
   mpz_t * mpz_Bob_keys=calloc(PARAM_L+1,sizeof(mpz_t));
-  mpz_t * mpz_Alice_keys=calloc(PARAM_L+1,sizeof(mpz_t));
   mpz_t ** mpz_keys=calloc(PARAM_L+1,sizeof(mpz_t*));
+  block Alice_keys[PARAM_L+1], Bob_keys[PARAM_L+1], trans_table[2];
 
-  step4_init(mpz_rho, mpz_x, mpz_trans_table, mpz_ct_AND, mpz_Bob_keys, mpz_Alice_keys, mpz_keys, Bob, Bob_OT);
+  step4_init(mpz_rho, mpz_x, mpz_keys, mpz_Bob_keys, Alice_keys, trans_table, Bob, Bob_OT);
 
-  OT_receiver_retrieve(mpz_Bob_keys,mpz_keys,mpz_x,Bob_OT->rec_enc_S,mpz_rho);
+  if (cmp_Bob_ot_keys(Bob_OT, mpz_Bob_keys, mpz_keys, mpz_x, mpz_rho)) {
+    step4_clear(mpz_rho, mpz_x, mpz_keys, mpz_Bob_keys);
+    printf("Error : Bob can not retrieve the OT keys\n");
+    return -1 ;
+  }
+  for (int i=0 ; i<PARAM_L+1 ; i++) Bob_keys[i]=mpz_get_block(mpz_Bob_keys[i]);
 
-  result=cmp_Bob_eval(mpz_Alice_keys, mpz_Bob_keys, mpz_ct_AND, mpz_trans_table);
+  result=cmp_Bob_eval(Alice_keys, Bob_keys, Bob->ct_AND, trans_table);
+  step4_clear(mpz_rho, mpz_x, mpz_keys, mpz_Bob_keys);
   if (result==-1) {
     printf("Error : no match in the translation table\n");
     return -1 ;
   }
   if (PARAM_INEQ%2==1) result=1-result;
 
-  step4_clear(Bob, Bob_OT, mpz_rho, mpz_x, mpz_trans_table, mpz_ct_AND, mpz_Bob_keys, mpz_Alice_keys, mpz_keys);
-
   return result;
 }
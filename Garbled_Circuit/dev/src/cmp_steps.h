@@ -14,23 +14,33 @@
 #include "auxiliary_functions.h"
 #include "gate_functions.h"
 #include "oblivious_transfer.h"
+#include "ot_extension.h"
 
 
 
 void step1_init(mpz_t Alice, mpz_t y, uint8_t * Alice_input);
 void step1_clear(uint8_t * ct_Alice, uint8_t * sen_y, mpz_t Alice, mpz_t y);
-void cmp_Alice_step1(Alice_struct * Alice, OT_sender * Alice_OT, uint8_t * Alice_input);
+void cmp_Alice_step1(Alice_struct * Alice, OT_sender * Alice_OT, uint8_t * Alice_input, paillier_ctx * ctx);
+void cmp_Alice_step1_ct(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t ct_input, paillier_ctx * ctx);
 
 void step2_init(mpz_t * x, mpz_t mpz_Bob, mpz_t ct_Alice, mpz_t rho, mpz_t ct_gamma, Bob_struct * Bob, uint8_t * Bob_input);
 void step2_clear(Bob_struct * Bob, OT_receiver * Bob_OT, mpz_t * x, mpz_t mpz_Bob, mpz_t ct_Alice, mpz_t rho, mpz_t ct_gamma);
-void cmp_Bob_step2(Bob_struct * Bob, OT_receiver * Bob_OT, uint8_t * Bob_input);
+int cmp_Bob_step2(Bob_struct * Bob, OT_receiver * Bob_OT, uint8_t * Bob_input, paillier_ctx * ctx);
 
-void step3_init(mpz_t gamma, mpz_t ct_gamma, mpz_t y, mpz_t ** keys, mpz_t ** kA, mpz_t ** kB, mpz_t ** ct_AND, mpz_t * input_keys, mpz_t * trans_table, Alice_struct * Alice, OT_sender * Alice_OT);
-void step3_clear(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t gamma, mpz_t ct_gamma, mpz_t y, mpz_t ** keys, mpz_t ** kA, mpz_t ** kB, mpz_t ** ct_AND, mpz_t * input_keys, mpz_t * trans_table);
-int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT);
+void step3_init(mpz_t y, mpz_t ** keys, mpz_t ** kB, OT_sender * Alice_OT);
+void step3_clear(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t y, mpz_t ** keys, mpz_t ** kB, block * trans_table);
+int cmp_Alice_step3(Alice_struct * Alice, OT_sender * Alice_OT, paillier_ctx * ctx);
+int cmp_Alice_step3_garbling(Alice_struct * Alice, OT_sender * Alice_OT, mpz_t gamma);
 
-void step4_init(mpz_t rho, mpz_t * x, mpz_t * trans_table, mpz_t ** ct_AND, mpz_t * Bob_keys, mpz_t * Alice_keys, mpz_t ** keys, Bob_struct * Bob, OT_receiver * Bob_OT);
-void step4_clear(Bob_struct * Bob, OT_receiver * Bob_OT, mpz_t rho, mpz_t * x, mpz_t * trans_table, mpz_t ** ct_AND, mpz_t * Bob_keys, mpz_t * Alice_keys, mpz_t ** keys);
+int cmp_Bob_ext_choose(OT_receiver ** Bob_OT, mpz_t * rho, int nb);
+int cmp_Alice_ext_expand(OT_sender ** Alice_OT, int nb);
+
+int cmp_Alice_batch_step1(OT_sender ** Alice_OT, uint8_t ** Alice_inputs, int nb, uint8_t * ct_packed, paillier_ctx * ctx);
+int cmp_Bob_batch_step2(Bob_struct ** Bob, OT_receiver ** Bob_OT, uint8_t ** Bob_inputs, int nb, uint8_t * ct_Alice_packed, uint8_t * ct_gamma_packed, paillier_ctx * ctx);
+int cmp_Alice_batch_step3(Alice_struct ** Alice, OT_sender ** Alice_OT, int nb, uint8_t * ct_gamma_packed, paillier_ctx * ctx);
+
+void step4_init(mpz_t rho, mpz_t * x, mpz_t ** keys, mpz_t * Bob_keys, block * Alice_keys, block * trans_table, Bob_struct * Bob, OT_receiver * Bob_OT);
+void step4_clear(mpz_t rho, mpz_t * x, mpz_t ** keys, mpz_t * Bob_keys);
 int cmp_Bob_step4(Bob_struct * Bob , OT_receiver * Bob_OT);
 
 #endif
@@ -0,0 +1,289 @@
+/**
+  * \file damgard_jurik.c
+  * \brief implementation of Damgard-Jurik's cryptosystem
+*/
+
+#include "damgard_jurik.h"
+
+/**
+  * \fn dj_ctx * dj_ctx_init(int s)
+  * \brief This function initializes an empty Damgard-Jurik key context of exponent s
+
+  * \param[in] s  int representing the exponent, s=1 gives back Paillier's cryptosystem
+
+  * \return ctx an initialized dj_ctx variable
+*/
+dj_ctx * dj_ctx_init(int s) {
+  dj_ctx * ctx = (dj_ctx *) malloc(sizeof(dj_ctx));
+  ctx->s=s;
+  ctx->has_sk=0;
+  ctx->n_pow=calloc(s+2,sizeof(mpz_t));
+  ctx->fact_inv=calloc(s+1,sizeof(mpz_t));
+  for (int k=0 ; k<s+2 ; k++) mpz_init(ctx->n_pow[k]);
+  for (int k=0 ; k<s+1 ; k++) mpz_init(ctx->fact_inv[k]);
+  mpz_inits(ctx->n,ctx->p,ctx->q,ctx->p_s,ctx->q_s,ctx->p_s1,ctx->q_s1,ctx->dp,ctx->dq,ctx->p_inv_q,ctx->phi_inv,NULL);
+
+  mpz_t s0;
+  uint8_t bytes_array[32];
+  random_bytes(bytes_array,32);
+  mpz_init(s0);
+  mpz_import(s0,32,-1,1,0,0,bytes_array);
+  gmp_randinit_default(ctx->seed);
+  gmp_randseed(ctx->seed,s0);
+  mpz_clear(s0);
+  return ctx;
+}
+
+/**
+  * \fn void dj_ctx_clear(dj_ctx * ctx)
+  * \brief This function releases a Damgard-Jurik key context
+
+  * \param[in] ctx the variable to release
+*/
+void dj_ctx_clear(dj_ctx * ctx) {
+  for (int k=0 ; k<ctx->s+2 ; k++) mpz_clear(ctx->n_pow[k]);
+  for (int k=0 ; k<ctx->s+1 ; k++) mpz_clear(ctx->fact_inv[k]);
+  free(ctx->n_pow);
+  free(ctx->fact_inv);
+  mpz_clears(ctx->n,ctx->p,ctx->q,ctx->p_s,ctx->q_s,ctx->p_s1,ctx->q_s1,ctx->dp,ctx->dq,ctx->p_inv_q,ctx->phi_inv,NULL);
+  gmp_randclear(ctx->seed);
+  free(ctx);
+}
+
+/**
+  * \fn void dj_ctx_set_str(dj_ctx * ctx, char * n, char * p, char * q, int base)
+  * \brief This function sets a Damgard-Jurik key from given strings and precomputes its values
+
+  * \param[out] ctx  dj_ctx representing the key to set
+
+  * \param[in] n     char array representing the public modulus
+  * \param[in] p     char array representing the first prime factor, NULL for a public key only
+  * \param[in] q     char array representing the second prime factor, NULL for a public key only
+  * \param[in] base  int representing the base in which the values are written
+*/
+void dj_ctx_set_str(dj_ctx * ctx, char * n, char * p, char * q, int base) {
+  mpz_set_str(ctx->n,n,base);
+  ctx->has_sk=(p!=NULL && q!=NULL);
+  if (ctx->has_sk) {
+    mpz_set_str(ctx->p,p,base);
+    mpz_set_str(ctx->q,q,base);
+  }
+  dj_ctx_precompute(ctx);
+}
+
+/**
+  * \fn void dj_ctx_precompute(dj_ctx * ctx)
+  * \brief This function computes every value derived from n (and p, q if the secret key is set)
+
+  * \param[in,out] ctx dj_ctx whose s, n, p, q and has_sk fields are set
+*/
+void dj_ctx_precompute(dj_ctx * ctx) {
+
+  int s=ctx->s;
+  mpz_set_ui(ctx->n_pow[0],1);
+  for (int k=1 ; k<s+2 ; k++) mpz_mul(ctx->n_pow[k],ctx->n_pow[k-1],ctx->n);
+
+  // k! only has factors smaller than p and q, hence is invertible mod n^s
+  mpz_set_ui(ctx->fact_inv[0],1);
+  for (int k=1 ; k<s+1 ; k++) mpz_mul_ui(ctx->fact_inv[k],ctx->fact_inv[k-1],k);
+  for (int k=1 ; k<s+1 ; k++) mpz_invert(ctx->fact_inv[k],ctx->fact_inv[k],ctx->n_pow[s]);
+  if (!ctx->has_sk) return;
+
+  mpz_t p_1, q_1, phi;
+  mpz_inits(p_1,q_1,phi,NULL);
+  mpz_sub_ui(p_1,ctx->p,1);
+  mpz_sub_ui(q_1,ctx->q,1);
+  mpz_mul(phi,p_1,q_1);
+
+  mpz_pow_ui(ctx->p_s,ctx->p,s);
+  mpz_pow_ui(ctx->q_s,ctx->q,s);
+  mpz_mul(ctx->p_s1,ctx->p_s,ctx->p);
+  mpz_mul(ctx->q_s1,ctx->q_s,ctx->q);
+
+  // Z_(p^(s+1))^* has order p^s(p-1), so phi(n) can be reduced modulo it
+  mpz_mul(ctx->dp,ctx->p_s,p_1);
+  mpz_mod(ctx->dp,phi,ctx->dp);
+  mpz_mul(ctx->dq,ctx->q_s,q_1);
+  mpz_mod(ctx->dq,phi,ctx->dq);
+
+  mpz_invert(ctx->p_inv_q,ctx->p_s1,ctx->q_s1);
+  mpz_invert(ctx->phi_inv,phi,ctx->n_pow[s]);
+
+  mpz_clears(p_1,q_1,phi,NULL);
+}
+
+/**
+  * \fn void dj_randomizer(mpz_t rn, mpz_t r, dj_ctx * ctx)
+  * \brief This function computes a random n^s-th residue modulo n^(s+1) from a random value r
+
+  * With a public key only, rn = r^(n^s) mod n^(s+1). If the context holds the secret key, rn is congruent to
+  * (r mod p)^(p^s) modulo p^(s+1) and to (r mod q)^(q^s) modulo q^(s+1), which, as for paillier_randomizer,
+  * only depends on r mod p and r mod q and is uniform over the n^s-th residues.
+
+  * \param[out] rn  mpz_t representing the n^s-th residue modulo n^(s+1)
+
+  * \param[in] r    mpz_t representing a random value of Z_n^*
+  * \param[in] ctx  dj_ctx representing the key
+*/
+void dj_randomizer(mpz_t rn, mpz_t r, dj_ctx * ctx) {
+
+  if (!ctx->has_sk) {
+    mpz_powm(rn,r,ctx->n_pow[ctx->s],ctx->n_pow[ctx->s+1]);
+    return;
+  }
+
+  mpz_t rp,rq;
+  mpz_inits(rp,rq,NULL);
+
+  mpz_mod(rp,r,ctx->p);
+  mpz_powm(rp,rp,ctx->p_s,ctx->p_s1);
+  mpz_mod(rq,r,ctx->q);
+  mpz_powm(rq,rq,ctx->q_s,ctx->q_s1);
+
+  // rn = rp + p^(s+1) * ((rq - rp) * p^-(s+1) mod q^(s+1))
+  mpz_sub(rq,rq,rp);
+  mpz_mul(rq,rq,ctx->p_inv_q);
+  mpz_mod(rq,rq,ctx->q_s1);
+  mpz_mul(rq,rq,ctx->p_s1);
+  mpz_add(rn,rq,rp);
+
+  mpz_clears(rp,rq,NULL);
+}
+
+/**
+  * \fn void dj_dlog(mpz_t i, mpz_t a, dj_ctx * ctx)
+  * \brief This function recovers i mod n^s from a = (1+n)^i mod n^(s+1)
+
+  * i is lifted one power of n at a time: knowing i mod n^(j-1), the binomial expansion of (1+n)^i mod n^(j+1)
+  * gives i mod n^j once the terms C(i,k) n^(k-1) for k = 2, ..., j are removed.
+
+  * \param[out] i   mpz_t representing the discrete logarithm
+
+  * \param[in] a    mpz_t representing a power of 1+n modulo n^(s+1)
+  * \param[in] ctx  dj_ctx representing the key
+*/
+void dj_dlog(mpz_t i, mpz_t a, dj_ctx * ctx) {
+
+  mpz_t t1, t2, ik, tmp, acc;
+  mpz_inits(t1,t2,ik,tmp,acc,NULL);
+
+  for (int j=1 ; j<=ctx->s ; j++) {
+    // t1 = L(a mod n^(j+1)) = (a mod n^(j+1) - 1) / n
+    mpz_mod(t1,a,ctx->n_pow[j+1]);
+    mpz_sub_ui(t1,t1,1);
+    mpz_divexact(t1,t1,ctx->n);
+
+    // t2 = i (i-1) ... (i-k+1), so that C(i,k) = t2 / k!
+    mpz_set(t2,acc);
+    mpz_set(ik,acc);
+    for (int k=2 ; k<=j ; k++) {
+      mpz_sub_ui(ik,ik,1);
+      mpz_mul(t2,t2,ik);
+      mpz_mod(t2,t2,ctx->n_pow[j]);
+      mpz_mul(tmp,t2,ctx->n_pow[k-1]);
+      mpz_mul(tmp,tmp,ctx->fact_inv[k]);
+      mpz_sub(t1,t1,tmp);
+    }
+    mpz_mod(acc,t1,ctx->n_pow[j]);
+  }
+  mpz_swap(i,acc);
+
+  mpz_clears(t1,t2,ik,tmp,acc,NULL);
+}
+
+/**
+  * \fn void dj_encrypt(mpz_t c, mpz_t m, dj_ctx * ctx)
+  * \brief This function encrypts a message mod n^s with a Damgard-Jurik key, using the CRT if the secret key is held
+
+  * (1+n)^m mod n^(s+1) is computed from its binomial expansion, sum of C(m,k) n^k for k = 0, ..., s.
+
+  * \param[out] c mpz_t representing the encrypted value
+
+  * \param[in] m    mpz_t representing the message to encrypt
+  * \param[in] ctx  dj_ctx representing the key
+*/
+void dj_encrypt(mpz_t c, mpz_t m, dj_ctx * ctx) {
+
+  mpz_t r, g, binom;
+  mpz_inits(r,g,binom,NULL);
+
+  mpz_urandomm(r,ctx->seed,ctx->n);
+  dj_randomizer(r,r,ctx);
+
+  mpz_set_ui(g,1);
+  for (int k=1 ; k<=ctx->s ; k++) {
+    mpz_bin_ui(binom,m,k);
+    mpz_mod(binom,binom,ctx->n_pow[ctx->s+1-k]);
+    mpz_addmul(g,binom,ctx->n_pow[k]);
+  }
+
+  mpz_mul(c,g,r);
+  mpz_mod(c,c,ctx->n_pow[ctx->s+1]);
+
+  mpz_clears(r,g,binom,NULL);
+}
+
+/**
+  * \fn void dj_decrypt(mpz_t m, mpz_t c, dj_ctx * ctx)
+  * \brief function decrypting a ciphertext with a Damgard-Jurik key
+
+  * c^phi(n) = (1+n)^(m phi(n)) mod n^(s+1) is computed with two half-size exponentiations and the CRT,
+  * then m phi(n) is recovered with dj_dlog.
+
+  * \param[out] m mpz_t representing the decrypted value mod n^s
+
+  * \param[in] c    mpz_t representing the ciphertext to decrypt
+  * \param[in] ctx  dj_ctx representing the secret key
+*/
+void dj_decrypt(mpz_t m, mpz_t c, dj_ctx * ctx) {
+
+  mpz_t cp,cq;
+  mpz_inits(cp,cq,NULL);
+
+  mpz_mod(cp,c,ctx->p_s1);
+  mpz_powm(cp,cp,ctx->dp,ctx->p_s1);
+  mpz_mod(cq,c,ctx->q_s1);
+  mpz_powm(cq,cq,ctx->dq,ctx->q_s1);
+
+  // c^phi(n) = cp + p^(s+1) * ((cq - cp) * p^-(s+1) mod q^(s+1))
+  mpz_sub(cq,cq,cp);
+  mpz_mul(cq,cq,ctx->p_inv_q);
+  mpz_mod(cq,cq,ctx->q_s1);
+  mpz_mul(cq,cq,ctx->p_s1);
+  mpz_add(cp,cp,cq);
+
+  dj_dlog(m,cp,ctx);
+  mpz_mul(m,m,ctx->phi_inv);
+  mpz_mod(m,m,ctx->n_pow[ctx->s]);
+
+  mpz_clears(cp,cq,NULL);
+}
+
+/**
+  * \fn void dj_add(mpz_t c, mpz_t c1, mpz_t c2, dj_ctx * ctx)
+  * \brief This function computes an encryption of m1 + m2 mod n^s from encryptions of m1 and m2
+
+  * \param[out] c   mpz_t representing the encrypted sum
+
+  * \param[in] c1   mpz_t representing the first ciphertext
+  * \param[in] c2   mpz_t representing the second ciphertext
+  * \param[in] ctx  dj_ctx representing the key
+*/
+void dj_add(mpz_t c, mpz_t c1, mpz_t c2, dj_ctx * ctx) {
+  mpz_mul(c,c1,c2);
+  mpz_mod(c,c,ctx->n_pow[ctx->s+1]);
+}
+
+/**
+  * \fn void dj_mul_scalar(mpz_t c, mpz_t c1, mpz_t k, dj_ctx * ctx)
+  * \brief This function computes an encryption of k m1 mod n^s from an encryption of m1
+
+  * \param[out] c   mpz_t representing the encrypted product
+
+  * \param[in] c1   mpz_t representing the ciphertext
+  * \param[in] k    mpz_t representing the plaintext scalar
+  * \param[in] ctx  dj_ctx representing the key
+*/
+void dj_mul_scalar(mpz_t c, mpz_t c1, mpz_t k, dj_ctx * ctx) {
+  mpz_powm(c,c1,k,ctx->n_pow[ctx->s+1]);
+}
@@ -0,0 +1,52 @@
+/**
+  * \file damgard_jurik.h
+  * \brief Functions used to implement Damgard-Jurik's generalization of Paillier's encryption
+*/
+
+
+#ifndef DAMGARD_JURIK_H
+#define DAMGARD_JURIK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gmp.h"
+#include "parameters.h"
+#include "randombytes.h"
+
+/**
+  * \typedef dj_ctx
+  * \brief Structure for a Damgard-Jurik key of exponent s and its precomputed values
+  */
+typedef struct dj_ctx {
+  int s ; /**< Exponent s, plaintexts are taken mod n^s and ciphertexts mod n^(s+1) */
+  int has_sk ; /**< 1 if the secret part of the context is set, 0 otherwise */
+  mpz_t n ; /**< Public modulus n = pq */
+  mpz_t * n_pow ; /**< n_pow[k] = n^k for k = 0, ..., s+1 */
+  mpz_t * fact_inv ; /**< fact_inv[k] = (k!)^-1 mod n^s for k = 0, ..., s */
+  mpz_t p ; /**< First prime factor of n */
+  mpz_t q ; /**< Second prime factor of n */
+  mpz_t p_s ; /**< p^s, randomizer exponent modulo p^(s+1) */
+  mpz_t q_s ; /**< q^s, randomizer exponent modulo q^(s+1) */
+  mpz_t p_s1 ; /**< p^(s+1) */
+  mpz_t q_s1 ; /**< q^(s+1) */
+  mpz_t dp ; /**< phi(n) mod p^s(p-1), decryption exponent modulo p^(s+1) */
+  mpz_t dq ; /**< phi(n) mod q^s(q-1), decryption exponent modulo q^(s+1) */
+  mpz_t p_inv_q ; /**< p^-(s+1) mod q^(s+1), CRT recombination coefficient */
+  mpz_t phi_inv ; /**< phi(n)^-1 mod n^s */
+  gmp_randstate_t seed ; /**< Random state used to draw the randomizers, seeded from the system */
+} dj_ctx ;
+
+dj_ctx * dj_ctx_init(int s);
+void dj_ctx_clear(dj_ctx * ctx);
+void dj_ctx_set_str(dj_ctx * ctx, char * n, char * p, char * q, int base);
+void dj_ctx_precompute(dj_ctx * ctx);
+
+void dj_randomizer(mpz_t rn, mpz_t r, dj_ctx * ctx);
+void dj_dlog(mpz_t i, mpz_t a, dj_ctx * ctx);
+void dj_encrypt(mpz_t c, mpz_t m, dj_ctx * ctx);
+void dj_decrypt(mpz_t m, mpz_t c, dj_ctx * ctx);
+void dj_add(mpz_t c, mpz_t c1, mpz_t c2, dj_ctx * ctx);
+void dj_mul_scalar(mpz_t c, mpz_t c1, mpz_t k, dj_ctx * ctx);
+
+#endif
@@ -0,0 +1,432 @@
+/**
+ * \file field_25519.c
+ * \brief Implementation of field_25519.h
+ */
+
+#include "field_25519.h"
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+const fe25519 FE_D = {0x34dca135978a3ULL, 0x1a8283b156ebdULL, 0x5e7a26001c029ULL, 0x739c663a03cbbULL, 0x52036cee2b6ffULL};
+const fe25519 FE_D2 = {0x69b9426b2f159ULL, 0x35050762add7aULL, 0x3cf44c0038052ULL, 0x6738cc7407977ULL, 0x2406d9dc56dffULL};
+const fe25519 FE_SQRTM1 = {0x61b274a0ea0b0ULL, 0x0d5a5fc8f189dULL, 0x7ef5e9cbd0c60ULL, 0x78595a6804c9eULL, 0x2b8324804fc1dULL};
+
+/**
+  * \fn static void fe_carry(fe25519 r)
+  * \brief This function propagates the carries of the limbs, the carry out of the top limb is folded back as 19
+
+  * \param[in,out] r   field element with limbs below 2^63, limbs below 2^52 on output
+*/
+static void fe_carry(fe25519 r) {
+  uint64_t c;
+  c = r[0] >> FE_LIMB_BITS; r[0] &= FE_LIMB_MASK; r[1] += c;
+  c = r[1] >> FE_LIMB_BITS; r[1] &= FE_LIMB_MASK; r[2] += c;
+  c = r[2] >> FE_LIMB_BITS; r[2] &= FE_LIMB_MASK; r[3] += c;
+  c = r[3] >> FE_LIMB_BITS; r[3] &= FE_LIMB_MASK; r[4] += c;
+  c = r[4] >> FE_LIMB_BITS; r[4] &= FE_LIMB_MASK; r[0] += 19*c;
+}
+
+/**
+  * \fn static void fe_carry_wide(fe25519 r, uint128_t * t)
+  * \brief This function reduces the five 128-bit column sums of a product to a field element
+
+  * \param[out] r   reduced field element
+  * \param[in]  t   column sums, t[i] is the coefficient of 2^(51 i)
+*/
+static void fe_carry_wide(fe25519 r, uint128_t * t) {
+  uint64_t c;
+  r[0] = (uint64_t) t[0] & FE_LIMB_MASK; t[1] += (uint64_t) (t[0] >> FE_LIMB_BITS);
+  r[1] = (uint64_t) t[1] & FE_LIMB_MASK; t[2] += (uint64_t) (t[1] >> FE_LIMB_BITS);
+  r[2] = (uint64_t) t[2] & FE_LIMB_MASK; t[3] += (uint64_t) (t[2] >> FE_LIMB_BITS);
+  r[3] = (uint64_t) t[3] & FE_LIMB_MASK; t[4] += (uint64_t) (t[3] >> FE_LIMB_BITS);
+  r[4] = (uint64_t) t[4] & FE_LIMB_MASK; c = (uint64_t) (t[4] >> FE_LIMB_BITS);
+  r[0] += 19*c;
+  c = r[0] >> FE_LIMB_BITS; r[0] &= FE_LIMB_MASK; r[1] += c;
+}
+
+/**
+  * \fn void fe_0(fe25519 r)
+  * \brief This function sets a field element to 0
+
+  * \param[out] r   field element to set
+*/
+void fe_0(fe25519 r) {
+  r[0] = r[1] = r[2] = r[3] = r[4] = 0;
+}
+
+/**
+  * \fn void fe_1(fe25519 r)
+  * \brief This function sets a field element to 1
+
+  * \param[out] r   field element to set
+*/
+void fe_1(fe25519 r) {
+  r[0] = 1;
+  r[1] = r[2] = r[3] = r[4] = 0;
+}
+
+/**
+  * \fn void fe_copy(fe25519 r, const fe25519 a)
+  * \brief This function copies a field element
+
+  * \param[out] r   copy of a
+  * \param[in]  a   field element to copy
+*/
+void fe_copy(fe25519 r, const fe25519 a) {
+  for (int i=0 ; i<FE_LIMBS ; i++) r[i] = a[i];
+}
+
+/**
+  * \fn void fe_cmov(fe25519 r, const fe25519 a, int b)
+  * \brief This function replaces r by a if b = 1 and leaves it unchanged if b = 0, without branching on b
+
+  * \param[in,out] r   field element to update
+  * \param[in]     a   field element to copy
+  * \param[in]     b   0 or 1
+*/
+void fe_cmov(fe25519 r, const fe25519 a, int b) {
+  uint64_t mask = -(uint64_t) b;
+  for (int i=0 ; i<FE_LIMBS ; i++) r[i] ^= mask & (r[i] ^ a[i]);
+}
+
+/**
+  * \fn void fe_add(fe25519 r, const fe25519 a, const fe25519 b)
+  * \brief This function computes r = a + b mod p
+
+  * \param[out] r   sum, may be a or b
+  * \param[in]  a   first operand
+  * \param[in]  b   second operand
+*/
+void fe_add(fe25519 r, const fe25519 a, const fe25519 b) {
+  for (int i=0 ; i<FE_LIMBS ; i++) r[i] = a[i] + b[i];
+  fe_carry(r);
+}
+
+/**
+  * \fn void fe_sub(fe25519 r, const fe25519 a, const fe25519 b)
+  * \brief This function computes r = a - b mod p, 2p is added first so that the limbs stay positive
+
+  * \param[out] r   difference, may be a or b
+  * \param[in]  a   first operand
+  * \param[in]  b   second operand
+*/
+void fe_sub(fe25519 r, const fe25519 a, const fe25519 b) {
+  r[0] = a[0] + 0xfffffffffffdaULL - b[0];
+  r[1] = a[1] + 0xffffffffffffeULL - b[1];
+  r[2] = a[2] + 0xffffffffffffeULL - b[2];
+  r[3] = a[3] + 0xffffffffffffeULL - b[3];
+  r[4] = a[4] + 0xffffffffffffeULL - b[4];
+  fe_carry(r);
+}
+
+/**
+  * \fn void fe_neg(fe25519 r, const fe25519 a)
+  * \brief This function computes r = -a mod p
+
+  * \param[out] r   opposite, may be a
+  * \param[in]  a   field element to negate
+*/
+void fe_neg(fe25519 r, const fe25519 a) {
+  fe25519 zero;
+  fe_0(zero);
+  fe_sub(r, zero, a);
+}
+
+/**
+  * \fn void fe_mul(fe25519 r, const fe25519 a, const fe25519 b)
+  * \brief This function computes r = a b mod p, the products by 2^255 are folded back as products by 19
+
+  * \param[out] r   product, may be a or b
+  * \param[in]  a   first operand
+  * \param[in]  b   second operand
+*/
+void fe_mul(fe25519 r, const fe25519 a, const fe25519 b) {
+  uint128_t t[FE_LIMBS];
+  uint64_t b1_19 = 19*b[1], b2_19 = 19*b[2], b3_19 = 19*b[3], b4_19 = 19*b[4];
+
+  t[0] = (uint128_t) a[0]*b[0] + (uint128_t) a[1]*b4_19 + (uint128_t) a[2]*b3_19 + (uint128_t) a[3]*b2_19 + (uint128_t) a[4]*b1_19;
+  t[1] = (uint128_t) a[0]*b[1] + (uint128_t) a[1]*b[0] + (uint128_t) a[2]*b4_19 + (uint128_t) a[3]*b3_19 + (uint128_t) a[4]*b2_19;
+  t[2] = (uint128_t) a[0]*b[2] + (uint128_t) a[1]*b[1] + (uint128_t) a[2]*b[0] + (uint128_t) a[3]*b4_19 + (uint128_t) a[4]*b3_19;
+  t[3] = (uint128_t) a[0]*b[3] + (uint128_t) a[1]*b[2] + (uint128_t) a[2]*b[1] + (uint128_t) a[3]*b[0] + (uint128_t) a[4]*b4_19;
+  t[4] = (uint128_t) a[0]*b[4] + (uint128_t) a[1]*b[3] + (uint128_t) a[2]*b[2] + (uint128_t) a[3]*b[1] + (uint128_t) a[4]*b[0];
+  fe_carry_wide(r, t);
+}
+
+/**
+  * \fn void fe_sq(fe25519 r, const fe25519 a)
+  * \brief This function computes r = a^2 mod p, with 15 products instead of 25
+
+  * \param[out] r   square, may be a
+  * \param[in]  a   field element to square
+*/
+void fe_sq(fe25519 r, const fe25519 a) {
+  uint128_t t[FE_LIMBS];
+  uint64_t a0_2 = 2*a[0], a1_2 = 2*a[1], a2_2 = 2*a[2], a3_19 = 19*a[3], a4_19 = 19*a[4];
+
+  t[0] = (uint128_t) a[0]*a[0] + (uint128_t) a1_2*a4_19 + (uint128_t) a2_2*a3_19;
+  t[1] = (uint128_t) a0_2*a[1] + (uint128_t) a2_2*a4_19 + (uint128_t) a[3]*a3_19;
+  t[2] = (uint128_t) a0_2*a[2] + (uint128_t) a[1]*a[1] + (uint128_t) (2*a[3])*a4_19;
+  t[3] = (uint128_t) a0_2*a[3] + (uint128_t) a1_2*a[2] + (uint128_t) a[4]*a4_19;
+  t[4] = (uint128_t) a0_2*a[4] + (uint128_t) a1_2*a[3] + (uint128_t) a[2]*a[2];
+  fe_carry_wide(r, t);
+}
+
+/**
+  * \fn void fe_sq_n(fe25519 r, const fe25519 a, int n)
+  * \brief This function computes r = a^(2^n) mod p
+
+  * \param[out] r   result, may be a
+  * \param[in]  a   field element to square
+  * \param[in]  n   number of squarings, at least 1
+*/
+void fe_sq_n(fe25519 r, const fe25519 a, int n) {
+  fe_sq(r, a);
+  for (int i=1 ; i<n ; i++) fe_sq(r, r);
+}
+
+/**
+  * \fn static void fe_pow2250(fe25519 r, fe25519 a11, const fe25519 a)
+  * \brief This function computes a^(2^250-1) and a^11, the common part of the inversion and square root chains
+
+  * \param[out] r     a^(2^250-1)
+  * \param[out] a11   a^11
+  * \param[in]  a     field element to exponentiate
+*/
+static void fe_pow2250(fe25519 r, fe25519 a11, const fe25519 a) {
+  fe25519 t0, t1, t2;
+
+  fe_sq(t0, a); // 2
+  fe_sq_n(t1, t0, 2); // 8
+  fe_mul(t1, a, t1); // 9
+  fe_mul(a11, t0, t1); // 11
+  fe_sq(t0, a11); // 22
+  fe_mul(t1, t1, t0); // 2^5-1
+  fe_sq_n(t0, t1, 5);
+  fe_mul(t1, t0, t1); // 2^10-1
+  fe_sq_n(t0, t1, 10);
+  fe_mul(t0, t0, t1); // 2^20-1
+  fe_sq_n(t2, t0, 20);
+  fe_mul(t0, t2, t0); // 2^40-1
+  fe_sq_n(t0, t0, 10);
+  fe_mul(t1, t0, t1); // 2^50-1
+  fe_sq_n(t0, t1, 50);
+  fe_mul(t0, t0, t1); // 2^100-1
+  fe_sq_n(t2, t0, 100);
+  fe_mul(t0, t2, t0); // 2^200-1
+  fe_sq_n(t0, t0, 50);
+  fe_mul(r, t0, t1); // 2^250-1
+}
+
+/**
+  * \fn void fe_invert(fe25519 r, const fe25519 a)
+  * \brief This function computes r = a^-1 = a^(p-2) mod p, 0 is mapped to 0
+
+  * \param[out] r   inverse, may be a
+  * \param[in]  a   field element to invert
+*/
+void fe_invert(fe25519 r, const fe25519 a) {
+  fe25519 t, a11;
+  fe_pow2250(t, a11, a);
+  fe_sq_n(t, t, 5); // 2^255-32
+  fe_mul(r, t, a11); // 2^255-21
+}
+
+/**
+  * \fn void fe_pow22523(fe25519 r, const fe25519 a)
+  * \brief This function computes r = a^((p-5)/8) = a^(2^252-3) mod p, used for square roots
+
+  * \param[out] r   result, may be a
+  * \param[in]  a   field element to exponentiate
+*/
+void fe_pow22523(fe25519 r, const fe25519 a) {
+  fe25519 t, a11, a1;
+  fe_copy(a1, a);
+  fe_pow2250(t, a11, a1);
+  fe_sq_n(t, t, 2); // 2^252-4
+  fe_mul(r, t, a1); // 2^252-3
+}
+
+/**
+  * \fn int fe_sqrt(fe25519 r, const fe25519 a)
+  * \brief This function computes a square root of a, as b = a^((p+3)/8), or b sqrt(-1) when b^2 = -a
+
+  * \param[out] r   square root of a, may be a
+  * \param[in]  a   field element
+
+  * \return 1 if a is a square
+  * \return 0 otherwise, r is then a value whose square is not a
+*/
+int fe_sqrt(fe25519 r, const fe25519 a) {
+  fe25519 b, b2, na;
+
+  fe_pow22523(b, a);
+  fe_mul(b, b, a); // a^((p+3)/8)
+  fe_sq(b2, b);
+  fe_neg(na, a);
+  if (fe_equal(b2, a)) {
+    fe_copy(r, b);
+    return 1;
+  }
+  fe_mul(r, b, FE_SQRTM1);
+  return fe_equal(b2, na);
+}
+
+/**
+  * \fn int fe_sqrt_ratio(fe25519 r, const fe25519 u, const fe25519 v)
+  * \brief This function computes a square root of u/v without inverting v
+
+  * The candidate is b = u v^3 (u v^7)^((p-5)/8), so that v b^2 = u if u/v is a square with root b, and
+  * v b^2 = -u if its root is b sqrt(-1): one exponentiation gives both the inversion and the square root.
+
+  * \param[out] r   square root of u/v, may be u or v
+  * \param[in]  u   numerator
+  * \param[in]  v   denominator, not 0
+
+  * \return 1 if u/v is a square
+  * \return 0 otherwise, r is then a value whose square is not u/v
+*/
+int fe_sqrt_ratio(fe25519 r, const fe25519 u, const fe25519 v) {
+  fe25519 v3, b, check, nu;
+
+  fe_sq(v3, v);
+  fe_mul(v3, v3, v); // v^3
+  fe_sq(b, v3);
+  fe_mul(b, b, v); // v^7
+  fe_mul(b, b, u);
+  fe_pow22523(b, b); // (u v^7)^((p-5)/8)
+  fe_mul(b, b, v3);
+  fe_mul(b, b, u);
+  fe_sq(check, b);
+  fe_mul(check, check, v);
+  fe_neg(nu, u);
+  if (fe_equal(check, u)) {
+    fe_copy(r, b);
+    return 1;
+  }
+  fe_mul(r, b, FE_SQRTM1);
+  return fe_equal(check, nu);
+}
+
+/**
+  * \fn void fe_to_bytes(uint8_t * s, const fe25519 a)
+  * \brief This function writes the unique representative of a in [0,p) as 32 little endian bytes
+
+  * \param[out] s   32 bytes array
+  * \param[in]  a   field element to encode
+*/
+void fe_to_bytes(uint8_t * s, const fe25519 a) {
+  fe25519 t;
+  uint64_t q, w[4];
+
+  fe_copy(t, a);
+  fe_carry(t);
+  fe_carry(t);
+
+  // q = 1 if t >= p, t is then replaced by t + 19 - 2^255
+  q = (t[0] + 19) >> FE_LIMB_BITS;
+  q = (t[1] + q) >> FE_LIMB_BITS;
+  q = (t[2] + q) >> FE_LIMB_BITS;
+  q = (t[3] + q) >> FE_LIMB_BITS;
+  q = (t[4] + q) >> FE_LIMB_BITS;
+  t[0] += 19*q;
+  t[1] += t[0] >> FE_LIMB_BITS; t[0] &= FE_LIMB_MASK;
+  t[2] += t[1] >> FE_LIMB_BITS; t[1] &= FE_LIMB_MASK;
+  t[3] += t[2] >> FE_LIMB_BITS; t[2] &= FE_LIMB_MASK;
+  t[4] += t[3] >> FE_LIMB_BITS; t[3] &= FE_LIMB_MASK;
+  t[4] &= FE_LIMB_MASK;
+
+  w[0] = t[0] | (t[1] << 51);
+  w[1] = (t[1] >> 13) | (t[2] << 38);
+  w[2] = (t[2] >> 26) | (t[3] << 25);
+  w[3] = (t[3] >> 39) | (t[4] << 12);
+  for (int i=0 ; i<FE_BYTES ; i++) s[i] = (uint8_t) (w[i/8] >> (8*(i%8)));
+}
+
+/**
+  * \fn void fe_from_bytes(fe25519 r, const uint8_t * s)
+  * \brief This function reads a field element from 32 little endian bytes, the bit 255 is ignored
+
+  * \param[out] r   field element
+  * \param[in]  s   32 bytes array
+*/
+void fe_from_bytes(fe25519 r, const uint8_t * s) {
+  uint64_t w[4] = {0, 0, 0, 0};
+
+  for (int i=0 ; i<FE_BYTES ; i++) w[i/8] |= ((uint64_t) s[i]) << (8*(i%8));
+  r[0] = w[0] & FE_LIMB_MASK;
+  r[1] = ((w[0] >> 51) | (w[1] << 13)) & FE_LIMB_MASK;
+  r[2] = ((w[1] >> 38) | (w[2] << 26)) & FE_LIMB_MASK;
+  r[3] = ((w[2] >> 25) | (w[3] << 39)) & FE_LIMB_MASK;
+  r[4] = (w[3] >> 12) & FE_LIMB_MASK;
+}
+
+/**
+  * \fn void fe_set_mpz(fe25519 r, mpz_t a)
+  * \brief This function sets a field element from an integer, reduced modulo p
+
+  * \param[out] r   field element
+  * \param[in]  a   integer, may be negative
+*/
+void fe_set_mpz(fe25519 r, mpz_t a) {
+  uint8_t s[FE_BYTES] = {0};
+  mpz_t p, t;
+  mpz_inits(p, t, NULL);
+
+  mpz_setbit(p, 255);
+  mpz_sub_ui(p, p, 19);
+  mpz_mod(t, a, p);
+  mpz_export(s, NULL, -1, 1, 0, 0, t);
+  fe_from_bytes(r, s);
+
+  mpz_clears(p, t, NULL);
+}
+
+/**
+  * \fn void fe_get_mpz(mpz_t r, const fe25519 a)
+  * \brief This function returns the representative of a field element in [0,p)
+
+  * \param[out] r   integer
+  * \param[in]  a   field element
+*/
+void fe_get_mpz(mpz_t r, const fe25519 a) {
+  uint8_t s[FE_BYTES];
+  fe_to_bytes(s, a);
+  mpz_import(r, FE_BYTES, -1, 1, 0, 0, s);
+}
+
+/**
+  * \fn int fe_is_zero(const fe25519 a)
+  * \brief This function tests if a field element is 0 mod p
+
+  * \return 1 if a = 0 mod p, 0 otherwise
+*/
+int fe_is_zero(const fe25519 a) {
+  uint8_t s[FE_BYTES], acc = 0;
+  fe_to_bytes(s, a);
+  for (int i=0 ; i<FE_BYTES ; i++) acc |= s[i];
+  return acc == 0;
+}
+
+/**
+  * \fn int fe_is_odd(const fe25519 a)
+  * \brief This function returns the parity of the representative of a in [0,p)
+
+  * \return 1 if the representative is odd, 0 otherwise
+*/
+int fe_is_odd(const fe25519 a) {
+  uint8_t s[FE_BYTES];
+  fe_to_bytes(s, a);
+  return s[0] & 1;
+}
+
+/**
+  * \fn int fe_equal(const fe25519 a, const fe25519 b)
+  * \brief This function tests if two field elements are equal mod p
+
+  * \return 1 if a = b mod p, 0 otherwise
+*/
+int fe_equal(const fe25519 a, const fe25519 b) {
+  fe25519 d;
+  fe_sub(d, a, b);
+  return fe_is_zero(d);
+}
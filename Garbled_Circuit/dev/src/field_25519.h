@@ -0,0 +1,54 @@
+/**
+  * \file field_25519.h
+  * \brief Arithmetic modulo p = 2^255-19 on five 51-bit limbs, used by the twisted Edwards curve
+*/
+
+#ifndef FIELD_25519_H
+#define FIELD_25519_H
+
+#include <stdint.h>
+#include <gmp.h>
+
+#define FE_LIMBS 5 /**< number of limbs of a field element */
+#define FE_LIMB_BITS 51 /**< number of bits of a reduced limb */
+#define FE_LIMB_MASK ((1ULL<<FE_LIMB_BITS)-1) /**< mask of a reduced limb */
+#define FE_BYTES 32 /**< size of the little endian encoding of a field element */
+
+/**
+  * \typedef fe25519
+  * \brief Element of GF(2^255-19), a = a[0] + a[1] 2^51 + a[2] 2^102 + a[3] 2^153 + a[4] 2^204
+
+  * The limbs are kept below 2^52 between operations, the representation is only made unique by fe_to_bytes.
+  */
+typedef uint64_t fe25519[FE_LIMBS];
+
+extern const fe25519 FE_D; /**< d parameter of the curve */
+extern const fe25519 FE_D2; /**< 2d */
+extern const fe25519 FE_SQRTM1; /**< square root of -1, 2^((p-1)/4) */
+
+void fe_0(fe25519 r);
+void fe_1(fe25519 r);
+void fe_copy(fe25519 r, const fe25519 a);
+void fe_cmov(fe25519 r, const fe25519 a, int b);
+
+void fe_add(fe25519 r, const fe25519 a, const fe25519 b);
+void fe_sub(fe25519 r, const fe25519 a, const fe25519 b);
+void fe_neg(fe25519 r, const fe25519 a);
+void fe_mul(fe25519 r, const fe25519 a, const fe25519 b);
+void fe_sq(fe25519 r, const fe25519 a);
+void fe_sq_n(fe25519 r, const fe25519 a, int n);
+void fe_invert(fe25519 r, const fe25519 a);
+void fe_pow22523(fe25519 r, const fe25519 a);
+int fe_sqrt(fe25519 r, const fe25519 a);
+int fe_sqrt_ratio(fe25519 r, const fe25519 u, const fe25519 v);
+
+void fe_to_bytes(uint8_t * s, const fe25519 a);
+void fe_from_bytes(fe25519 r, const uint8_t * s);
+void fe_set_mpz(fe25519 r, mpz_t a);
+void fe_get_mpz(mpz_t r, const fe25519 a);
+
+int fe_is_zero(const fe25519 a);
+int fe_is_odd(const fe25519 a);
+int fe_equal(const fe25519 a, const fe25519 b);
+
+#endif
@@ -1,9 +1,35 @@
 /**
   * \file gate_functions.c
-  * \brief implementation of functions garbling and evaluating AND gates as in [ZRE15]
+  * \brief implementation of functions garbling and evaluating AND gates as in [ZRE15], or with three halves as in [RR21]
+
+  * The comparison is the circuit built by circuit_cmp, garbled and evaluated by the generic engine of circuit.c.
+
+  * [RR21] M. Rosulek and L. Roy, "Three Halves Make a Whole? Beating the Half-Gates Lower Bound for Garbled
+  * Circuits". A label is split into its halves (L, R), bytes 0 to 7 and 8 to 15 read in little endian, so that the
+  * ciphertexts do not depend on the byte order of the host. The evaluator of an AND gate
+  * hashes A, B and A ^ B, their low halves give the pads [H(A) ^ H(A ^ B), H(B) ^ H(A ^ B)] and it adds a
+  * combination of the 3 half ciphertexts G selected by its color bits (a, b). The remaining terms, the products
+  * of a and b with the offset, are dealt with by 2x2 matrices K, K' applied to the halves of A and B. They are
+  * the elements 0, 1, w, w^2 of GF(4), w acting as (L, R) -> (R, L ^ R), drawn at random by the garbler so that
+  * the pair (K, K') of each row is uniform. The pair is sent encrypted by 4 bits of the high halves of the
+  * hashes of the row, the row (0, 0) takes these 4 bits as its pair and nothing is sent for it.
 */
 
 #include "gate_functions.h"
+#include "circuit.h"
+#include <pthread.h>
+
+static pthread_once_t cmp_once = PTHREAD_ONCE_INIT;
+static circuit * cmp_circuit; /**< comparison circuit of PARAM_L bits, built once and shared by the threads */
+
+/**
+  * \fn static void cmp_circuit_setup(void)
+  * \brief This function builds the comparison circuit selected by PARAM_L and PARAM_INEQ
+*/
+static void cmp_circuit_setup(void) {
+  cmp_circuit=circuit_init();
+  circuit_cmp(cmp_circuit,PARAM_L,PARAM_INEQ);
+}
 
 /**
 	* \fn Alice_struct * cmp_Alice_init()
@@ -13,20 +39,11 @@
 */
 Alice_struct * cmp_Alice_init() {
   Alice_struct * A = (Alice_struct *) malloc(sizeof(Alice_struct)) ;
-  A->ct_Alice=calloc(PAILLIER_KEY_SIZE/4,sizeof(uint8_t));
-  A->ct_gamma=calloc(PAILLIER_KEY_SIZE/4,sizeof(uint8_t));
-  A->Alice_keys=calloc(PARAM_L+1,sizeof(uint8_t *));
-  A->trans_table=calloc(2,sizeof(uint8_t *));
-  A->ct_AND=calloc(PARAM_L,sizeof(uint8_t **));
-  for (int i=0;i<2;i++) A->trans_table[i]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
-  for (int i=0 ; i<PARAM_L+1 ; i++) {
-   //Variables Initialisation and memory allocation
-    if (i<PARAM_L) {
-    	A->ct_AND[i]=calloc(2,sizeof(uint8_t *));
-    	for (int j=0 ; j<2 ; j++) A->ct_AND[i][j]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
-    }
-    A->Alice_keys[i]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
-  }
+  A->ct_Alice=calloc(PAILLIER_MAX_KEY_SIZE/4,sizeof(uint8_t));
+  A->ct_gamma=calloc(PAILLIER_MAX_KEY_SIZE/4,sizeof(uint8_t));
+  A->Alice_keys=calloc(PARAM_L+1,BLOCK_BYTES);
+  A->trans_table=calloc(2,BLOCK_BYTES);
+  A->ct_AND=calloc(PARAM_L,GATE_AND_BYTES);
   return A;
 }
 
@@ -37,17 +54,6 @@ Alice_struct * cmp_Alice_init() {
   * \param[in] A the structure to release
 */
 void cmp_Alice_clear(Alice_struct * A) {
-  for (int i=0 ; i<PARAM_L+1 ; ++i) {
-    if (i<PARAM_L) {
-      free(A->Alice_keys[i]);
-      free(A->ct_AND[i][0]);
-      free(A->ct_AND[i][1]);
-      free(A->ct_AND[i]);
-    }
-  }
-  free(A->Alice_keys[PARAM_L]);
-  free(A->trans_table[0]);
-  free(A->trans_table[1]);
   free(A->ct_Alice);
   free(A->ct_gamma);
   free(A->Alice_keys);
@@ -65,19 +71,11 @@ void cmp_Alice_clear(Alice_struct * A) {
 Bob_struct * cmp_Bob_init() {
   Bob_struct * B = (Bob_struct *) malloc (sizeof(Bob_struct));
   B->rho=calloc(bits_to_bytes(PARAM_L+PARAM_K),sizeof(uint8_t));
-  B->ct_gamma=calloc(PAILLIER_KEY_SIZE/4,sizeof(uint8_t));
-  B->ct_Alice=calloc(PAILLIER_KEY_SIZE/4,sizeof(uint8_t));
-  B->trans_table=calloc(2,sizeof(uint8_t*));
-  B->Alice_keys=calloc(PARAM_L+1,sizeof(uint8_t *));
-  B->ct_AND=calloc(PARAM_L,sizeof(uint8_t **));
-  for (int i=0;i<2;i++) B->trans_table[i]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
-  for (int i=0 ; i<PARAM_L+1 ; i++) {
-    B->Alice_keys[i]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
-    if (i<PARAM_L) {
-			B->ct_AND[i]=calloc(2,sizeof(uint8_t *));
-    	for (int j=0 ; j<2 ; j++) B->ct_AND[i][j]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
-    }
-  }
+  B->ct_gamma=calloc(PAILLIER_MAX_KEY_SIZE/4,sizeof(uint8_t));
+  B->ct_Alice=calloc(PAILLIER_MAX_KEY_SIZE/4,sizeof(uint8_t));
+  B->trans_table=calloc(2,BLOCK_BYTES);
+  B->Alice_keys=calloc(PARAM_L+1,BLOCK_BYTES);
+  B->ct_AND=calloc(PARAM_L,GATE_AND_BYTES);
   return B ;
 }
 
@@ -88,16 +86,6 @@ Bob_struct * cmp_Bob_init() {
   * \param[in] B the structure to release
 */
 void cmp_Bob_clear(Bob_struct * B) {
-	for (int i = 0; i < PARAM_L; ++i)
-	{
-		free(B->ct_AND[i][0]);
-		free(B->ct_AND[i][1]);
-		free(B->ct_AND[i]);
-    free(B->Alice_keys[i]);
-	}
-  free(B->Alice_keys[PARAM_L]);
-  free(B->trans_table[0]);
-  free(B->trans_table[1]);
   free(B->rho);
   free(B->ct_gamma);
   free(B->ct_Alice);
@@ -108,222 +96,426 @@ void cmp_Bob_clear(Bob_struct * B) {
 }
 
 /**
-  * \fn void cmp_Alice_set_keys(uint8_t ** Alice_input_keys, mpz_t ** kA, mpz_t gamma)
+  * \fn void cmp_Alice_set_keys(uint8_t * Alice_input_keys, const block * kA, block offset, mpz_t gamma)
   * \brief This function extracts the keys Alice sent to Bob
 
-  * \param[out] Alice_input_keys  bytes double array representing Alice's input keys
+  * \param[out] Alice_input_keys  bytes array representing Alice's input keys, PARAM_L+1 labels
 
-  * \param[in] kA                 mpz_t double array representing Alice's keys
+  * \param[in] kA                 block array representing the labels of value 0 of Alice's wires
+  * \param[in] offset             block representing the offset used in freeXOR optimization
   * \param[in] gamma              mpz_t representing Alice's news input
 */
-void cmp_Alice_set_keys(uint8_t ** Alice_input_keys, mpz_t ** kA, mpz_t gamma) {
-  for (int i=0;i<PARAM_L+1;i++) mpz_export(Alice_input_keys[i],NULL,-1,1,0,0,kA[i][mpz_tstbit(gamma,i)]);
+void cmp_Alice_set_keys(uint8_t * Alice_input_keys, const block * kA, block offset, mpz_t gamma) {
+  for (int i=0;i<PARAM_L+1;i++) block_store(Alice_input_keys+i*BLOCK_BYTES,block_xor(kA[i],block_select(offset,mpz_tstbit(gamma,i))));
 }
 
 /**
-  * \fn void cmp_Alice_garbling(mpz_t ** kA, mpz_t ** kB, mpz_t * trans_table, mpz_t ** ct_AND) {
+  * \fn void cmp_Alice_garbling(block * kA, block * kB, block * trans_table, uint8_t * ct_AND, block * offset)
   * \brief This function garbles a comparison circuit
 
-  * \param[out] kA          mpz_t double array representing the Alice's keys
-  * \param[out] kB          mpz_t double array representing the Bob's keys
-  * \param[out] trans_table mpz_t array representing the translation table
-  * \param[out] ct_AND      mpz_t double array representing the AND gates ciphertexts
+  * \param[out] kA          block array representing the labels of value 0 of Alice's wires
+  * \param[out] kB          block array representing the labels of value 0 of Bob's wires
+  * \param[out] trans_table block array representing the translation table
+  * \param[out] ct_AND      bytes array representing the AND gates ciphertexts, GATE_AND_BYTES per gate
+  * \param[out] offset      block representing the offset used in freeXOR optimization
 */
-void cmp_Alice_garbling(mpz_t ** kA, mpz_t ** kB, mpz_t * trans_table, mpz_t ** ct_AND) {
+void cmp_Alice_garbling(block * kA, block * kB, block * trans_table, uint8_t * ct_AND, block * offset) {
 
-  mpz_t offset, A;
-  mpz_t ** X;
-  mpz_inits(offset, A, NULL);
-  X=calloc(3,sizeof(mpz_t*));
+  gen_offset(offset);
+  gen_labels(kA,PARAM_L+1);
+  gen_labels(kB,PARAM_L+1);
+  cmp_Alice_garbling_offset(kA,kB,trans_table,ct_AND,*offset);
+}
 
-  for (int j=0 ; j<3 ; j++) {
-    X[j]=calloc(2,sizeof(mpz_t));
-    mpz_inits(X[j][0],X[j][1],NULL);
-  }
+/**
+  * \fn void cmp_Alice_garbling_offset(const block * kA, const block * kB, block * trans_table, uint8_t * ct_AND, block offset)
+  * \brief This function garbles the comparison circuit whose input keys and offset are already set
+
+  * The label of value 1 of a wire is its label of value 0 xored with offset, for Bob's wires the labels can
+  * for instance be set by a correlated OT.
+
+  * \param[out] trans_table block array representing the translation table
+  * \param[out] ct_AND      bytes array representing the AND gates ciphertexts, GATE_AND_BYTES per gate
 
-  //Offset generation
-  gen_alea(offset,rand());
-  if(mpz_odd_p(offset)==0) mpz_add_ui(offset,offset,1); //Set the offset as odd change the signal bit when xoring with it
+  * \param[in] kA          block array representing the labels of value 0 of Alice's wires
+  * \param[in] kB          block array representing the labels of value 0 of Bob's wires
+  * \param[in] offset      block representing the offset used in freeXOR optimization
+*/
+void cmp_Alice_garbling_offset(const block * kA, const block * kB, block * trans_table, uint8_t * ct_AND, block offset) {
 
-  //Inputs key generation
-  gen_input_key(kA,kB,offset,rand()); //IDEE : utiliser CPU cycles
+  block in[2*(PARAM_L+1)];
 
   //Translation table computation
-  mpz_set_ui(X[0][0],0);
-  for (int i=0 ; i<PARAM_L ; i++) {
-    gate_xor_garb(X[1],kA[i][0],X[0][0],offset);
-    gate_xor_garb(X[2],kB[i][0],X[0][0],offset);
-    gate_and_garb(A,ct_AND[i],X[1],X[2],offset);
-    if (PARAM_INEQ % 4 > 1) gate_xor_garb(X[0],A,kB[i][0],offset);
-    if (PARAM_INEQ % 4 < 2) gate_xor_garb(X[0],A,kA[i][0],offset);
-    }
-  gate_xor_garb(X[1],kB[PARAM_L][0],X[0][0],offset);
-  gate_xor_garb(trans_table,kA[PARAM_L][0],X[1][0],offset);
-  H(trans_table[0],trans_table[0]);
-  H(trans_table[1],trans_table[1]);
-  //memory release
-  for (int j=0 ; j<3 ; j++) {
-    mpz_clears(X[j][0],X[j][1],NULL);
-    free(X[j]);
-  }
-  mpz_clears(offset, A, NULL);
-  free(X);
+  pthread_once(&cmp_once,cmp_circuit_setup);
+  memcpy(in,kA,(PARAM_L+1)*sizeof(block));
+  memcpy(in+PARAM_L+1,kB,(PARAM_L+1)*sizeof(block));
+  circuit_garble(cmp_circuit,in,trans_table,ct_AND,offset);
+  trans_table[1]=block_xor(trans_table[0],offset);
+  // The output wire is hashed with the tweak following the ones of the PARAM_L AND gates
+  uint64_t tweaks[2]={GATE_AND_TWEAKS*PARAM_L,GATE_AND_TWEAKS*PARAM_L};
+  H_batch(trans_table,trans_table,tweaks,2);
 }
 
 /**
-  * \fn int cmp_Bob_eval(mpz_t * Alice_input_keys, mpz_t * Bob_input_keys, mpz_t ** ct_AND, mpz_t * trans_table)
+  * \fn int cmp_Bob_eval(const block * Alice_input_keys, const block * Bob_input_keys, const uint8_t * ct_AND, const block * trans_table)
   * \brief This function evaluates a comparison garbled circuit
 
-  * \param[in] Alice_input_keys   mpz_t array representing Alice's inputs keys
-  * \param[in] Bob_input_keys     mpz_t array representing Bob's input keys
-  * \param[in] ct_AND             mpz_t double array representing the AND gates ciphertexts
-  * \param[in] trans_table        mpz_t array representing the translation table
+  * \param[in] Alice_input_keys   block array representing Alice's inputs keys
+  * \param[in] Bob_input_keys     block array representing Bob's input keys
+  * \param[in] ct_AND             bytes array representing the AND gates ciphertexts, GATE_AND_BYTES per gate
+  * \param[in] trans_table        block array representing the translation table
 
   * \return 0 if the outputted key matches the key associated to 0 in the translation table
   * \return 1 if the outputted key matches the key associated to 1 in the translation table
   * \return -1 if the key does not match any key.
 */
-int cmp_Bob_eval(mpz_t * Alice_input_keys, mpz_t * Bob_input_keys, mpz_t ** ct_AND, mpz_t * trans_table) {
-  mpz_t temp, output;
-  mpz_inits(temp, output, NULL);
-  mpz_set_ui(output,0);
-
-  for (int i=0 ; i<PARAM_L ; i++) {
-    gate_xor_eval(temp,Alice_input_keys[i],output);
-    gate_xor_eval(output,Bob_input_keys[i],output);
-    gate_and_eval(output,temp,output,ct_AND[i]);
-    if (PARAM_INEQ % 4 > 1) gate_xor_eval(output,output,Bob_input_keys[i]);
-    if (PARAM_INEQ % 4 < 2) gate_xor_eval(output,output,Alice_input_keys[i]);
-   }
-  gate_xor_eval(output,output,Bob_input_keys[PARAM_L]);
-	gate_xor_eval(output,output,Alice_input_keys[PARAM_L]);
-  H(output,output);
-  if (mpz_cmp(output,trans_table[0])==0) {
-    mpz_clears(temp, output, NULL);
-    return 0;
-  } else {
-    if (mpz_cmp(output,trans_table[1])==0) {
-      mpz_clears(temp, output, NULL);
-      return 1;
-    }
-  }
-  mpz_clears(temp, output, NULL);
+int cmp_Bob_eval(const block * Alice_input_keys, const block * Bob_input_keys, const uint8_t * ct_AND, const block * trans_table) {
+
+  block in[2*(PARAM_L+1)], output;
+
+  pthread_once(&cmp_once,cmp_circuit_setup);
+  memcpy(in,Alice_input_keys,(PARAM_L+1)*sizeof(block));
+  memcpy(in+PARAM_L+1,Bob_input_keys,(PARAM_L+1)*sizeof(block));
+  circuit_eval(cmp_circuit,in,&output,ct_AND);
+  output=H_tweak(output,GATE_AND_TWEAKS*PARAM_L);
+
+  if (block_equal(output,trans_table[0])) return 0;
+  if (block_equal(output,trans_table[1])) return 1;
   return -1;
 }
 
 /**
-  * \fn void gate_and_garb(mpz_t  A_out, mpz_t* ct_AND, mpz_t* A1, mpz_t* A2,mpz_t offset)
-  * \brief This function garbles an AND gate
+  * \fn void gate_and_garb(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate)
+  * \brief This function garbles an AND gate with the scheme selected by PARAM_THREE_HALVES
 
-  * \param[out] A_out   mpz_t  representing the output key
-  * \param[out] ct_AND  mpz_t double array representing the AND gates ciphertexts
+  * \param[out] A_out   block representing the output key of value 0
+  * \param[out] ct_AND  bytes array of GATE_AND_BYTES representing the AND gate ciphertexts
 
-  * \param[in] A1       mpz_t double array representing the Alice's input keys
-  * \param[in] A2       mpz_t double array representing the Bob's input keys
-  * \param[in] offset   mpz_t representing the offset value for FreeXOR
+  * \param[in] A1       block array representing the keys of the first input
+  * \param[in] A2       block array representing the keys of the second input
+  * \param[in] offset   block representing the offset value for FreeXOR
+  * \param[in] gate     uint64_t representing the index of the AND gate in the circuit
 */
-void gate_and_garb(mpz_t  A_out, mpz_t* ct_AND, mpz_t* A1, mpz_t* A2,mpz_t offset) {
+void gate_and_garb(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate) {
+  if (PARAM_THREE_HALVES) gate_and_garb_three_halves(A_out,ct_AND,A1,A2,offset,gate);
+  else gate_and_garb_half_gates(A_out,ct_AND,A1,A2,offset,gate);
+}
 
-  mpz_t kC_E,kC_G;
-  mpz_t * hash_A1=calloc(2,sizeof(mpz_t)),* hash_A2=calloc(2,sizeof(mpz_t));
-  for (int i=0;i<2;i++)  mpz_inits(hash_A1[i],hash_A2[i],NULL) ;
+/**
+  * \fn void gate_and_garb_half_gates(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate)
+  * \brief This function garbles an AND gate with half-gates, the keys of its two inputs are hashed with the tweaks 2 gate and 2 gate+1
 
-  mpz_inits(kC_E,kC_G,NULL);
+  * \param[out] A_out   block representing the output key of value 0
+  * \param[out] ct_AND  bytes array of GATE_HALF_GATES_BYTES representing the 2 AND gate ciphertexts
 
-  int pa=mpz_tstbit(A1[0],0),pb=mpz_tstbit(A2[0],0); //Values corresponding to signal bits
-  H(hash_A1[0],A1[0]);
-  H(hash_A1[1],A1[1]);
-  H(hash_A2[0],A2[0]);
-  H(hash_A2[1],A2[1]);
+  * \param[in] A1       block array representing the keys of the first input
+  * \param[in] A2       block array representing the keys of the second input
+  * \param[in] offset   block representing the offset value for FreeXOR
+  * \param[in] gate     uint64_t representing the index of the AND gate in the circuit
+*/
+void gate_and_garb_half_gates(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate) {
 
+  block kC_E, kC_G, ct[2];
+  int pa=block_lsb(A1[0]),pb=block_lsb(A2[0]); //Values corresponding to signal bits
+  //The four hashes are independent, they are computed together
+  block hash[4]={A1[0],A1[1],A2[0],A2[1]};
+  uint64_t tweaks[4]={2*gate,2*gate,2*gate+1,2*gate+1};
+  H_batch(hash,hash,tweaks,4);
 
   //First Half Gate
-  mpz_xor(ct_AND[0],hash_A1[0],hash_A1[1]);
-  if (pb==1) mpz_xor(ct_AND[0], ct_AND[0], offset);
+  ct[0]=block_xor(block_xor(hash[0],hash[1]),block_select(offset,pb));
+  kC_G=block_xor(hash[0],block_select(ct[0],pa));
 
-  mpz_set(kC_G, hash_A1[0]);
-  if (pa==1) mpz_xor(kC_G, kC_G, ct_AND[0]);
+  //Second Half Gate
+  ct[1]=block_xor(block_xor(hash[2],hash[3]),A1[0]);
+  kC_E=block_xor(hash[2],block_select(block_xor(ct[1],A1[0]),pb));
 
+  //XORing gives the output key
+  *A_out=block_xor(kC_E,kC_G);
+  block_store(ct_AND,ct[0]);
+  block_store(ct_AND+BLOCK_BYTES,ct[1]);
+}
 
-  //Second Half Gate
-  mpz_xor(ct_AND[1],hash_A2[0],hash_A2[1]);
-  mpz_xor(ct_AND[1], ct_AND[1], A1[0]);
+/** product in GF(4) of elements 0, 1, w, w^2 encoded as 0, 1, 2, 3 */
+static const uint8_t gf4_mul[4][4] = {{0,0,0,0},{0,1,2,3},{0,2,3,1},{0,3,1,2}};
 
-  mpz_set(kC_E,hash_A2[0]);
-  if (pb==1) {
-    mpz_xor(kC_E,kC_E,ct_AND[1]);
-    mpz_xor(kC_E,kC_E,A1[0]);
+/**
+  * \fn static uint64_t half_load(const uint8_t * in)
+  * \brief This function reads a half label from its GATE_HALF_BYTES bytes in little endian, whatever the host order
+*/
+static uint64_t half_load(const uint8_t * in) {
+  uint64_t h=0;
+  for (int i=0 ; i<GATE_HALF_BYTES ; i++) h|=((uint64_t) in[i])<<(8*i);
+  return h;
+}
+
+/**
+  * \fn static void half_store(uint8_t * out, uint64_t h)
+  * \brief This function writes a half label as GATE_HALF_BYTES bytes in little endian, whatever the host order
+*/
+static void half_store(uint8_t * out, uint64_t h) {
+  for (int i=0 ; i<GATE_HALF_BYTES ; i++) out[i]=(uint8_t) (h>>(8*i));
+}
+
+/**
+  * \fn static void halves_get(uint64_t * h, block a)
+  * \brief This function splits a label into its halves h[0] = L and h[1] = R, bytes 0 to 7 and 8 to 15
+*/
+static void halves_get(uint64_t * h, block a) {
+  uint8_t bytes[BLOCK_BYTES];
+  block_store(bytes,a);
+  h[0]=half_load(bytes);
+  h[1]=half_load(bytes+GATE_HALF_BYTES);
+}
+
+/**
+  * \fn static block halves_set(const uint64_t * h)
+  * \brief This function joins the halves h[0] = L and h[1] = R into a label
+*/
+static block halves_set(const uint64_t * h) {
+  uint8_t bytes[BLOCK_BYTES];
+  half_store(bytes,h[0]);
+  half_store(bytes+GATE_HALF_BYTES,h[1]);
+  return block_load(bytes);
+}
+
+/**
+  * \fn static void halves_mul_xor(uint64_t * out, int e, const uint64_t * x)
+  * \brief This function adds to out the halves x multiplied by the element e of GF(4), w (L, R) = (R, L ^ R)
+*/
+static void halves_mul_xor(uint64_t * out, int e, const uint64_t * x) {
+  if (e&1) {
+    out[0]^=x[0];
+    out[1]^=x[1];
+  }
+  if (e&2) {
+    out[0]^=x[1];
+    out[1]^=x[0]^x[1];
   }
+}
 
-  //XORing gives the output key
-  mpz_xor(A_out,kC_E,kC_G);
+/**
+  * \fn static int three_halves_mask(block hA, block hB, block hX, int row)
+  * \brief This function computes the 4 bits encrypting the matrices (K, K') of the row 2a+b from its 3 hashes
+*/
+static int three_halves_mask(block hA, block hB, block hX, int row) {
+  uint8_t bytes[BLOCK_BYTES];
+  block_store(bytes,block_xor(block_xor(hA,hB),hX));
+  return (bytes[GATE_HALF_BYTES+row/2]>>(4*(row%2))) & 15;
+}
 
-  mpz_clears(kC_G,kC_E,hash_A1[0], hash_A1[1], hash_A2[0], hash_A2[1] ,NULL);
-  free(hash_A1);
-  free(hash_A2);
+/**
+  * \fn static void three_halves_pads(uint64_t * out, block hA, block hB, block hX)
+  * \brief This function computes the pads [H(A) ^ H(X), H(B) ^ H(X)] of a row from the low halves of its 3 hashes
+*/
+static void three_halves_pads(uint64_t * out, block hA, block hB, block hX) {
+  uint64_t t[2];
+  halves_get(out,block_xor(hA,hX));
+  halves_get(t,block_xor(hB,hX));
+  out[1]=t[0];
 }
 
 /**
-  * \fn void gate_xor_garb(mpz_t* X_out, mpz_t X1, mpz_t X2, mpz_t offset)
+  * \fn static void three_halves_select(uint64_t * out, const uint8_t * ct_AND, int row)
+  * \brief This function adds to out the combination R_row G of the 3 half ciphertexts selected by the row 2a+b
+
+  * R_00 G = 0, R_01 G = (G2, G1 ^ G2), R_10 G = (G0 ^ G2, G2) and R_11 G = (G0, G1).
+*/
+static void three_halves_select(uint64_t * out, const uint8_t * ct_AND, int row) {
+  uint64_t G[3]={half_load(ct_AND),half_load(ct_AND+GATE_HALF_BYTES),half_load(ct_AND+2*GATE_HALF_BYTES)};
+  if (row==1) {
+    out[0]^=G[2];
+    out[1]^=G[1]^G[2];
+  }
+  if (row==2) {
+    out[0]^=G[0]^G[2];
+    out[1]^=G[2];
+  }
+  if (row==3) {
+    out[0]^=G[0];
+    out[1]^=G[1];
+  }
+}
+
+/**
+  * \fn void gate_and_garb_three_halves(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate)
+  * \brief This function garbles an AND gate with three halves, A, B and A ^ B are hashed with the tweaks 3 gate, 3 gate+1 and 3 gate+2
+
+  * The labels are indexed by their color bit, and the garbler solves for each row (a, b) the equation of the
+  * evaluator, C ^ xy offset = [H(A_a) ^ H(X), H(B_b) ^ H(X)] ^ R_ab G ^ K_ab A_a ^ K'_ab B_b with X = A_a ^ B_b
+  * and (x, y) the values of the row. The row (0, 0) gives C, the rows (1, 1) and (0, 1) give G, the row (1, 0)
+  * is then satisfied by the choice of the matrices, whose free parameters are the ones (K_00, K'_00) of the row
+  * (0, 0).
+
+  * \param[out] A_out   block representing the output key of value 0
+  * \param[out] ct_AND  bytes array of GATE_THREE_HALVES_BYTES representing the 3 half ciphertexts and the control bits
+
+  * \param[in] A1       block array representing the keys of the first input
+  * \param[in] A2       block array representing the keys of the second input
+  * \param[in] offset   block representing the offset value for FreeXOR
+  * \param[in] gate     uint64_t representing the index of the AND gate in the circuit
+*/
+void gate_and_garb_three_halves(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate) {
+
+  int pa=block_lsb(A1[0]),pb=block_lsb(A2[0]); //Values of the labels of color 0
+  int a, b, m, K[4], Kp[4], alpha, eps, epsp;
+  uint64_t A[2][2], B[2][2], D[2], W[4][2];
+  //The labels of color 0 and 1 of both inputs, and the six hashes A_0, A_1, B_0, B_1, X_0, X_1 computed together
+  block hash[6]={A1[pa],A1[1-pa],A2[pb],A2[1-pb],block_xor(A1[pa],A2[pb]),block_xor(block_xor(A1[pa],A2[pb]),offset)};
+  uint64_t tweaks[6]={3*gate,3*gate,3*gate+1,3*gate+1,3*gate+2,3*gate+2};
+
+  for (int i=0 ; i<2 ; i++) {
+    halves_get(A[i],hash[i]);
+    halves_get(B[i],hash[2+i]);
+  }
+  halves_get(D,offset);
+  H_batch(hash,hash,tweaks,6);
+
+  //Matrices of the rows, (K_00, K'_00) is the mask of the row (0, 0), the others follow
+  m=three_halves_mask(hash[0],hash[2],hash[4],0);
+  K[0]=m&3;
+  Kp[0]=m>>2;
+  alpha=K[0]^3^(pa ? 2 : 0)^pb^gf4_mul[Kp[0]][2];
+  eps=alpha^(pb ? 2 : 0)^gf4_mul[K[0]][2];
+  epsp=alpha^pa^Kp[0];
+  K[1]=K[0]^eps;
+  Kp[1]=Kp[0]^epsp;
+  K[2]=K[0]^gf4_mul[eps][3];
+  Kp[2]=Kp[0]^gf4_mul[epsp][3];
+  K[3]=K[0]^gf4_mul[eps][2];
+  Kp[3]=Kp[0]^gf4_mul[epsp][2];
+
+  //The row (0, 0) gives the output key C = W_00, the other rows what they miss W_ab = R_ab G
+  for (int row=0 ; row<4 ; row++) {
+    a=row>>1;
+    b=row&1;
+    three_halves_pads(W[row],hash[a],hash[2+b],hash[4+(a^b)]);
+    halves_mul_xor(W[row],K[row],A[a]);
+    halves_mul_xor(W[row],Kp[row],B[b]);
+    if ((a^pa)&(b^pb)) {
+      W[row][0]^=D[0];
+      W[row][1]^=D[1];
+    }
+    if (row>0) {
+      W[row][0]^=W[0][0];
+      W[row][1]^=W[0][1];
+    }
+  }
+  *A_out=halves_set(W[0]);
+
+  half_store(ct_AND,W[3][0]);
+  half_store(ct_AND+GATE_HALF_BYTES,W[3][1]);
+  half_store(ct_AND+2*GATE_HALF_BYTES,W[1][0]);
+  //Control nibbles of the rows (0, 1), (1, 0) and (1, 1)
+  ct_AND[3*GATE_HALF_BYTES]=0;
+  ct_AND[3*GATE_HALF_BYTES+1]=0;
+  for (int row=1 ; row<4 ; row++) {
+    a=row>>1;
+    b=row&1;
+    m=three_halves_mask(hash[a],hash[2+b],hash[4+(a^b)],row);
+    ct_AND[3*GATE_HALF_BYTES+(row-1)/2]|=((K[row]|Kp[row]<<2)^m)<<(4*((row-1)%2));
+  }
+}
+
+/**
+  * \fn void gate_xor_garb(block * X_out, block X1, block X2, block offset)
   * \brief This function garbles an XOR gate
 
-  * \param[out] X_out   mpz_t array representing the garbled XOR gates
-  * \param[in]  X1       mpz_t representing the first input to the gate
-  * \param[in]  X2       mpz_t representing the second input to the gate
-  * \param[in]  offset   mpz_t representing the offset value for FreeXOR
+  * \param[out] X_out   block array representing the 2 keys of the output
+  * \param[in]  X1       block representing the first input to the gate
+  * \param[in]  X2       block representing the second input to the gate
+  * \param[in]  offset   block representing the offset value for FreeXOR
 */
-void gate_xor_garb(mpz_t* X_out, mpz_t X1, mpz_t X2, mpz_t offset) {
-  mpz_xor(X_out[0],X1,X2);
-  mpz_xor(X_out[1],X_out[0],offset);
+void gate_xor_garb(block * X_out, block X1, block X2, block offset) {
+  X_out[0]=block_xor(X1,X2);
+  X_out[1]=block_xor(X_out[0],offset);
 }
 
 /**
-  * \fn void gate_and_eval(mpz_t A_out, mpz_t A1, mpz_t A2, mpz_t * AND_ct)
-  * \brief This function evaluates an AND gate
+  * \fn void gate_and_eval(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate)
+  * \brief This function evaluates an AND gate with the scheme selected by PARAM_THREE_HALVES
 
-  * \param[out] A_out   mpz_t representing the garbled AND gate
+  * \param[out] A_out   block representing the output key
 
-  * \param[in]  A1      mpz_t representing the first input to the gate
-  * \param[in]  A2      mpz_t representing the second input to the gate
-  * \param[in]  AND_ct  mpz_t array representing the gate ciphertexts
+  * \param[in]  A1      block representing the first input to the gate
+  * \param[in]  A2      block representing the second input to the gate
+  * \param[in]  ct_AND  bytes array of GATE_AND_BYTES representing the gate ciphertexts
+  * \param[in]  gate    uint64_t representing the index of the AND gate in the circuit
 */
-void gate_and_eval(mpz_t A_out, mpz_t A1, mpz_t A2, mpz_t * AND_ct) {
+void gate_and_eval(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate) {
+  if (PARAM_THREE_HALVES) gate_and_eval_three_halves(A_out,A1,A2,ct_AND,gate);
+  else gate_and_eval_half_gates(A_out,A1,A2,ct_AND,gate);
+}
 
-	mpz_t hash_A1, hash_A2, kG, kE; //kG is the garbler ciphertext while kE is the Evaluator's one
-	mpz_inits(hash_A1, hash_A2, kG, kE,NULL);
+/**
+  * \fn void gate_and_eval_half_gates(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate)
+  * \brief This function evaluates an AND gate garbled with half-gates, with the tweaks of gate_and_garb_half_gates
 
- // We compute the least significant bit of each input
-	int sa=mpz_tstbit(A1,0), sb=mpz_tstbit(A2,0);
+  * \param[out] A_out   block representing the output key
 
-	//First half gate evaluation
- 	H(hash_A1,A1);
- 	H(hash_A2,A2);
+  * \param[in]  A1      block representing the first input to the gate
+  * \param[in]  A2      block representing the second input to the gate
+  * \param[in]  ct_AND  bytes array of GATE_HALF_GATES_BYTES representing the 2 gate ciphertexts
+  * \param[in]  gate    uint64_t representing the index of the AND gate in the circuit
+*/
+void gate_and_eval_half_gates(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate) {
 
- 	mpz_set(kG,hash_A1);
- 	if (sa==1) mpz_xor(kG,kG,AND_ct[0]);
+  block kG, kE; //kG is the garbler half gate while kE is the Evaluator's one
+  block ct[2]={block_load(ct_AND),block_load(ct_AND+BLOCK_BYTES)};
+  block hash[2]={A1,A2};
+  uint64_t tweaks[2]={2*gate,2*gate+1};
+  H_batch(hash,hash,tweaks,2);
 
-	//Second half gate evaluation
-  mpz_set(kE,hash_A2);
-  if (sb==1) {
- 	 mpz_xor(kE,kE,AND_ct[1]);
- 	 mpz_xor(kE, kE ,A1);
-  }
+  //First half gate evaluation, selected by the signal bit of each input
+  kG=block_xor(hash[0],block_select(ct[0],block_lsb(A1)));
 
-	//XOR the two halves to make a whole
- 	mpz_xor(A_out, kG,kE);
-  mpz_clears(hash_A1, hash_A2, kG, kE,NULL);
+  //Second half gate evaluation
+  kE=block_xor(hash[1],block_select(block_xor(ct[1],A1),block_lsb(A2)));
 
+  //XOR the two halves to make a whole
+  *A_out=block_xor(kG,kE);
 }
 
 /**
-  * \fn void gate_xor_eval(mpz_t X_out, mpz_t X1, mpz_t X2)
+  * \fn void gate_and_eval_three_halves(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate)
+  * \brief This function evaluates an AND gate garbled with three halves, with the tweaks of gate_and_garb_three_halves
+
+  * \param[out] A_out   block representing the output key
+
+  * \param[in]  A1      block representing the first input to the gate
+  * \param[in]  A2      block representing the second input to the gate
+  * \param[in]  ct_AND  bytes array of GATE_THREE_HALVES_BYTES representing the 3 half ciphertexts and the control bits
+  * \param[in]  gate    uint64_t representing the index of the AND gate in the circuit
+*/
+void gate_and_eval_three_halves(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate) {
+
+  int row=2*block_lsb(A1)+block_lsb(A2), m;
+  uint64_t A[2], B[2], out[2];
+  block hash[3]={A1,A2,block_xor(A1,A2)};
+  uint64_t tweaks[3]={3*gate,3*gate+1,3*gate+2};
+  H_batch(hash,hash,tweaks,3);
+
+  //Matrices (K, K') of the row, sent encrypted except for the row (0, 0)
+  m=three_halves_mask(hash[0],hash[1],hash[2],row);
+  if (row>0) m^=(ct_AND[3*GATE_HALF_BYTES+(row-1)/2]>>(4*((row-1)%2))) & 15;
+
+  halves_get(A,A1);
+  halves_get(B,A2);
+  three_halves_pads(out,hash[0],hash[1],hash[2]);
+  three_halves_select(out,ct_AND,row);
+  halves_mul_xor(out,m&3,A);
+  halves_mul_xor(out,m>>2,B);
+  *A_out=halves_set(out);
+}
+/**
+  * \fn void gate_xor_eval(block * X_out, block X1, block X2)
   * \brief This function evaluates an XOR gate
 
-  * \param[out] X_out  mpz_t representing the outputted key
+  * \param[out] X_out  block representing the outputted key
 
-  * \param[in]  X1     mpz_t representing the first input to the gate
-  * \param[in]  X2     mpz_t representing the second input to the gate
+  * \param[in]  X1     block representing the first input to the gate
+  * \param[in]  X2     block representing the second input to the gate
 */
-void gate_xor_eval(mpz_t X_out, mpz_t X1, mpz_t X2) {
-  mpz_xor(X_out, X1, X2);
+void gate_xor_eval(block * X_out, block X1, block X2) {
+  *X_out=block_xor(X1,X2);
 }
@@ -12,6 +12,18 @@
 #include "gmp.h"
 #include <openssl/sha.h>
 
+#define GATE_HALF_BYTES (BLOCK_BYTES/2) /**< size of a half label */
+#define GATE_HALF_GATES_BYTES (2*BLOCK_BYTES) /**< size of the ciphertexts of an AND gate garbled with half-gates */
+#define GATE_THREE_HALVES_BYTES (3*GATE_HALF_BYTES+2) /**< size of the ciphertexts of an AND gate garbled with three halves, 3 half labels and 3 control nibbles */
+
+#if PARAM_THREE_HALVES
+#define GATE_AND_BYTES GATE_THREE_HALVES_BYTES /**< size of the ciphertexts of an AND gate */
+#define GATE_AND_TWEAKS 3 /**< number of hash tweaks used by an AND gate */
+#else
+#define GATE_AND_BYTES GATE_HALF_GATES_BYTES /**< size of the ciphertexts of an AND gate */
+#define GATE_AND_TWEAKS 2 /**< number of hash tweaks used by an AND gate */
+#endif
+
 /**
   * \typedef Alice_struct
   * \brief Structure for Alice's variables
@@ -19,9 +31,9 @@
 typedef struct Alice_struct {
   uint8_t * ct_Alice ; /**< Alice's input ciphertext */
   uint8_t * ct_gamma ; /**< Alice's new input ciphertext */
-  uint8_t ** Alice_keys ; /**< Alice's input keys */
-  uint8_t ** trans_table ; /**< XOR gates keys*/
-  uint8_t *** ct_AND ; /**< AND gates ciphertexts */
+  uint8_t * Alice_keys ; /**< Alice's input keys, PARAM_L+1 labels of BLOCK_BYTES bytes */
+  uint8_t * trans_table ; /**< Translation table, 2 labels */
+  uint8_t * ct_AND ; /**< AND gates ciphertexts, GATE_AND_BYTES per gate */
 } Alice_struct ;
 
 /**
@@ -32,9 +44,9 @@ typedef struct Bob_struct {
 	uint8_t * rho ; /**< Bob's new input */
   uint8_t * ct_Alice ; /**< Alice'es input ciphertext */
 	uint8_t * ct_gamma ; /**< Alice's new input ciphertext */
-  uint8_t ** Alice_keys ;  /**< Alice's input keys */
-  uint8_t ** trans_table ; /**< Translation table (generated by Alice) */
-  uint8_t *** ct_AND ; /**< AND gates ciphertexts */
+  uint8_t * Alice_keys ;  /**< Alice's input keys, PARAM_L+1 labels of BLOCK_BYTES bytes */
+  uint8_t * trans_table ; /**< Translation table (generated by Alice), 2 labels */
+  uint8_t * ct_AND ; /**< AND gates ciphertexts, GATE_AND_BYTES per gate */
 } Bob_struct ;
 
 
@@ -42,14 +54,19 @@ typedef struct Bob_struct {
 
 
 
-void gate_and_garb(mpz_t  A_out, mpz_t* ct_AND, mpz_t* A1, mpz_t* A2,mpz_t offset);
-void gate_xor_garb(mpz_t* X_out, mpz_t X1, mpz_t X2, mpz_t offset);
-void gate_and_eval(mpz_t A_out, mpz_t A1, mpz_t A2, mpz_t * AND_ct);
-void gate_xor_eval(mpz_t X_out, mpz_t X1, mpz_t X2);
+void gate_and_garb(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate);
+void gate_and_garb_half_gates(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate);
+void gate_and_garb_three_halves(block * A_out, uint8_t * ct_AND, const block * A1, const block * A2, block offset, uint64_t gate);
+void gate_xor_garb(block * X_out, block X1, block X2, block offset);
+void gate_and_eval(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate);
+void gate_and_eval_half_gates(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate);
+void gate_and_eval_three_halves(block * A_out, block A1, block A2, const uint8_t * ct_AND, uint64_t gate);
+void gate_xor_eval(block * X_out, block X1, block X2);
 
-void cmp_Alice_set_keys(uint8_t ** Alice_input_keys, mpz_t ** kA, mpz_t gamma);
-void cmp_Alice_garbling(mpz_t ** kA, mpz_t ** kB, mpz_t * trans_table, mpz_t ** ct_AND);
-int cmp_Bob_eval(mpz_t * Alice_input_keys, mpz_t * Bob_input_keys, mpz_t ** ct_AND, mpz_t * trans_table);
+void cmp_Alice_set_keys(uint8_t * Alice_input_keys, const block * kA, block offset, mpz_t gamma);
+void cmp_Alice_garbling(block * kA, block * kB, block * trans_table, uint8_t * ct_AND, block * offset);
+void cmp_Alice_garbling_offset(const block * kA, const block * kB, block * trans_table, uint8_t * ct_AND, block offset);
+int cmp_Bob_eval(const block * Alice_input_keys, const block * Bob_input_keys, const uint8_t * ct_AND, const block * trans_table);
 Alice_struct * cmp_Alice_init();
 void cmp_Alice_clear(Alice_struct * A);
 Bob_struct * cmp_Bob_init();
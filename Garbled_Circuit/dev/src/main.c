@@ -1,12 +1,14 @@
 #include "parameters.h"
 #include "cmp_steps.h"
 #include "paillier.h"
+#include "paillier_pool.h"
+#include "paillier_key.h"
 #include "time.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-int main(){
+int main(int argc, char ** argv){
 
   //Initialization of the variables
   int result;
@@ -17,25 +19,47 @@ int main(){
   Bob_struct * Bob=cmp_Bob_init();
   OT_receiver * Bob_OT = OT_receiver_init();
 
+  //Keys written by bin/keygen are used if given, the compiled-in key otherwise
+  paillier_ctx * Alice_paillier = paillier_ctx_init();
+  paillier_ctx * Bob_paillier = paillier_ctx_init();
+  if (argc==3) {
+    if (paillier_key_load(Alice_paillier, argv[1]) || paillier_key_load(Bob_paillier, argv[2]) || mpz_sizeinbase(Alice_paillier->n,2)>PAILLIER_MAX_KEY_SIZE) {
+      printf("Error : the key files can not be read\n");
+      return 1;
+    }
+  }
+  else {
+    paillier_ctx_set_str(Alice_paillier, PAILLIER_PK_N, PAILLIER_SK_P, PAILLIER_SK_Q, 16);
+    paillier_ctx_set_str(Bob_paillier, PAILLIER_PK_N, NULL, NULL, 16);
+  }
+  paillier_set_mode(Bob_paillier, PAILLIER_ENC_MODE);
+  paillier_pool_start(Bob_paillier, PAILLIER_POOL_DEPTH, PAILLIER_POOL_LOW_WATER);
+
   uint8_t Alice_input[bits_to_bytes(PARAM_L)], Bob_input[bits_to_bytes(PARAM_L)];
   random_bytes_pairs(Alice_input,Bob_input,bits_to_bytes(PARAM_L));
 
-  cmp_Alice_step1(Alice , Alice_OT, Alice_input);
+  cmp_Alice_step1(Alice , Alice_OT, Alice_input, Alice_paillier);
    //This corresponds to the first network exchange (Alice -> Bob)
-  for (int i=0 ; i < PAILLIER_KEY_SIZE/4 ; ++i) Bob->ct_Alice[i]=Alice->ct_Alice[i];
+  for (int i=0 ; i < PAILLIER_MAX_KEY_SIZE/4 ; ++i) Bob->ct_Alice[i]=Alice->ct_Alice[i];
   for (int i=0 ; i<32 ; ++i) Bob_OT->rec_enc_S[i]=Alice_OT->sen_enc_S[i];
 
-  cmp_Bob_step2(Bob , Bob_OT, Bob_input);
+  if (cmp_Bob_step2(Bob , Bob_OT, Bob_input, Bob_paillier)) {
+    printf("Error : Bob can not choose the OTs\n");
+    return 1;
+  }
   //This corresponds to the second network exchange (Bob -> Alice)
-  for (int i=0 ; i < PAILLIER_KEY_SIZE/4 ; ++i) Alice->ct_gamma[i]=Bob->ct_gamma[i];
+  for (int i=0 ; i < PAILLIER_MAX_KEY_SIZE/4 ; ++i) Alice->ct_gamma[i]=Bob->ct_gamma[i];
   for (int i=0 ; i < 32*(PARAM_L+1) ; ++i) Alice_OT->sen_enc_R[i/32][i%32]=Bob_OT->rec_enc_R[i/32][i%32];
 
-  cmp_Alice_step3(Alice , Alice_OT);
+  if (cmp_Alice_step3(Alice , Alice_OT, Alice_paillier)) {
+    printf("Error : Alice can not run the OTs\n");
+    return 1;
+  }
   //This corresponds to the third network exchange (Alice -> Bob)
-  for (int i=0 ; i<2*32 ; ++i) Bob->trans_table[i/32][i%32]=Alice->trans_table[i/32][i%32];
-  for (int i=0 ; i<2*(PARAM_L+1) ; ++i) for (int j=0 ; j<32 ; ++j) Bob_OT->rec_keys[i/2][i%2][j]=Alice_OT->sen_keys[i/2][i%2][j];
-  for (int i=0 ; i<32*(PARAM_L+1) ; ++i) Bob->Alice_keys[i/32][i%32]=Alice->Alice_keys[i/32][i%32];
-  for (int i=0 ; i<2*PARAM_L ; ++i) for (int j=0 ; j<32 ; ++j) Bob->ct_AND[i/2][i%2][j]=Alice->ct_AND[i/2][i%2][j];
+  memcpy(Bob->trans_table, Alice->trans_table, 2*BLOCK_BYTES);
+  for (int i=0 ; i<PARAM_L+1 ; ++i) for (int b=0 ; b<2 ; ++b) for (uint32_t j=0 ; j<bits_to_bytes(KEY_SIZE) ; ++j) Bob_OT->rec_keys[i][b][j]=Alice_OT->sen_keys[i][b][j];
+  memcpy(Bob->Alice_keys, Alice->Alice_keys, (PARAM_L+1)*BLOCK_BYTES);
+  memcpy(Bob->ct_AND, Alice->ct_AND, PARAM_L*GATE_AND_BYTES);
 
   result = cmp_Bob_step4(Bob ,  Bob_OT);
 
@@ -45,4 +69,6 @@ int main(){
   cmp_Bob_clear(Bob);
   OT_receiver_clear(Bob_OT);
   OT_sender_clear(Alice_OT);
+  paillier_ctx_clear(Alice_paillier);
+  paillier_ctx_clear(Bob_paillier);
 }
@@ -0,0 +1,152 @@
+#include "parameters.h"
+#include "cmp_steps.h"
+#include "paillier.h"
+#include "paillier_pool.h"
+#include "time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+  * \fn int ot_ext_session_setup(OT_ext_sender * Alice_ext, OT_ext_receiver * Bob_ext)
+  * \brief This function runs the OT_EXT_KAPPA base OTs of an extension session, Bob being their sender
+
+  * \return 0 if the base OTs succeed
+*/
+int ot_ext_session_setup(OT_ext_sender * Alice_ext, OT_ext_receiver * Bob_ext) {
+
+  if (OT_ext_receiver_base_setup(Bob_ext)) return 1;
+  //Base OTs, first network exchange (Bob -> Alice)
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) for (int i=0 ; i<32 ; ++i) Alice_ext->base[c]->rec_enc_S[i]=Bob_ext->base[c]->sen_enc_S[i];
+
+  if (OT_ext_sender_base_choose(Alice_ext)) return 1;
+  //Base OTs, second network exchange (Alice -> Bob)
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) for (int i=0 ; i < 32*(PARAM_L+1) ; ++i) Bob_ext->base[c]->sen_enc_R[i/32][i%32]=Alice_ext->base[c]->rec_enc_R[i/32][i%32];
+
+  if (OT_ext_receiver_base_transfer(Bob_ext)) return 1;
+  //Base OTs, third network exchange (Bob -> Alice)
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) for (int i=0 ; i<2*(PARAM_L+1) ; ++i) for (uint32_t j=0 ; j<bits_to_bytes(KEY_SIZE) ; ++j) Alice_ext->base[c]->rec_keys[i/2][i%2][j]=Bob_ext->base[c]->sen_keys[i/2][i%2][j];
+
+  return OT_ext_sender_base_retrieve(Alice_ext);
+}
+
+int main(){
+
+  //Initialization of the variables
+  int result;
+  int nb=PARAM_SLOTS;
+
+  Alice_struct ** Alice=calloc(nb,sizeof(Alice_struct *));
+  OT_sender ** Alice_OT=calloc(nb,sizeof(OT_sender *));
+  Bob_struct ** Bob=calloc(nb,sizeof(Bob_struct *));
+  OT_receiver ** Bob_OT=calloc(nb,sizeof(OT_receiver *));
+  uint8_t ** Alice_inputs=calloc(nb,sizeof(uint8_t *));
+  uint8_t ** Bob_inputs=calloc(nb,sizeof(uint8_t *));
+
+  for (int k=0 ; k<nb ; k++) {
+    Alice[k]=cmp_Alice_init();
+    Alice_OT[k]=OT_sender_init();
+    Bob[k]=cmp_Bob_init();
+    Bob_OT[k]=OT_receiver_init();
+    Alice_inputs[k]=calloc(bits_to_bytes(PARAM_L),sizeof(uint8_t));
+    Bob_inputs[k]=calloc(bits_to_bytes(PARAM_L),sizeof(uint8_t));
+    random_bytes_pairs(Alice_inputs[k],Bob_inputs[k],bits_to_bytes(PARAM_L));
+  }
+
+  uint8_t ct_Alice[PAILLIER_MAX_KEY_SIZE/4], ct_gamma[PAILLIER_MAX_KEY_SIZE/4];
+
+  paillier_ctx * Alice_paillier = paillier_ctx_init();
+  paillier_ctx_set_str(Alice_paillier, PAILLIER_PK_N, PAILLIER_SK_P, PAILLIER_SK_Q, 16);
+  paillier_ctx * Bob_paillier = paillier_ctx_init();
+  paillier_ctx_set_str(Bob_paillier, PAILLIER_PK_N, NULL, NULL, 16);
+  paillier_set_mode(Bob_paillier, PAILLIER_ENC_MODE);
+  paillier_pool_start(Bob_paillier, PAILLIER_POOL_DEPTH, PAILLIER_POOL_LOW_WATER);
+
+  //The OTs of all the comparisons are extended from a single session of base OTs
+  OT_ext_sender * Alice_ext=NULL;
+  OT_ext_receiver * Bob_ext=NULL;
+  if (PARAM_OT_EXTENSION) {
+    Alice_ext=OT_ext_sender_init(nb*(PARAM_L+1));
+    Bob_ext=OT_ext_receiver_init(nb*(PARAM_L+1));
+    if (ot_ext_session_setup(Alice_ext, Bob_ext)) {
+      printf("Error in the base OTs of the extension session\n");
+      return 1;
+    }
+    for (int k=0 ; k<nb ; k++) {
+      Alice_OT[k]->sen_ext=Alice_ext;
+      Bob_OT[k]->rec_ext=Bob_ext;
+    }
+  }
+  //Without extension, the base OTs of all the comparisons share the sender's (y, S, T) of a session
+  OT_sender_session * Alice_session=NULL;
+  OT_receiver_session * Bob_session=NULL;
+  if (!PARAM_OT_EXTENSION) {
+    Alice_session=OT_sender_session_init(PARAM_OT_SESSION_USES);
+    Bob_session=OT_receiver_session_init();
+    for (int k=0 ; k<nb ; k++) {
+      Alice_OT[k]->sen_session=Alice_session;
+      Bob_OT[k]->rec_session=Bob_session;
+    }
+  }
+  if (PARAM_OT_EXTENSION && PARAM_OT_PRECOMPUTE) {
+    //Offline phase, before the inputs are known : random OTs for all the comparisons (Bob -> Alice)
+    OT_ext_receiver_precompute(Bob_ext, nb*(PARAM_L+1));
+    memcpy(Alice_ext->u, Bob_ext->u, OT_ext_u_size(nb*(PARAM_L+1)));
+    OT_ext_sender_precompute(Alice_ext, nb*(PARAM_L+1));
+  }
+
+  cmp_Alice_batch_step1(Alice_OT, Alice_inputs, nb, ct_Alice, Alice_paillier);
+  //This corresponds to the first network exchange (Alice -> Bob), a single ciphertext for all the comparisons
+  if (!PARAM_OT_EXTENSION) for (int k=0 ; k<nb ; k++) for (int i=0 ; i<32 ; ++i) Bob_OT[k]->rec_enc_S[i]=Alice_OT[k]->sen_enc_S[i];
+
+  if (cmp_Bob_batch_step2(Bob, Bob_OT, Bob_inputs, nb, ct_Alice, ct_gamma, Bob_paillier)) {
+    printf("Error : Bob can not choose the OTs\n");
+    return 1;
+  }
+  //This corresponds to the second network exchange (Bob -> Alice), a single ciphertext and a single matrix U of the OT extension (or one correction bit per OT) for all the comparisons
+  if (PARAM_OT_EXTENSION && PARAM_OT_PRECOMPUTE) for (int k=0 ; k<nb ; k++) memcpy(Alice_OT[k]->sen_corrections, Bob_OT[k]->rec_corrections, bits_to_bytes(PARAM_L+1));
+  else if (PARAM_OT_EXTENSION) memcpy(Alice_ext->u, Bob_ext->u, OT_ext_u_size(nb*(PARAM_L+1)));
+  else for (int k=0 ; k<nb ; k++) for (int i=0 ; i < 32*(PARAM_L+1) ; ++i) Alice_OT[k]->sen_enc_R[i/32][i%32]=Bob_OT[k]->rec_enc_R[i/32][i%32];
+
+  if (cmp_Alice_batch_step3(Alice, Alice_OT, nb, ct_gamma, Alice_paillier)) {
+    printf("Error : Alice can not run the OTs\n");
+    return 1;
+  }
+  //This corresponds to the third network exchange (Alice -> Bob)
+  for (int k=0 ; k<nb ; k++) {
+    memcpy(Bob[k]->trans_table, Alice[k]->trans_table, 2*BLOCK_BYTES);
+    for (int i=0 ; i<PARAM_L+1 ; ++i) for (int b=0 ; b<2-(PARAM_OT_EXTENSION && PARAM_OT_CORRELATED) ; ++b) for (uint32_t j=0 ; j<bits_to_bytes(KEY_SIZE) ; ++j) Bob_OT[k]->rec_keys[i][b][j]=Alice_OT[k]->sen_keys[i][b][j];
+    memcpy(Bob[k]->Alice_keys, Alice[k]->Alice_keys, (PARAM_L+1)*BLOCK_BYTES);
+    memcpy(Bob[k]->ct_AND, Alice[k]->ct_AND, PARAM_L*GATE_AND_BYTES);
+  }
+
+  for (int k=0 ; k<nb ; k++) {
+    result = cmp_Bob_step4(Bob[k], Bob_OT[k]);
+    printf("( %d < %d ) = %d\n", Alice_inputs[k][0], Bob_inputs[k][0], result);
+  }
+
+  for (int k=0 ; k<nb ; k++) {
+    cmp_Alice_clear(Alice[k]);
+    cmp_Bob_clear(Bob[k]);
+    OT_receiver_clear(Bob_OT[k]);
+    OT_sender_clear(Alice_OT[k]);
+    free(Alice_inputs[k]);
+    free(Bob_inputs[k]);
+  }
+  if (PARAM_OT_EXTENSION) {
+    OT_ext_sender_clear(Alice_ext);
+    OT_ext_receiver_clear(Bob_ext);
+  }
+  else {
+    OT_sender_session_clear(Alice_session);
+    OT_receiver_session_clear(Bob_session);
+  }
+  free(Alice);
+  free(Alice_OT);
+  free(Bob);
+  free(Bob_OT);
+  free(Alice_inputs);
+  free(Bob_inputs);
+  paillier_ctx_clear(Alice_paillier);
+  paillier_ctx_clear(Bob_paillier);
+}
@@ -0,0 +1,30 @@
+#include "parameters.h"
+#include "paillier.h"
+#include "paillier_key.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char ** argv){
+
+  char * end = NULL;
+  long bits = argc==4 ? strtol(argv[1],&end,10) : 0;
+
+  // the modulus is the product of two primes of bits/2 bits and must fit the exchanged ciphertext buffers
+  if (argc!=4 || *argv[1]=='\0' || *end!='\0' || bits%2!=0 || bits<512 || bits>PAILLIER_MAX_KEY_SIZE) {
+    printf("Usage : %s bits secret_key_file public_key_file, bits even in [512, %d]\n",argv[0],PAILLIER_MAX_KEY_SIZE);
+    return 1;
+  }
+
+  paillier_ctx * ctx = paillier_ctx_init();
+  paillier_keygen(ctx, (int) bits);
+
+  if (paillier_key_save(ctx, argv[2], 1) || paillier_key_save(ctx, argv[3], 0)) {
+    printf("Error : the key files can not be written\n");
+    paillier_ctx_clear(ctx);
+    return 1;
+  }
+  gmp_printf("%Zx\n",ctx->n);
+
+  paillier_ctx_clear(ctx);
+  return 0;
+}
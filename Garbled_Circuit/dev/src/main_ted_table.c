@@ -0,0 +1,55 @@
+#include "parameters.h"
+#include "twisted_edwards_curves.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+  * \fn void print_fe(const fe25519 a)
+  * \brief This function prints the reduced limbs of a field element as a C initializer
+*/
+void print_fe(const fe25519 a) {
+  uint8_t s[FE_BYTES];
+  fe25519 r;
+  fe_to_bytes(s, a);
+  fe_from_bytes(r, s);
+  printf("{0x%013llxULL, 0x%013llxULL, 0x%013llxULL, 0x%013llxULL, 0x%013llxULL}",
+    (unsigned long long) r[0], (unsigned long long) r[1], (unsigned long long) r[2], (unsigned long long) r[3], (unsigned long long) r[4]);
+}
+
+int main(){
+
+  ted_point * P = ted_point_init();
+  ted_point * jP = ted_point_init();
+  ted_precomp Q;
+  ted_point_set_str(P, TED_CURVE_BX, TED_CURVE_BY, 16);
+
+  printf("/**\n");
+  printf("  * \\file ted_base_table.h\n");
+  printf("  * \\brief Fixed-base table of the generator B, TED_BASE_TABLE[i][j-1] = j 16^i B in (y+x, y-x, 2dxy) form\n\n");
+  printf("  * Generated by bin/ted-table from src/main_ted_table.c, do not edit.\n");
+  printf("*/\n\n");
+  printf("#ifndef TED_BASE_TABLE_H\n#define TED_BASE_TABLE_H\n\n");
+  printf("static const ted_precomp TED_BASE_TABLE[TED_BASE_ROWS][TED_BASE_MULTIPLES] = {\n");
+  for (int i=0 ; i<TED_BASE_ROWS ; i++) {
+    printf("  {\n");
+    ted_point_set(jP, P);
+    for (int j=1 ; j<=TED_BASE_MULTIPLES ; j++) {
+      if (j>1) ted_point_add(jP, jP, P);
+      ted_precomp_set(&Q, jP);
+      printf("    {");
+      print_fe(Q.yplusx);
+      printf(",\n     ");
+      print_fe(Q.yminusx);
+      printf(",\n     ");
+      print_fe(Q.xy2d);
+      printf("}%s\n", j<TED_BASE_MULTIPLES ? "," : "");
+    }
+    printf("  }%s\n", i<TED_BASE_ROWS-1 ? "," : "");
+    for (int k=0 ; k<TED_BASE_WINDOW ; k++) ted_point_double(P, P);
+  }
+  printf("};\n\n#endif\n");
+
+  ted_point_clear(P);
+  ted_point_clear(jP);
+  return 0;
+}
@@ -18,20 +18,13 @@ int OT_sender_setup(uint8_t * enc_S , mpz_t y, ted_point * S, ted_point * T) {
   mpz_t TED_C_P ;
   mpz_init(TED_C_P);
   mpz_set_str(TED_C_P,TED_CURVE_P,16);
-  ted_point * B = ted_point_init();
-  ted_point_set_str(B, TED_CURVE_BX,TED_CURVE_BY,16);
-
-  gmp_randstate_t seed ;
-  gmp_randinit_default (seed);
-  gmp_randseed_ui(seed,time(NULL)*time(NULL));
-  mpz_urandomm (y, seed, TED_C_P);
-  ted_point_mult(S,B,y);
+
+  random_mpz_mod(y,TED_C_P);
+  ted_point_mult_base(S,y);
   ted_point_mult(T,S,y);
   ted_encode(enc_S,S);
 
   mpz_clear(TED_C_P);
-  ted_point_clear(B);
-  gmp_randclear(seed);
   return 0;
 }
 
@@ -47,42 +40,93 @@ int OT_sender_setup(uint8_t * enc_S , mpz_t y, ted_point * S, ted_point * T) {
 */
 int OT_receiver_choose(uint8_t ** enc_R, mpz_t * x, ted_point ** R, uint8_t * enc_S, mpz_t receiver) {
 
-  mpz_t temp, TED_C_P ;
-  mpz_inits(TED_C_P,temp,NULL);
-  mpz_set_str(TED_C_P,TED_CURVE_P,16);
-  ted_point * B = ted_point_init();
   ted_point * S = ted_point_init();
-  ted_point_set_str(B, TED_CURVE_BX,TED_CURVE_BY,16);
 
-  ted_decode(S,enc_S);
-  if (ted_curve_in(S)==0) {
+  if (ted_decode(S,enc_S)==0) {
     printf("Error. S does not belong to the curve\n");
+    ted_point_clear(S);
     return 1;
   }
+  OT_receiver_choose_point(enc_R,x,R,S,receiver);
 
-  gmp_randstate_t seed ;
-  gmp_randinit_default(seed);
-  gmp_randseed_ui(seed,time(NULL));
-  int b;
+  ted_point_clear(S);
+  return 0;
+}
+
+/**
+  * \fn int OT_receiver_choose_point(uint8_t ** enc_R, mpz_t * x, ted_point ** R, ted_point * S, mpz_t receiver)
+  * \brief second step with the point S already decoded, for instance by an OT_receiver_session
+
+  * \param[out] enc_R     bytes double array representing the encoded points R sent to sender
+  * \param[out] x         mpz_t representing the receiver's secret values
+  * \param[out] R         ted_point array representing the points computed by the receiver
+  * \param[in] S          ted_point representing the point received by sender
+  * \param[in] receiver   mpz_t representing the input to hide
+*/
+int OT_receiver_choose_point(uint8_t ** enc_R, mpz_t * x, ted_point ** R, ted_point * S, mpz_t receiver) {
+
+  mpz_t TED_C_P ;
+  mpz_init(TED_C_P);
+  mpz_set_str(TED_C_P,TED_CURVE_P,16);
 
-  ted_point* temp1 = ted_point_init();
   for (int i=0; i<PARAM_L+1;++i) {
-    mpz_urandomm(x[i], seed, TED_C_P);
-    ted_point_mult(R[i],B,x[i]);
-    b = mpz_tstbit(receiver,i);
-    if (b==1) {
-      ted_point_add(temp1,R[i],S);
-      mpz_set(R[i]->x,temp1->x);
-      mpz_set(R[i]->y,temp1->y);
-    }
-    ted_encode(enc_R[i],R[i]);
+    random_mpz_mod(x[i],TED_C_P);
+    ted_point_mult_base(R[i],x[i]);
+    if (mpz_tstbit(receiver,i)) ted_point_add(R[i],R[i],S);
+  }
+  ted_encode_batch(enc_R,R,PARAM_L+1);
+
+  mpz_clear(TED_C_P);
+  return 0;
+}
 
+/**
+  * \fn static int ot_sender_pads(mpz_t ** pads, uint8_t ** enc_R, ted_point * T, mpz_t y)
+  * \brief This function computes the masks H(yR_i) and H(yR_i - T) of the PARAM_L+1 OTs
+
+  * \return 0 if the computation succeed
+  * \return 1 if one of the points R does not belong to the curve
+*/
+static int ot_sender_pads(mpz_t ** pads, uint8_t ** enc_R, ted_point * T, mpz_t y) {
+
+  int n = PARAM_L+1;
+  mpz_t x0, y0;
+  ted_cached cached_T;
+  ted_point ** R = calloc(2*n,sizeof(ted_point *));
+  for (int i=0; i<2*n;++i) R[i]=ted_point_init();
+
+  if (ted_decode_batch(R,enc_R,n)==0) {
+    printf("Error, at least one of the R value does not belong the curve\n");
+    for (int j=0; j<2*n;++j) ted_point_clear(R[j]);
+    free(R);
+    return 1;
   }
-  mpz_clears(TED_C_P,temp,NULL);
-  ted_point_clear(temp1);
-  ted_point_clear(B);
-  ted_point_clear(S);
-  gmp_randclear(seed);
+
+  // R[i] = yR_i and R[n+i] = yR_i - T, T in cached form once for all the points
+  ted_point_mult_batch(R,R,n,y);
+  ted_cached_set(&cached_T,T);
+  for (int i=0; i<n;++i) ted_point_sub_cached(R[n+i],R[i],&cached_T);
+  ted_point_normalize_batch(R,2*n);
+
+  // the 2n values y + x are hashed together
+  mpz_t * sums = calloc(2*n,sizeof(mpz_t));
+  mpz_inits(x0,y0,NULL);
+  for (int i=0; i<2*n;++i) {
+    mpz_init(sums[i]);
+    ted_point_get_affine(x0,y0,R[i]);
+    mpz_add(sums[i],y0,x0);
+  }
+  H_batch_mpz(sums,sums,2*n);
+  for (int i=0; i<n;++i) {
+    mpz_set(pads[i][0],sums[i]);
+    mpz_set(pads[i][1],sums[n+i]);
+  }
+
+  for (int i=0; i<2*n;++i) mpz_clear(sums[i]);
+  free(sums);
+  mpz_clears(x0,y0,NULL);
+  for (int i = 0; i < 2*n; ++i) ted_point_clear(R[i]);
+  free(R);
   return 0;
 }
 
@@ -98,38 +142,43 @@ int OT_receiver_choose(uint8_t ** enc_R, mpz_t * x, ted_point ** R, uint8_t * en
 */
 int OT_sender_key_derivation(mpz_t ** K, mpz_t ** kB, uint8_t ** enc_R, ted_point * T, mpz_t y) {
 
-  ted_point * temp1 = ted_point_init();
-  ted_point * temp2 = ted_point_init();
-  ted_point * opT = ted_point_init();
-  ted_point ** R = calloc(PARAM_L+1,sizeof(ted_point *));
-  for (int i=0; i<PARAM_L+1;++i) {
-    R[i]=ted_point_init();
-    ted_decode(R[i],enc_R[i]);
-    if (ted_curve_in(R[i])==0) {
-      printf("Error, at least one of the R value does not belong the curve\n");
-      return 1;
-    }
-    ted_point_mult(temp1,R[i],y); //temp1=yR
-    ted_point_opp(opT,T);
-    ted_point_add(temp2,temp1,opT);
-
-    mpz_add(K[i][0],temp1->y,temp1->x);
-    mpz_add(K[i][1],temp2->y,temp2->x);
-    H(K[i][0],K[i][0]);
-    H(K[i][1],K[i][1]);
+  if (ot_sender_pads(K,enc_R,T,y)) return 1;
 
+  for (int i=0; i<PARAM_L+1;++i) {
     mpz_xor(K[i][0],K[i][0],kB[i][0]);
     mpz_xor(K[i][1],K[i][1],kB[i][1]);
   }
-
-  ted_point_clear(opT);
-  ted_point_clear(temp1);
-  ted_point_clear(temp2);
-  for (int i = 0; i < PARAM_L+1; ++i) ted_point_clear(R[i]);
-  free(R);
   return 0;
 }
 
+/**
+  * \fn static void ot_receiver_pads(mpz_t * pads, mpz_t * x, ted_point * S, const ted_precomp * S_table)
+  * \brief This function computes the masks H(x_i S) of the PARAM_L+1 OTs, with the fixed-base table of S if not NULL
+*/
+static void ot_receiver_pads(mpz_t * pads, mpz_t * x, ted_point * S, const ted_precomp * S_table) {
+
+  mpz_t x0, y0;
+  ted_point ** xS = calloc(PARAM_L+1,sizeof(ted_point *));
+
+  mpz_inits(x0,y0,NULL);
+
+  for (int i=0; i<PARAM_L+1;++i) {
+    xS[i]=ted_point_init();
+    if (S_table!=NULL) ted_point_mult_table(xS[i],S_table,x[i]);
+    else ted_point_mult(xS[i],S,x[i]);
+  }
+  ted_point_normalize_batch(xS,PARAM_L+1);
+
+  for (int i=0; i<PARAM_L+1;++i) {
+    ted_point_get_affine(x0,y0,xS[i]);
+    mpz_add(pads[i],y0,x0);
+    ted_point_clear(xS[i]);
+  }
+  H_batch_mpz(pads,pads,PARAM_L+1);
+  mpz_clears(x0,y0,NULL);
+  free(xS);
+}
+
 /**
   * \fn int OT_receiver_retrieve(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t* x, uint8_t * enc_S, mpz_t rho)
   * \brief fourth step : receiver retrieves his input keys
@@ -139,31 +188,198 @@ int OT_sender_key_derivation(mpz_t ** K, mpz_t ** kB, uint8_t ** enc_R, ted_poin
   * \param[in] x                    mpz_t array representing the receiver's secret values
   * \param[in] enc_S                bytes array representing the encoded point received from sender
   * \param[in] rho                  mpz_t representing the receiver's new input
+
+  * \return 0 if the computation succeed
+  * \return 1 if S does not belong to the curve
 */
 int OT_receiver_retrieve(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t * x, uint8_t * enc_S, mpz_t rho) {
 
-  mpz_t k_receiver;
-  ted_point * temp1 = ted_point_init();
   ted_point * S = ted_point_init();
-  int b;
 
-  mpz_init(k_receiver);
-  ted_decode(S,enc_S);
-
-  for (int i=0; i<PARAM_L+1;++i) {
-    b = mpz_tstbit(rho,i);
-    ted_point_mult(temp1,S,x[i]);
-    mpz_add(k_receiver,temp1->y,temp1->x);
-    H(k_receiver,k_receiver);
-    mpz_xor(receiver_input_keys[i],K[i][b],k_receiver);
+  if (ted_decode(S,enc_S)==0) {
+    printf("Error. S does not belong to the curve\n");
+    ted_point_clear(S);
+    return 1;
   }
-  mpz_clear(k_receiver);
-  ted_point_clear(temp1);
+  OT_receiver_retrieve_point(receiver_input_keys,K,x,S,rho);
   ted_point_clear(S);
 
   return 0;
 }
 
+/**
+  * \fn int OT_receiver_retrieve_point(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t* x, ted_point * S, mpz_t rho)
+  * \brief fourth step with the point S already decoded, for instance by an OT_receiver_session
+
+  * \param[out] receiver_input_keys mpz_t array representing the computed keys (the output)
+  * \param[in] K                    mpz_t double array representing the received values from sender
+  * \param[in] x                    mpz_t array representing the receiver's secret values
+  * \param[in] S                    ted_point representing the point received from sender
+  * \param[in] rho                  mpz_t representing the receiver's new input
+*/
+int OT_receiver_retrieve_point(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t * x, ted_point * S, mpz_t rho) {
+
+  ot_receiver_pads(receiver_input_keys,x,S,NULL);
+  for (int i=0; i<PARAM_L+1;++i) mpz_xor(receiver_input_keys[i],receiver_input_keys[i],K[i][mpz_tstbit(rho,i)]);
+
+  return 0;
+}
+
+/**
+  * \fn int OT_receiver_retrieve_session(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t * x, OT_receiver_session * session, mpz_t rho)
+  * \brief fourth step with the point S of a session, the masks x_i S are read from its fixed-base table
+
+  * \param[out] receiver_input_keys mpz_t array representing the computed keys (the output)
+  * \param[in] K                    mpz_t double array representing the received values from sender
+  * \param[in] x                    mpz_t array representing the receiver's secret values
+  * \param[in] session              OT_receiver_session updated with the point S of this comparison
+  * \param[in] rho                  mpz_t representing the receiver's new input
+
+  * \return 0 if the computation succeed
+  * \return 1 if the session does not hold a valid point S
+*/
+int OT_receiver_retrieve_session(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t * x, OT_receiver_session * session, mpz_t rho) {
+
+  if (!session->valid) return 1;
+  ot_receiver_pads(receiver_input_keys,x,session->S,session->S_table);
+  for (int i=0; i<PARAM_L+1;++i) mpz_xor(receiver_input_keys[i],receiver_input_keys[i],K[i][mpz_tstbit(rho,i)]);
+
+  return 0;
+}
+
+/**
+  * \fn void OT_sender_session_rotate(OT_sender_session * session)
+  * \brief This function draws new values (y, S, T) for the following comparisons of the session
+
+  * \param[out] session  OT_sender_session whose enc_S must be sent again to the receiver
+*/
+void OT_sender_session_rotate(OT_sender_session * session) {
+
+  OT_sender_setup(session->enc_S,session->y,session->S,session->T);
+  session->uses = 0;
+}
+
+/**
+  * \fn int OT_sender_session_setup(OT_sender_session * session, uint8_t * enc_S, mpz_t y, ted_point * S, ted_point * T)
+  * \brief first step with a session : the values (y, S, T) of the session are reused instead of drawn again
+
+  * Same outputs as OT_sender_setup. The session is rotated before its first comparison and after
+  * session->max_uses comparisons, the receiver then decodes the new S once.
+
+  * \param[in,out] session  OT_sender_session shared by the comparisons with the same receiver
+  * \param[out] enc_S       bytes array representing the encoded point sent to the receiver
+  * \param[out] y           mpz_t representing the secret value for the sender
+  * \param[out] S           ted_point representing the common point
+  * \param[out] T           ted_point representing a point kept secret by the sender
+*/
+int OT_sender_session_setup(OT_sender_session * session, uint8_t * enc_S, mpz_t y, ted_point * S, ted_point * T) {
+
+  if (session->uses<0 || (session->max_uses>0 && session->uses>=session->max_uses)) OT_sender_session_rotate(session);
+  session->uses++;
+
+  mpz_set(y,session->y);
+  ted_point_set(S,session->S);
+  ted_point_set(T,session->T);
+  memcpy(enc_S,session->enc_S,bits_to_bytes(TED_CURVE_SIZE));
+  return 0;
+}
+
+/**
+  * \fn int OT_receiver_session_update(OT_receiver_session * session, uint8_t * enc_S)
+  * \brief This function decodes and validates the point S received from the sender, only if it changed since the last call
+
+  * The fixed-base table of S is built at the same time, once per point S and not per comparison.
+
+  * \param[in,out] session  OT_receiver_session whose S is used by OT_receiver_choose_point and OT_receiver_retrieve_session
+  * \param[in] enc_S        bytes array representing the encoded point received from sender
+
+  * \return 0 if S belongs to the curve
+  * \return 1 otherwise
+*/
+int OT_receiver_session_update(OT_receiver_session * session, uint8_t * enc_S) {
+
+  if (session->valid && memcmp(session->enc_S,enc_S,bits_to_bytes(TED_CURVE_SIZE))==0) return 0;
+
+  memcpy(session->enc_S,enc_S,bits_to_bytes(TED_CURVE_SIZE));
+  session->valid = ted_decode(session->S,enc_S)!=0;
+  if (!session->valid) {
+    printf("Error. S does not belong to the curve\n");
+    return 1;
+  }
+  ted_table_set(session->S_table,session->S);
+  return 0;
+}
+
+/**
+  * \fn OT_sender_session * OT_sender_session_init(int max_uses)
+  * \brief This function initializes an OT_sender_session variable
+
+  * \param[in] max_uses  int representing the number of comparisons sharing (y, S, T), 0 to never rotate
+
+  * \return session an initialized OT_sender_session variable
+*/
+OT_sender_session * OT_sender_session_init(int max_uses) {
+
+  OT_sender_session * session = (OT_sender_session *) malloc(sizeof(OT_sender_session));
+
+  mpz_init(session->y);
+  session->S = ted_point_init();
+  session->enc_S = calloc(64,sizeof(uint8_t));
+  session->T = ted_point_init();
+  session->uses = -1;
+  session->max_uses = max_uses;
+
+  return session;
+}
+
+/**
+  * \fn OT_receiver_session * OT_receiver_session_init()
+  * \brief This function initializes an OT_receiver_session variable
+
+  * \return session an initialized OT_receiver_session variable
+*/
+OT_receiver_session * OT_receiver_session_init() {
+
+  OT_receiver_session * session = (OT_receiver_session *) malloc(sizeof(OT_receiver_session));
+
+  session->enc_S = calloc(bits_to_bytes(TED_CURVE_SIZE),sizeof(uint8_t));
+  session->S = ted_point_init();
+  session->S_table = calloc(TED_BASE_ROWS*TED_BASE_MULTIPLES,sizeof(ted_precomp));
+  session->valid = 0;
+
+  return session;
+}
+
+/**
+  * \fn void OT_sender_session_clear(OT_sender_session * session)
+  * \brief This function releases an OT_sender_session variable, its secret y is zeroed
+
+  * \param[in] session the variable to release
+*/
+void OT_sender_session_clear(OT_sender_session * session) {
+
+  mpz_set_ui(session->y,0);
+  mpz_clear(session->y);
+  ted_point_clear(session->S);
+  ted_point_clear(session->T);
+  free(session->enc_S);
+  free(session);
+}
+
+/**
+  * \fn void OT_receiver_session_clear(OT_receiver_session * session)
+  * \brief This function releases an OT_receiver_session variable
+
+  * \param[in] session the variable to release
+*/
+void OT_receiver_session_clear(OT_receiver_session * session) {
+
+  ted_point_clear(session->S);
+  free(session->S_table);
+  free(session->enc_S);
+  free(session);
+}
+
 /**
   * \fn OT_sender * OT_sender_init()
   * \brief This function initalizes an OT_sender variable
@@ -185,6 +401,10 @@ OT_sender * OT_sender_init() {
     OTS->sen_keys[i]=calloc(2 , sizeof(uint8_t *));
     for (int j=0 ; j<2 ; j++) OTS->sen_keys[i][j]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
   }
+  OTS->sen_ext = NULL;
+  OTS->sen_ext_index = 0;
+  OTS->sen_corrections = calloc(bits_to_bytes(PARAM_L+1),sizeof(uint8_t));
+  OTS->sen_session = NULL;
 
   return OTS;
 
@@ -210,6 +430,7 @@ void OT_sender_clear(OT_sender * OTS) {
   free(OTS->sen_enc_R);
   free(OTS->sen_y);
   free(OTS->sen_enc_S);
+  free(OTS->sen_corrections);
   free(OTS);
 }
 
@@ -236,6 +457,10 @@ OT_receiver * OT_receiver_init() {
     OTR->rec_x[i]=calloc(64,sizeof(uint8_t));
     for (int j=0 ; j<2 ; j++) OTR->rec_keys[i][j]=calloc(bits_to_bytes(KEY_SIZE),sizeof(uint8_t));
   }
+  OTR->rec_ext = NULL;
+  OTR->rec_ext_index = 0;
+  OTR->rec_corrections = calloc(bits_to_bytes(PARAM_L+1),sizeof(uint8_t));
+  OTR->rec_session = NULL;
 
   return OTR;
 
@@ -262,5 +487,6 @@ void OT_receiver_clear(OT_receiver * OTR) {
   free(OTR->rec_enc_R);
   free(OTR->rec_x);
   free(OTR->rec_enc_S);
+  free(OTR->rec_corrections);
   free(OTR);
 }
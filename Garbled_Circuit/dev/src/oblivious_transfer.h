@@ -8,6 +8,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "gmp.h"
 #include "time.h"
@@ -25,6 +26,10 @@ typedef struct OT_sender {
 	ted_point * sen_T ; /**< Private secret for sende r*/
 	uint8_t ** sen_enc_R ; /**< Encoded values of the points R */
 	uint8_t *** sen_keys ; /**< Derivated keys sent to receiver */
+	struct OT_ext_sender * sen_ext ; /**< OT extension session replacing the base OTs, NULL if none */
+	int sen_ext_index ; /**< Index of the first OT of this comparison in the current extension */
+	uint8_t * sen_corrections ; /**< Corrections of the precomputed random OTs received from the receiver */
+	struct OT_sender_session * sen_session ; /**< Session providing (y, S, T) shared with other comparisons, NULL if none */
 } OT_sender ;
 
 /**
@@ -37,12 +42,52 @@ typedef struct OT_receiver {
 	ted_point ** rec_R ; /**< ted_point's generated by receiver to retrieve his input keys */
 	uint8_t ** rec_enc_R; /**< Encoded values of the points R */
 	uint8_t *** rec_keys ; /**< Derivated keys received from the sender */
+	struct OT_ext_receiver * rec_ext ; /**< OT extension session replacing the base OTs, NULL if none */
+	int rec_ext_index ; /**< Index of the first OT of this comparison in the current extension */
+	uint8_t * rec_corrections ; /**< Corrections of the precomputed random OTs sent to the sender */
+	struct OT_receiver_session * rec_session ; /**< Session keeping the decoded point S shared with other comparisons, NULL if none */
 } OT_receiver ;
 
+/**
+  * \typedef OT_sender_session
+  * \brief Structure for the sender's values (y, S, T) reused by the OTs of several comparisons with the same receiver
+  */
+typedef struct OT_sender_session {
+	mpz_t y ; /**< Random value of the sender */
+	ted_point * S ; /**< Common point S = yB */
+	uint8_t * enc_S ; /**< Encoded value of the point S */
+	ted_point * T ; /**< Private point T = yS */
+	int uses ; /**< Number of comparisons since the last rotation, -1 before the first one */
+	int max_uses ; /**< Number of comparisons after which (y, S, T) are drawn again, 0 to never rotate */
+} OT_sender_session ;
+
+/**
+  * \typedef OT_receiver_session
+  * \brief Structure for the receiver's decoded point S reused by the OTs of several comparisons with the same sender
+  */
+typedef struct OT_receiver_session {
+	uint8_t * enc_S ; /**< Encoded value of the last point S received */
+	ted_point * S ; /**< Decoded point S */
+	ted_precomp * S_table ; /**< Fixed-base table of S, TED_BASE_ROWS*TED_BASE_MULTIPLES entries */
+	int valid ; /**< 1 if S has been decoded and belongs to the curve */
+} OT_receiver_session ;
+
 int OT_sender_setup( uint8_t * enc_S, mpz_t y, ted_point* S, ted_point* T);
 int OT_receiver_choose( uint8_t ** enc_R , mpz_t * x, ted_point** R,  uint8_t * enc_S, mpz_t input_receiver);
 int OT_sender_key_derivation(mpz_t** K, mpz_t** M,  uint8_t ** enc_R, ted_point* T, mpz_t y);
 int OT_receiver_retrieve(mpz_t * receiver_input_keys, mpz_t ** K,mpz_t* x,  uint8_t * S, mpz_t rho);
+int OT_receiver_choose_point(uint8_t ** enc_R, mpz_t * x, ted_point ** R, ted_point * S, mpz_t input_receiver);
+int OT_receiver_retrieve_point(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t * x, ted_point * S, mpz_t rho);
+int OT_receiver_retrieve_session(mpz_t * receiver_input_keys, mpz_t ** K, mpz_t * x, OT_receiver_session * session, mpz_t rho);
+
+int OT_sender_session_setup(OT_sender_session * session, uint8_t * enc_S, mpz_t y, ted_point * S, ted_point * T);
+void OT_sender_session_rotate(OT_sender_session * session);
+int OT_receiver_session_update(OT_receiver_session * session, uint8_t * enc_S);
+OT_sender_session * OT_sender_session_init(int max_uses);
+OT_receiver_session * OT_receiver_session_init();
+void OT_sender_session_clear(OT_sender_session * session);
+void OT_receiver_session_clear(OT_receiver_session * session);
+
 OT_sender * OT_sender_init();
 OT_receiver * OT_receiver_init();
 void OT_receiver_clear(OT_receiver * OTR);
@@ -0,0 +1,784 @@
+/**
+  * \file ot_extension.c
+  * \brief implementation of the IKNP oblivious transfer extension
+
+  * The receiver of the extended OTs runs OT_EXT_KAPPA base OTs as their sender, with pairs of seeds k_j^0, k_j^1,
+  * and the sender of the extended OTs receives k_j^{s_j} for random choice bits s. For m OTs of choices r, the
+  * receiver sends the columns u_j = G(k_j^0) ^ G(k_j^1) ^ r and keeps the columns t_j = G(k_j^0), the sender computes
+  * q_j = G(k_j^{s_j}) ^ s_j u_j. The rows then satisfy q_i = t_i ^ r_i s, and the OT i masks its two messages with
+  * H(i, q_i) and H(i, q_i ^ s), the receiver only knowing H(i, t_i). G and H are built on SHA512, the base OTs only
+  * transfer seeds so that their cost does not depend on m. The OT_EXT_KAPPA streams of G and the m digests of H are
+  * independent and computed several at a time by sha512_batch.
+
+  * The OTs can also be precomputed before the inputs are known as random OTs, of random choices c and pads, and
+  * derandomized online with Beaver's method : the receiver sends d = r ^ c and the sender masks m_b with the pad of
+  * index b ^ d, so that the online phase only xors precomputed pads.
+*/
+
+#include <string.h>
+#include "ot_extension.h"
+#include "randombytes.h"
+#include "hash.h"
+
+#define OT_EXT_HASH_CHUNK 8 /**< number of digests computed by one call to sha512_batch */
+
+/**
+  * \fn static void ot_ext_prg_batch(uint8_t ** out, uint8_t ** seeds, uint64_t offset, uint32_t len, int nb)
+  * \brief This function computes the bytes [offset, offset+len) of the streams SHA512(seed || counter) of nb seeds
+
+  * \param[out] out    bytes double array representing the nb outputs of len bytes
+  * \param[in] seeds   bytes double array representing the nb seeds of OT_EXT_SEED_BYTES
+  * \param[in] offset  uint64_t representing the first byte of the streams
+  * \param[in] len     uint32_t representing the number of bytes
+  * \param[in] nb      int representing the number of seeds
+*/
+static void ot_ext_prg_batch(uint8_t ** out, uint8_t ** seeds, uint64_t offset, uint32_t len, int nb) {
+
+  uint8_t input[OT_EXT_HASH_CHUNK][OT_EXT_SEED_BYTES+8], digest[OT_EXT_HASH_CHUNK][64];
+  unsigned char * inputs[OT_EXT_HASH_CHUNK], * outputs[OT_EXT_HASH_CHUNK];
+  size_t size[OT_EXT_HASH_CHUNK];
+  uint64_t counter;
+  uint32_t pos, done, n;
+  int m;
+
+  for (int c=0 ; c<nb ; c+=OT_EXT_HASH_CHUNK) {
+    m = nb-c<OT_EXT_HASH_CHUNK ? nb-c : OT_EXT_HASH_CHUNK;
+    for (int k=0 ; k<m ; k++) {
+      memcpy(input[k], seeds[c+k], OT_EXT_SEED_BYTES);
+      inputs[k] = input[k];
+      outputs[k] = digest[k];
+      size[k] = sizeof(input[k]);
+    }
+    counter = offset/64;
+    pos = offset%64;
+    done = 0;
+    while (done<len) {
+      for (int k=0 ; k<m ; k++) for (int i=0 ; i<8 ; i++) input[k][OT_EXT_SEED_BYTES+i] = (counter>>(8*i)) & 0xff;
+      sha512_batch(outputs, inputs, size, m);
+      n = (64-pos < len-done) ? 64-pos : len-done;
+      for (int k=0 ; k<m ; k++) memcpy(out[c+k]+done, digest[k]+pos, n);
+      done += n;
+      pos = 0;
+      counter++;
+    }
+  }
+}
+
+/**
+  * \fn static void ot_ext_hash_batch(uint8_t * out, uint64_t index, uint8_t ** rows, uint8_t * s, int nb)
+  * \brief This function computes the 64 bytes digests H(index+i, rows[i] ^ s) of nb extended OTs
+
+  * \param[out] out    bytes array of 64*nb bytes representing the digests
+  * \param[in] index   uint64_t representing the index of the first OT
+  * \param[in] rows    bytes double array representing the nb rows
+  * \param[in] s       bytes array of OT_EXT_ROW_BYTES xored with each row, NULL to hash the rows themselves
+  * \param[in] nb      int representing the number of OTs
+*/
+static void ot_ext_hash_batch(uint8_t * out, uint64_t index, uint8_t ** rows, uint8_t * s, int nb) {
+
+  uint8_t input[OT_EXT_HASH_CHUNK][8+OT_EXT_ROW_BYTES];
+  unsigned char * inputs[OT_EXT_HASH_CHUNK], * outputs[OT_EXT_HASH_CHUNK];
+  size_t size[OT_EXT_HASH_CHUNK];
+  int n;
+
+  for (int c=0 ; c<nb ; c+=OT_EXT_HASH_CHUNK) {
+    n = nb-c<OT_EXT_HASH_CHUNK ? nb-c : OT_EXT_HASH_CHUNK;
+    for (int k=0 ; k<n ; k++) {
+      for (int i=0 ; i<8 ; i++) input[k][i] = ((index+c+k)>>(8*i)) & 0xff;
+      for (int b=0 ; b<OT_EXT_ROW_BYTES ; b++) input[k][8+b] = rows[c+k][b] ^ (s ? s[b] : 0);
+      inputs[k] = input[k];
+      outputs[k] = out+64*(c+k);
+      size[k] = sizeof(input[k]);
+    }
+    sha512_batch(outputs, inputs, size, n);
+  }
+}
+
+/**
+  * \fn static void ot_ext_transpose(uint8_t ** rows, uint8_t * columns, int nb_ot, uint32_t column_bytes)
+  * \brief This function transposes the OT_EXT_KAPPA columns of nb_ot bits into nb_ot rows of OT_EXT_KAPPA bits
+*/
+static void ot_ext_transpose(uint8_t ** rows, uint8_t * columns, int nb_ot, uint32_t column_bytes) {
+
+  for (int i=0 ; i<nb_ot ; i++) memset(rows[i], 0, OT_EXT_ROW_BYTES);
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) {
+    uint8_t * c = columns + j*column_bytes;
+    for (int i=0 ; i<nb_ot ; i++) rows[i][j/8] |= ((c[i/8]>>(i%8)) & 1) << (j%8);
+  }
+}
+
+/**
+  * \fn static void ot_ext_base_bits(mpz_t bits, uint8_t * s, int chunk)
+  * \brief This function sets bits to the choice bits of the base OTs of a chunk
+*/
+static void ot_ext_base_bits(mpz_t bits, uint8_t * s, int chunk) {
+
+  mpz_set_ui(bits, 0);
+  for (int i=0 ; i<PARAM_L+1 ; i++) {
+    int j = chunk*(PARAM_L+1)+i;
+    if (j<OT_EXT_KAPPA && ((s[j/8]>>(j%8)) & 1)) mpz_setbit(bits, i);
+  }
+}
+
+/**
+  * \fn int OT_ext_receiver_base_setup(OT_ext_receiver * R)
+  * \brief first step of the base OTs : the receiver of the extension draws the seeds and sets up the base OTs
+
+  * All the chunks share the values (y, S, T) of a single OT_sender_session.
+
+  * \param[out] R  OT_ext_receiver whose base[c]->sen_enc_S are sent to the sender
+*/
+int OT_ext_receiver_base_setup(OT_ext_receiver * R) {
+
+  mpz_t y;
+  OT_sender_session * session = OT_sender_session_init(0);
+  mpz_init(y);
+
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) {
+    random_bytes(R->seeds[j][0], OT_EXT_SEED_BYTES);
+    random_bytes(R->seeds[j][1], OT_EXT_SEED_BYTES);
+  }
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) {
+    OT_sender_session_setup(session, R->base[c]->sen_enc_S, y, R->base[c]->sen_S, R->base[c]->sen_T);
+    memset(R->base[c]->sen_y, 0, bits_to_bytes(255));
+    mpz_export(R->base[c]->sen_y, NULL, -1, 1, 0, 0, y);
+  }
+
+  mpz_clear(y);
+  OT_sender_session_clear(session);
+  return 0;
+}
+
+/**
+  * \fn int OT_ext_sender_base_choose(OT_ext_sender * S)
+  * \brief second step of the base OTs : the sender of the extension draws s and chooses the seeds k_j^{s_j}
+
+  * \param[out] S  OT_ext_sender whose base[c]->rec_enc_R are sent to the receiver
+
+  * \return 0 if the computation succeed
+  * \return 1 if one of the received points does not belong to the curve
+*/
+int OT_ext_sender_base_choose(OT_ext_sender * S) {
+
+  int error = 0;
+  mpz_t bits;
+  mpz_t * x = calloc(PARAM_L+1, sizeof(mpz_t));
+  OT_receiver_session * session = OT_receiver_session_init();
+  mpz_init(bits);
+  for (int i=0 ; i<PARAM_L+1 ; i++) mpz_init(x[i]);
+
+  random_bytes(S->s, OT_EXT_ROW_BYTES);
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS && error==0 ; c++) {
+    ot_ext_base_bits(bits, S->s, c);
+    error = OT_receiver_session_update(session, S->base[c]->rec_enc_S);
+    if (error==0) OT_receiver_choose_point(S->base[c]->rec_enc_R, x, S->base[c]->rec_R, session->S, bits);
+    for (int i=0 ; i<PARAM_L+1 ; i++) {
+      memset(S->base[c]->rec_x[i], 0, 64);
+      mpz_export(S->base[c]->rec_x[i], NULL, -1, 1, 0, 0, x[i]);
+    }
+  }
+
+  for (int i=0 ; i<PARAM_L+1 ; i++) mpz_clear(x[i]);
+  mpz_clear(bits);
+  free(x);
+  OT_receiver_session_clear(session);
+  return error;
+}
+
+/**
+  * \fn int OT_ext_receiver_base_transfer(OT_ext_receiver * R)
+  * \brief third step of the base OTs : the receiver of the extension masks the pairs of seeds
+
+  * \param[out] R  OT_ext_receiver whose base[c]->sen_keys are sent to the sender
+
+  * \return 0 if the computation succeed
+  * \return 1 if one of the received points does not belong to the curve
+*/
+int OT_ext_receiver_base_transfer(OT_ext_receiver * R) {
+
+  int error = 0;
+  mpz_t y;
+  mpz_t ** K = calloc(PARAM_L+1, sizeof(mpz_t *));
+  mpz_t ** kB = calloc(PARAM_L+1, sizeof(mpz_t *));
+  mpz_init(y);
+  for (int i=0 ; i<PARAM_L+1 ; i++) {
+    K[i] = calloc(2, sizeof(mpz_t));
+    kB[i] = calloc(2, sizeof(mpz_t));
+    mpz_inits(K[i][0], K[i][1], kB[i][0], kB[i][1], NULL);
+  }
+
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS && error==0 ; c++) {
+    mpz_import(y, bits_to_bytes(255), -1, 1, 0, 0, R->base[c]->sen_y);
+    for (int i=0 ; i<PARAM_L+1 ; i++) {
+      int j = c*(PARAM_L+1)+i;
+      for (int b=0 ; b<2 ; b++) {
+        if (j<OT_EXT_KAPPA) mpz_import(kB[i][b], OT_EXT_SEED_BYTES, -1, 1, 0, 0, R->seeds[j][b]);
+        else mpz_set_ui(kB[i][b], 0);
+      }
+    }
+    error = OT_sender_key_derivation(K, kB, R->base[c]->sen_enc_R, R->base[c]->sen_T, y);
+    for (int i=0 ; i<PARAM_L+1 ; i++) for (int b=0 ; b<2 ; b++) {
+      memset(R->base[c]->sen_keys[i][b], 0, bits_to_bytes(KEY_SIZE));
+      mpz_export(R->base[c]->sen_keys[i][b], NULL, -1, 1, 0, 0, K[i][b]);
+    }
+  }
+
+  for (int i=0 ; i<PARAM_L+1 ; i++) {
+    mpz_clears(K[i][0], K[i][1], kB[i][0], kB[i][1], NULL);
+    free(K[i]);
+    free(kB[i]);
+  }
+  mpz_clear(y);
+  free(K);
+  free(kB);
+  return error;
+}
+
+/**
+  * \fn int OT_ext_sender_base_retrieve(OT_ext_sender * S)
+  * \brief fourth step of the base OTs : the sender of the extension retrieves the seeds k_j^{s_j}
+
+  * \param[out] S  OT_ext_sender whose seeds are set
+*/
+int OT_ext_sender_base_retrieve(OT_ext_sender * S) {
+
+  mpz_t bits;
+  mpz_t * x = calloc(PARAM_L+1, sizeof(mpz_t));
+  mpz_t * keys = calloc(PARAM_L+1, sizeof(mpz_t));
+  mpz_t ** K = calloc(PARAM_L+1, sizeof(mpz_t *));
+  OT_receiver_session * session = OT_receiver_session_init();
+  mpz_init(bits);
+  for (int i=0 ; i<PARAM_L+1 ; i++) {
+    K[i] = calloc(2, sizeof(mpz_t));
+    mpz_inits(x[i], keys[i], K[i][0], K[i][1], NULL);
+  }
+
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) {
+    ot_ext_base_bits(bits, S->s, c);
+    for (int i=0 ; i<PARAM_L+1 ; i++) {
+      mpz_import(x[i], 32, -1, 1, 0, 0, S->base[c]->rec_x[i]);
+      for (int b=0 ; b<2 ; b++) mpz_import(K[i][b], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, S->base[c]->rec_keys[i][b]);
+    }
+    OT_receiver_session_update(session, S->base[c]->rec_enc_S);
+    OT_receiver_retrieve_session(keys, K, x, session, bits);
+    for (int i=0 ; i<PARAM_L+1 ; i++) {
+      int j = c*(PARAM_L+1)+i;
+      if (j>=OT_EXT_KAPPA) break;
+      memset(S->seeds[j], 0, OT_EXT_SEED_BYTES);
+      mpz_export(S->seeds[j], NULL, -1, 1, 0, 0, keys[i]);
+    }
+  }
+
+  for (int i=0 ; i<PARAM_L+1 ; i++) {
+    mpz_clears(x[i], keys[i], K[i][0], K[i][1], NULL);
+    free(K[i]);
+  }
+  mpz_clear(bits);
+  free(x);
+  free(keys);
+  free(K);
+  OT_receiver_session_clear(session);
+  return 0;
+}
+
+/**
+  * \fn uint32_t OT_ext_u_size(int nb_ot)
+  * \brief This function gives the size of the matrix U sent for nb_ot extended OTs
+
+  * \param[in] nb_ot  int representing the number of extended OTs
+
+  * \return the size in bytes of U
+*/
+uint32_t OT_ext_u_size(int nb_ot) {
+  return OT_EXT_KAPPA*bits_to_bytes(nb_ot);
+}
+
+/**
+  * \fn int OT_ext_receiver_choose(OT_ext_receiver * R, uint8_t * choices, int nb_ot)
+  * \brief first step of an extension : the receiver computes the matrices T and U for nb_ot choice bits
+
+  * \param[out] R        OT_ext_receiver whose first OT_ext_u_size(nb_ot) bytes of u are sent to the sender
+  * \param[in] choices   bytes array of bits_to_bytes(nb_ot) bytes, the bit i of choices[i/8] is the choice of the OT i
+  * \param[in] nb_ot     int representing the number of OTs, at most R->max_ot
+
+  * \return 0 if the computation succeed
+  * \return 1 if nb_ot is larger than R->max_ot
+*/
+int OT_ext_receiver_choose(OT_ext_receiver * R, uint8_t * choices, int nb_ot) {
+
+  if (nb_ot>R->max_ot) return 1;
+
+  uint32_t len = bits_to_bytes(nb_ot);
+  uint8_t * t = malloc(OT_EXT_KAPPA*len), * g = malloc(OT_EXT_KAPPA*len);
+  uint8_t * seeds[2][OT_EXT_KAPPA], * columns[2][OT_EXT_KAPPA];
+
+  // the columns of the previous extension are never reused
+  R->counter += 8*bits_to_bytes(R->nb_ot);
+  R->nb_ot = nb_ot;
+  R->nb_random = 0;
+
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) {
+    seeds[0][j] = R->seeds[j][0];
+    seeds[1][j] = R->seeds[j][1];
+    columns[0][j] = t+j*len;
+    columns[1][j] = g+j*len;
+  }
+  ot_ext_prg_batch(columns[0], seeds[0], R->counter/8, len, OT_EXT_KAPPA);
+  ot_ext_prg_batch(columns[1], seeds[1], R->counter/8, len, OT_EXT_KAPPA);
+  for (uint32_t b=0 ; b<OT_EXT_KAPPA*len ; b++) R->u[b] = t[b] ^ g[b] ^ choices[b%len];
+  ot_ext_transpose(R->t, t, nb_ot, len);
+
+  free(t);
+  free(g);
+  return 0;
+}
+
+/**
+  * \fn int OT_ext_sender_expand(OT_ext_sender * S, int nb_ot)
+  * \brief second step of an extension : the sender computes the rows of Q from the received matrix U
+
+  * \param[out] S      OT_ext_sender whose u has been received
+  * \param[in] nb_ot   int representing the number of OTs, at most S->max_ot
+
+  * \return 0 if the computation succeed
+  * \return 1 if nb_ot is larger than S->max_ot
+*/
+int OT_ext_sender_expand(OT_ext_sender * S, int nb_ot) {
+
+  if (nb_ot>S->max_ot) return 1;
+
+  uint32_t len = bits_to_bytes(nb_ot);
+  uint8_t * q = malloc(OT_EXT_KAPPA*len), * columns[OT_EXT_KAPPA];
+
+  S->counter += 8*bits_to_bytes(S->nb_ot);
+  S->nb_ot = nb_ot;
+  S->nb_random = 0;
+
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) columns[j] = q+j*len;
+  ot_ext_prg_batch(columns, S->seeds, S->counter/8, len, OT_EXT_KAPPA);
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) {
+    if ((S->s[j/8]>>(j%8)) & 1) for (uint32_t b=0 ; b<len ; b++) q[j*len+b] ^= S->u[j*len+b];
+  }
+  ot_ext_transpose(S->q, q, nb_ot, len);
+
+  free(q);
+  return 0;
+}
+
+/**
+  * \fn void OT_ext_sender_transfer(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, int index, int nb)
+  * \brief third step of an extension : the sender masks the pairs of messages of the OTs index to index+nb-1
+
+  * \param[out] K      mpz_t double array representing the masked messages sent to the receiver
+  * \param[in] S       OT_ext_sender after OT_ext_sender_expand
+  * \param[in] kB      mpz_t double array representing the pairs of messages
+  * \param[in] index   int representing the first OT of the current extension used
+  * \param[in] nb      int representing the number of OTs
+*/
+void OT_ext_sender_transfer(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, int index, int nb) {
+
+  uint8_t * digests = malloc(2*64*nb);
+  mpz_t pad;
+  mpz_init(pad);
+
+  ot_ext_hash_batch(digests, S->counter+index, S->q+index, NULL, nb);
+  ot_ext_hash_batch(digests+64*nb, S->counter+index, S->q+index, S->s, nb);
+  for (int i=0 ; i<nb ; i++) {
+    mpz_import(pad, bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, digests+64*i);
+    mpz_xor(K[i][0], kB[i][0], pad);
+    mpz_import(pad, bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, digests+64*(nb+i));
+    mpz_xor(K[i][1], kB[i][1], pad);
+  }
+
+  mpz_clear(pad);
+  free(digests);
+}
+
+/**
+  * \fn void OT_ext_receiver_retrieve(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb)
+  * \brief fourth step of an extension : the receiver retrieves the chosen messages of the OTs index to index+nb-1
+
+  * \param[out] receiver_input_keys mpz_t array representing the retrieved messages
+  * \param[in] R                    OT_ext_receiver after OT_ext_receiver_choose
+  * \param[in] K                    mpz_t double array representing the masked messages received from the sender
+  * \param[in] rho                  mpz_t whose bit i is the choice of the OT index+i
+  * \param[in] index                int representing the first OT of the current extension used
+  * \param[in] nb                   int representing the number of OTs
+*/
+void OT_ext_receiver_retrieve(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb) {
+
+  uint8_t * digests = malloc(64*nb);
+  mpz_t pad;
+  mpz_init(pad);
+
+  ot_ext_hash_batch(digests, R->counter+index, R->t+index, NULL, nb);
+  for (int i=0 ; i<nb ; i++) {
+    mpz_import(pad, bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, digests+64*i);
+    mpz_xor(receiver_input_keys[i], K[i][mpz_tstbit(rho,i)], pad);
+  }
+
+  mpz_clear(pad);
+  free(digests);
+}
+
+/**
+  * \fn void OT_ext_sender_correlated(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, mpz_t offset, int index, int nb)
+  * \brief third step of an extension, correlated OT : the receiver's keys are derived from Q and only their offset is sent
+
+  * The key kB[i][0] is H(i, q_i) and a single value K[i][0] = H(i, q_i) ^ H(i, q_i ^ s) ^ offset is sent per OT.
+
+  * \param[out] K       mpz_t double array whose K[i][0] are sent to the receiver, K[i][1] is unused
+  * \param[out] kB      mpz_t double array representing the receiver's keys, kB[i][1] = kB[i][0] ^ offset
+  * \param[in] S        OT_ext_sender after OT_ext_sender_expand
+  * \param[in] offset   mpz_t representing the offset of the freeXOR optimization
+  * \param[in] index    int representing the first OT of the current extension used
+  * \param[in] nb       int representing the number of OTs
+*/
+void OT_ext_sender_correlated(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, mpz_t offset, int index, int nb) {
+
+  uint8_t * digests = malloc(2*64*nb);
+
+  ot_ext_hash_batch(digests, S->counter+index, S->q+index, NULL, nb);
+  ot_ext_hash_batch(digests+64*nb, S->counter+index, S->q+index, S->s, nb);
+  for (int i=0 ; i<nb ; i++) {
+    mpz_import(kB[i][0], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, digests+64*i);
+    mpz_import(K[i][0], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, digests+64*(nb+i));
+    mpz_xor(K[i][0], K[i][0], kB[i][0]);
+    mpz_xor(K[i][0], K[i][0], offset);
+    mpz_set_ui(K[i][1], 0);
+    mpz_xor(kB[i][1], kB[i][0], offset);
+  }
+
+  free(digests);
+}
+
+/**
+  * \fn void OT_ext_receiver_retrieve_correlated(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb)
+  * \brief fourth step of an extension, correlated OT : the receiver retrieves kB[i][0] ^ rho_i offset
+
+  * \param[out] receiver_input_keys mpz_t array representing the retrieved keys
+  * \param[in] R                    OT_ext_receiver after OT_ext_receiver_choose
+  * \param[in] K                    mpz_t double array whose K[i][0] are the values received from the sender
+  * \param[in] rho                  mpz_t whose bit i is the choice of the OT index+i
+  * \param[in] index                int representing the first OT of the current extension used
+  * \param[in] nb                   int representing the number of OTs
+*/
+void OT_ext_receiver_retrieve_correlated(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb) {
+
+  uint8_t * digests = malloc(64*nb);
+
+  ot_ext_hash_batch(digests, R->counter+index, R->t+index, NULL, nb);
+  for (int i=0 ; i<nb ; i++) {
+    mpz_import(receiver_input_keys[i], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, digests+64*i);
+    if (mpz_tstbit(rho,i)) mpz_xor(receiver_input_keys[i], receiver_input_keys[i], K[i][0]);
+  }
+
+  free(digests);
+}
+
+/**
+  * \fn int OT_ext_receiver_precompute(OT_ext_receiver * R, int nb_ot)
+  * \brief offline phase, receiver : extends nb_ot random OTs of random choices and stores their pads
+
+  * \param[out] R       OT_ext_receiver whose first OT_ext_u_size(nb_ot) bytes of u are sent to the sender
+  * \param[in] nb_ot    int representing the number of random OTs, at most R->max_ot
+
+  * \return 0 if the computation succeed
+  * \return 1 if nb_ot is larger than R->max_ot
+*/
+int OT_ext_receiver_precompute(OT_ext_receiver * R, int nb_ot) {
+
+  uint8_t * digests;
+
+  random_bytes(R->choices, bits_to_bytes(nb_ot));
+  if (OT_ext_receiver_choose(R, R->choices, nb_ot)) return 1;
+  digests = malloc(64*nb_ot);
+  ot_ext_hash_batch(digests, R->counter, R->t, NULL, nb_ot);
+  for (int i=0 ; i<nb_ot ; i++) memcpy(R->pads[i], digests+64*i, bits_to_bytes(KEY_SIZE));
+  free(digests);
+  R->nb_random = nb_ot;
+  R->used = 0;
+  return 0;
+}
+
+/**
+  * \fn int OT_ext_sender_precompute(OT_ext_sender * S, int nb_ot)
+  * \brief offline phase, sender : expands the received matrix U into nb_ot random OTs and stores their pairs of pads
+
+  * \param[out] S       OT_ext_sender whose u has been received
+  * \param[in] nb_ot    int representing the number of random OTs, at most S->max_ot
+
+  * \return 0 if the computation succeed
+  * \return 1 if nb_ot is larger than S->max_ot
+*/
+int OT_ext_sender_precompute(OT_ext_sender * S, int nb_ot) {
+
+  uint8_t * digests;
+
+  if (OT_ext_sender_expand(S, nb_ot)) return 1;
+  digests = malloc(2*64*nb_ot);
+  ot_ext_hash_batch(digests, S->counter, S->q, NULL, nb_ot);
+  ot_ext_hash_batch(digests+64*nb_ot, S->counter, S->q, S->s, nb_ot);
+  for (int i=0 ; i<nb_ot ; i++) {
+    memcpy(S->pads[i][0], digests+64*i, bits_to_bytes(KEY_SIZE));
+    memcpy(S->pads[i][1], digests+64*(nb_ot+i), bits_to_bytes(KEY_SIZE));
+  }
+  free(digests);
+  S->nb_random = nb_ot;
+  S->used = 0;
+  return 0;
+}
+
+/**
+  * \fn int OT_ext_receiver_correct(OT_ext_receiver * R, uint8_t * corrections, mpz_t rho, int nb)
+  * \brief online phase, receiver : consumes nb random OTs and computes the corrections d_i = rho_i ^ c_i
+
+  * \param[out] corrections  bytes array of bits_to_bytes(nb) bytes sent to the sender
+  * \param[in] R             OT_ext_receiver after OT_ext_receiver_precompute
+  * \param[in] rho           mpz_t whose bit i is the choice of the OT i
+  * \param[in] nb            int representing the number of OTs
+
+  * \return the index of the first random OT consumed
+  * \return -1 if less than nb precomputed random OTs are left
+*/
+int OT_ext_receiver_correct(OT_ext_receiver * R, uint8_t * corrections, mpz_t rho, int nb) {
+
+  int index = R->used;
+  if (index+nb>R->nb_random) return -1;
+
+  memset(corrections, 0, bits_to_bytes(nb));
+  for (int i=0 ; i<nb ; i++) {
+    int c = (R->choices[(index+i)/8]>>((index+i)%8)) & 1;
+    corrections[i/8] |= (mpz_tstbit(rho,i) ^ c) << (i%8);
+  }
+  R->used += nb;
+  return index;
+}
+
+/**
+  * \fn int OT_ext_sender_reserve(OT_ext_sender * S, int nb)
+  * \brief online phase, sender : consumes nb random OTs, in the same order as the receiver
+
+  * \param[in] S   OT_ext_sender after OT_ext_sender_precompute
+  * \param[in] nb  int representing the number of OTs
+
+  * \return the index of the first random OT consumed
+  * \return -1 if less than nb precomputed random OTs are left
+*/
+int OT_ext_sender_reserve(OT_ext_sender * S, int nb) {
+
+  int index = S->used;
+  if (index+nb>S->nb_random) return -1;
+  S->used += nb;
+  return index;
+}
+
+/**
+  * \fn void OT_ext_sender_derandomize(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, uint8_t * corrections, int index, int nb)
+  * \brief online phase, sender : masks the pairs of messages with the pads of the random OTs index to index+nb-1
+
+  * \param[out] K            mpz_t double array representing the masked messages, K[i][b] = kB[i][b] ^ pad_{b ^ d_i}
+  * \param[in] S             OT_ext_sender after OT_ext_sender_precompute
+  * \param[in] kB            mpz_t double array representing the pairs of messages
+  * \param[in] corrections   bytes array representing the corrections received from the receiver
+  * \param[in] index         int representing the first random OT, as returned by OT_ext_sender_reserve
+  * \param[in] nb            int representing the number of OTs
+*/
+void OT_ext_sender_derandomize(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, uint8_t * corrections, int index, int nb) {
+
+  mpz_t pad;
+  mpz_init(pad);
+
+  for (int i=0 ; i<nb ; i++) {
+    int d = (corrections[i/8]>>(i%8)) & 1;
+    for (int b=0 ; b<2 ; b++) {
+      mpz_import(pad, bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, S->pads[index+i][b^d]);
+      mpz_xor(K[i][b], kB[i][b], pad);
+    }
+  }
+
+  mpz_clear(pad);
+}
+
+/**
+  * \fn void OT_ext_sender_derandomize_correlated(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, mpz_t offset, uint8_t * corrections, int index, int nb)
+  * \brief online phase, sender, correlated OT : the receiver's keys are the pads pad_{d_i} and only their offset is sent
+
+  * \param[out] K            mpz_t double array whose K[i][0] = pad_0 ^ pad_1 ^ offset are sent to the receiver
+  * \param[out] kB           mpz_t double array representing the receiver's keys, kB[i][1] = kB[i][0] ^ offset
+  * \param[in] S             OT_ext_sender after OT_ext_sender_precompute
+  * \param[in] offset        mpz_t representing the offset of the freeXOR optimization
+  * \param[in] corrections   bytes array representing the corrections received from the receiver
+  * \param[in] index         int representing the first random OT, as returned by OT_ext_sender_reserve
+  * \param[in] nb            int representing the number of OTs
+*/
+void OT_ext_sender_derandomize_correlated(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, mpz_t offset, uint8_t * corrections, int index, int nb) {
+
+  for (int i=0 ; i<nb ; i++) {
+    int d = (corrections[i/8]>>(i%8)) & 1;
+    mpz_import(kB[i][0], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, S->pads[index+i][d]);
+    mpz_import(K[i][0], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, S->pads[index+i][1-d]);
+    mpz_xor(K[i][0], K[i][0], kB[i][0]);
+    mpz_xor(K[i][0], K[i][0], offset);
+    mpz_set_ui(K[i][1], 0);
+    mpz_xor(kB[i][1], kB[i][0], offset);
+  }
+}
+
+/**
+  * \fn void OT_ext_receiver_derandomize(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb)
+  * \brief online phase, receiver : retrieves the chosen messages with the pads of the random OTs index to index+nb-1
+
+  * \param[out] receiver_input_keys mpz_t array representing the retrieved messages
+  * \param[in] R                    OT_ext_receiver after OT_ext_receiver_precompute
+  * \param[in] K                    mpz_t double array representing the masked messages received from the sender
+  * \param[in] rho                  mpz_t whose bit i is the choice of the OT i
+  * \param[in] index                int representing the first random OT, as returned by OT_ext_receiver_correct
+  * \param[in] nb                   int representing the number of OTs
+*/
+void OT_ext_receiver_derandomize(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb) {
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_import(receiver_input_keys[i], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, R->pads[index+i]);
+    mpz_xor(receiver_input_keys[i], receiver_input_keys[i], K[i][mpz_tstbit(rho,i)]);
+  }
+}
+
+/**
+  * \fn void OT_ext_receiver_derandomize_correlated(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb)
+  * \brief online phase, receiver, correlated OT : retrieves kB[i][0] ^ rho_i offset
+
+  * \param[out] receiver_input_keys mpz_t array representing the retrieved keys
+  * \param[in] R                    OT_ext_receiver after OT_ext_receiver_precompute
+  * \param[in] K                    mpz_t double array whose K[i][0] are the values received from the sender
+  * \param[in] rho                  mpz_t whose bit i is the choice of the OT i
+  * \param[in] index                int representing the first random OT, as returned by OT_ext_receiver_correct
+  * \param[in] nb                   int representing the number of OTs
+*/
+void OT_ext_receiver_derandomize_correlated(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb) {
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_import(receiver_input_keys[i], bits_to_bytes(KEY_SIZE), -1, 1, 0, 0, R->pads[index+i]);
+    if (mpz_tstbit(rho,i)) mpz_xor(receiver_input_keys[i], receiver_input_keys[i], K[i][0]);
+  }
+}
+
+/**
+  * \fn OT_ext_sender * OT_ext_sender_init(int max_ot)
+  * \brief This function initalizes an OT_ext_sender variable
+
+  * \param[in] max_ot  int representing the largest number of OTs of one extension
+
+  * \return S an initialized OT_ext_sender variable
+*/
+OT_ext_sender * OT_ext_sender_init(int max_ot) {
+
+  OT_ext_sender * S = (OT_ext_sender *) malloc(sizeof(OT_ext_sender));
+
+  S->s = calloc(OT_EXT_ROW_BYTES, sizeof(uint8_t));
+  S->seeds = calloc(OT_EXT_KAPPA, sizeof(uint8_t *));
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) S->seeds[j] = calloc(OT_EXT_SEED_BYTES, sizeof(uint8_t));
+  S->base = calloc(OT_EXT_BASE_CHUNKS, sizeof(OT_receiver *));
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) S->base[c] = OT_receiver_init();
+  S->u = calloc(OT_ext_u_size(max_ot), sizeof(uint8_t));
+  S->q = calloc(max_ot, sizeof(uint8_t *));
+  for (int i=0 ; i<max_ot ; i++) S->q[i] = calloc(OT_EXT_ROW_BYTES, sizeof(uint8_t));
+  S->pads = calloc(max_ot, sizeof(uint8_t **));
+  for (int i=0 ; i<max_ot ; i++) {
+    S->pads[i] = calloc(2, sizeof(uint8_t *));
+    for (int b=0 ; b<2 ; b++) S->pads[i][b] = calloc(bits_to_bytes(KEY_SIZE), sizeof(uint8_t));
+  }
+  S->counter = 0;
+  S->nb_ot = 0;
+  S->max_ot = max_ot;
+  S->nb_random = 0;
+  S->used = 0;
+
+  return S;
+}
+
+/**
+  * \fn OT_ext_receiver * OT_ext_receiver_init(int max_ot)
+  * \brief This function initalizes an OT_ext_receiver variable
+
+  * \param[in] max_ot  int representing the largest number of OTs of one extension
+
+  * \return R an initialized OT_ext_receiver variable
+*/
+OT_ext_receiver * OT_ext_receiver_init(int max_ot) {
+
+  OT_ext_receiver * R = (OT_ext_receiver *) malloc(sizeof(OT_ext_receiver));
+
+  R->seeds = calloc(OT_EXT_KAPPA, sizeof(uint8_t **));
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) {
+    R->seeds[j] = calloc(2, sizeof(uint8_t *));
+    for (int b=0 ; b<2 ; b++) R->seeds[j][b] = calloc(OT_EXT_SEED_BYTES, sizeof(uint8_t));
+  }
+  R->base = calloc(OT_EXT_BASE_CHUNKS, sizeof(OT_sender *));
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) R->base[c] = OT_sender_init();
+  R->u = calloc(OT_ext_u_size(max_ot), sizeof(uint8_t));
+  R->t = calloc(max_ot, sizeof(uint8_t *));
+  for (int i=0 ; i<max_ot ; i++) R->t[i] = calloc(OT_EXT_ROW_BYTES, sizeof(uint8_t));
+  R->pads = calloc(max_ot, sizeof(uint8_t *));
+  for (int i=0 ; i<max_ot ; i++) R->pads[i] = calloc(bits_to_bytes(KEY_SIZE), sizeof(uint8_t));
+  R->choices = calloc(bits_to_bytes(max_ot), sizeof(uint8_t));
+  R->counter = 0;
+  R->nb_ot = 0;
+  R->max_ot = max_ot;
+  R->nb_random = 0;
+  R->used = 0;
+
+  return R;
+}
+
+/**
+  * \fn void OT_ext_sender_clear(OT_ext_sender * S)
+  * \brief This function releases an OT_ext_sender variable
+
+  * \param[in] S the variable to release
+*/
+void OT_ext_sender_clear(OT_ext_sender * S) {
+
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) free(S->seeds[j]);
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) OT_receiver_clear(S->base[c]);
+  for (int i=0 ; i<S->max_ot ; i++) {
+    free(S->q[i]);
+    free(S->pads[i][0]);
+    free(S->pads[i][1]);
+    free(S->pads[i]);
+  }
+  free(S->s);
+  free(S->seeds);
+  free(S->base);
+  free(S->u);
+  free(S->q);
+  free(S->pads);
+  free(S);
+}
+
+/**
+  * \fn void OT_ext_receiver_clear(OT_ext_receiver * R)
+  * \brief This function releases an OT_ext_receiver variable
+
+  * \param[in] R the variable to release
+*/
+void OT_ext_receiver_clear(OT_ext_receiver * R) {
+
+  for (int j=0 ; j<OT_EXT_KAPPA ; j++) {
+    free(R->seeds[j][0]);
+    free(R->seeds[j][1]);
+    free(R->seeds[j]);
+  }
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) OT_sender_clear(R->base[c]);
+  for (int i=0 ; i<R->max_ot ; i++) {
+    free(R->t[i]);
+    free(R->pads[i]);
+  }
+  free(R->seeds);
+  free(R->base);
+  free(R->u);
+  free(R->t);
+  free(R->pads);
+  free(R->choices);
+  free(R);
+}
@@ -0,0 +1,84 @@
+/**
+  * \file ot_extension.h
+  * \brief IKNP extension of OT_EXT_KAPPA base oblivious transfers to any number of 1-out-of-2 oblivious transfers
+*/
+
+#ifndef OT_EXTENSION_H
+#define OT_EXTENSION_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "gmp.h"
+#include "parameters.h"
+#include "oblivious_transfer.h"
+
+#define OT_EXT_ROW_BYTES (OT_EXT_KAPPA/8) /**< size of a row of the extension matrices */
+#define OT_EXT_SEED_BYTES (KEY_SIZE/8) /**< size of the seeds transferred by the base OTs */
+#define OT_EXT_BASE_CHUNKS ((OT_EXT_KAPPA+PARAM_L)/(PARAM_L+1)) /**< number of runs of the PARAM_L+1 base OTs of oblivious_transfer.c */
+
+/**
+  * \typedef OT_ext_sender
+  * \brief Structure for the variables of the sender of the extended OTs, who is the receiver of the base OTs
+  */
+typedef struct OT_ext_sender {
+	uint8_t * s ; /**< Choice bits of the base OTs, offset between the rows of Q and T */
+	uint8_t ** seeds ; /**< Seeds k_j^{s_j} received in the base OTs */
+	OT_receiver ** base ; /**< Receiver's variables of the base OTs */
+	uint8_t * u ; /**< Columns of the matrix U received from the receiver */
+	uint8_t ** q ; /**< Rows of the matrix Q of the current extension */
+	uint64_t counter ; /**< Index of the first OT of the current extension, PRG position and hash tweak */
+	int nb_ot ; /**< Number of OTs of the current extension */
+	int max_ot ; /**< Largest number of OTs of one extension */
+	uint8_t *** pads ; /**< Pads H(i, q_i) and H(i, q_i ^ s) of the precomputed random OTs */
+	int nb_random ; /**< Number of precomputed random OTs, 0 if the current extension is not random */
+	int used ; /**< Number of precomputed random OTs already consumed */
+} OT_ext_sender ;
+
+/**
+  * \typedef OT_ext_receiver
+  * \brief Structure for the variables of the receiver of the extended OTs, who is the sender of the base OTs
+  */
+typedef struct OT_ext_receiver {
+	uint8_t *** seeds ; /**< Pairs of seeds k_j^0, k_j^1 sent in the base OTs */
+	OT_sender ** base ; /**< Sender's variables of the base OTs */
+	uint8_t * u ; /**< Columns of the matrix U sent to the sender */
+	uint8_t ** t ; /**< Rows of the matrix T of the current extension */
+	uint64_t counter ; /**< Index of the first OT of the current extension, PRG position and hash tweak */
+	int nb_ot ; /**< Number of OTs of the current extension */
+	int max_ot ; /**< Largest number of OTs of one extension */
+	uint8_t ** pads ; /**< Pads H(i, t_i) of the precomputed random OTs */
+	uint8_t * choices ; /**< Random choice bits c of the precomputed random OTs */
+	int nb_random ; /**< Number of precomputed random OTs, 0 if the current extension is not random */
+	int used ; /**< Number of precomputed random OTs already consumed */
+} OT_ext_receiver ;
+
+int OT_ext_receiver_base_setup(OT_ext_receiver * R);
+int OT_ext_sender_base_choose(OT_ext_sender * S);
+int OT_ext_receiver_base_transfer(OT_ext_receiver * R);
+int OT_ext_sender_base_retrieve(OT_ext_sender * S);
+
+uint32_t OT_ext_u_size(int nb_ot);
+int OT_ext_receiver_choose(OT_ext_receiver * R, uint8_t * choices, int nb_ot);
+int OT_ext_sender_expand(OT_ext_sender * S, int nb_ot);
+void OT_ext_sender_transfer(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, int index, int nb);
+void OT_ext_receiver_retrieve(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb);
+void OT_ext_sender_correlated(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, mpz_t offset, int index, int nb);
+void OT_ext_receiver_retrieve_correlated(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb);
+
+int OT_ext_receiver_precompute(OT_ext_receiver * R, int nb_ot);
+int OT_ext_sender_precompute(OT_ext_sender * S, int nb_ot);
+int OT_ext_receiver_correct(OT_ext_receiver * R, uint8_t * corrections, mpz_t rho, int nb);
+int OT_ext_sender_reserve(OT_ext_sender * S, int nb);
+void OT_ext_sender_derandomize(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, uint8_t * corrections, int index, int nb);
+void OT_ext_sender_derandomize_correlated(OT_ext_sender * S, mpz_t ** K, mpz_t ** kB, mpz_t offset, uint8_t * corrections, int index, int nb);
+void OT_ext_receiver_derandomize(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb);
+void OT_ext_receiver_derandomize_correlated(OT_ext_receiver * R, mpz_t * receiver_input_keys, mpz_t ** K, mpz_t rho, int index, int nb);
+
+OT_ext_sender * OT_ext_sender_init(int max_ot);
+OT_ext_receiver * OT_ext_receiver_init(int max_ot);
+void OT_ext_sender_clear(OT_ext_sender * S);
+void OT_ext_receiver_clear(OT_ext_receiver * R);
+
+#endif
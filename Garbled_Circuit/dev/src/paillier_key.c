@@ -0,0 +1,267 @@
+/**
+  * \file paillier_key.c
+  * \brief implementation of the Paillier key generation and key files
+*/
+
+#include "paillier_key.h"
+
+/**
+  * \fn void paillier_gen_prime(mpz_t prime, int bits, int nb_threads)
+  * \brief This function draws a random prime of exactly bits bits whose two most significant bits are set
+
+  * nb_threads threads sieve disjoint random intervals of odd candidates by the odd primes below
+  * PAILLIER_KEYGEN_SIEVE_BOUND and run Miller-Rabin tests on the survivors only; the first prime found is kept.
+
+  * \param[out] prime    mpz_t representing the prime found
+
+  * \param[in] bits      int representing the size in bits of the prime
+  * \param[in] nb_threads int representing the number of searching threads
+*/
+void paillier_gen_prime(mpz_t prime, int bits, int nb_threads) {
+
+  paillier_prime_search search;
+  pthread_t * workers=calloc(nb_threads,sizeof(pthread_t));
+  uint8_t * composite=calloc(PAILLIER_KEYGEN_SIEVE_BOUND,sizeof(uint8_t));
+
+  // Eratosthenes sieve for the small odd primes
+  search.small_primes=calloc(PAILLIER_KEYGEN_SIEVE_BOUND/2,sizeof(unsigned long));
+  search.nb_small_primes=0;
+  for (unsigned long i=3 ; i<PAILLIER_KEYGEN_SIEVE_BOUND ; i+=2) {
+    if (composite[i]) continue;
+    search.small_primes[search.nb_small_primes++]=i;
+    for (unsigned long j=i*i ; j<PAILLIER_KEYGEN_SIEVE_BOUND ; j+=2*i) composite[j]=1;
+  }
+
+  search.bits=bits;
+  search.found=0;
+  mpz_init(search.prime);
+  pthread_mutex_init(&search.lock,NULL);
+
+  for (int i=0 ; i<nb_threads ; i++) pthread_create(&workers[i],NULL,paillier_prime_worker,&search);
+  for (int i=0 ; i<nb_threads ; i++) pthread_join(workers[i],NULL);
+  mpz_set(prime,search.prime);
+
+  pthread_mutex_destroy(&search.lock);
+  mpz_clear(search.prime);
+  free(search.small_primes);
+  free(composite);
+  free(workers);
+}
+
+/**
+  * \fn void * paillier_prime_worker(void * arg)
+  * \brief This function is run by every thread of paillier_gen_prime until one of them finds a prime
+
+  * \param[in,out] arg paillier_prime_search shared by the threads
+
+  * \return NULL
+*/
+void * paillier_prime_worker(void * arg) {
+
+  paillier_prime_search * search = (paillier_prime_search *) arg;
+  int found=0;
+  uint8_t * sieve=calloc(PAILLIER_KEYGEN_SIEVE_SIZE,sizeof(uint8_t));
+  uint8_t bytes_array[32];
+  unsigned long r, sp, i0;
+  mpz_t start, candidate;
+  gmp_randstate_t seed ;
+
+  mpz_inits(start,candidate,NULL);
+  random_bytes(bytes_array,32);
+  mpz_import(start,32,-1,1,0,0,bytes_array);
+  gmp_randinit_default(seed);
+  gmp_randseed(seed,start);
+
+  while (!found) {
+    // random odd start with its two most significant bits set
+    mpz_urandomb(start,seed,search->bits);
+    mpz_setbit(start,search->bits-1);
+    mpz_setbit(start,search->bits-2);
+    mpz_setbit(start,0);
+
+    // sieve[i] = 1 if start + 2i has a small prime factor
+    memset(sieve,0,PAILLIER_KEYGEN_SIEVE_SIZE);
+    for (int k=0 ; k<search->nb_small_primes ; k++) {
+      sp=search->small_primes[k];
+      r=mpz_fdiv_ui(start,sp);
+      // start + 2i = 0 mod sp <=> i = -r * 2^-1 mod sp, with 2^-1 = (sp+1)/2
+      i0=((sp-r)%sp)*((sp+1)/2)%sp;
+      for (unsigned long i=i0 ; i<PAILLIER_KEYGEN_SIEVE_SIZE ; i+=sp) sieve[i]=1;
+    }
+
+    for (int i=0 ; i<PAILLIER_KEYGEN_SIEVE_SIZE && !found ; i++) {
+      if (sieve[i]) continue;
+      pthread_mutex_lock(&search->lock);
+      found=search->found;
+      pthread_mutex_unlock(&search->lock);
+      if (found) break;
+
+      mpz_add_ui(candidate,start,2*i);
+      if (mpz_sizeinbase(candidate,2)!=(size_t) search->bits) break;
+      if (mpz_probab_prime_p(candidate,PAILLIER_PRIME_TEST_ITERATIONS)==0) continue;
+
+      pthread_mutex_lock(&search->lock);
+      if (!search->found) {
+        mpz_set(search->prime,candidate);
+        search->found=1;
+      }
+      found=1;
+      pthread_mutex_unlock(&search->lock);
+    }
+  }
+
+  mpz_clears(start,candidate,NULL);
+  gmp_randclear(seed);
+  free(sieve);
+  return NULL;
+}
+
+/**
+  * \fn void paillier_keygen(paillier_ctx * ctx, int bits)
+  * \brief This function generates a fresh Paillier key with a modulus of exactly bits bits and precomputes its values
+
+  * \param[out] ctx  paillier_ctx freshly initialized, set to the new secret key
+
+  * \param[in] bits  int representing the size in bits of the modulus n
+*/
+void paillier_keygen(paillier_ctx * ctx, int bits) {
+
+  mpz_t phi;
+  mpz_init(phi);
+
+  do {
+    paillier_gen_prime(ctx->p,bits/2,PAILLIER_KEYGEN_THREADS);
+    paillier_gen_prime(ctx->q,bits-bits/2,PAILLIER_KEYGEN_THREADS);
+    mpz_mul(ctx->n,ctx->p,ctx->q);
+    mpz_sub_ui(ctx->p_minus_1,ctx->p,1);
+    mpz_sub_ui(ctx->q_minus_1,ctx->q,1);
+    mpz_mul(phi,ctx->p_minus_1,ctx->q_minus_1);
+    mpz_gcd(phi,phi,ctx->n);
+  } while (mpz_cmp(ctx->p,ctx->q)==0 || mpz_cmp_ui(phi,1)!=0);
+
+  ctx->has_sk=1;
+  paillier_ctx_precompute(ctx);
+
+  mpz_clear(phi);
+}
+
+/**
+  * \fn void paillier_key_fields(mpz_ptr * fields, paillier_ctx * ctx)
+  * \brief This function lists the values of a key in the order they are stored in a key file
+
+  * \param[out] fields  mpz_ptr array of size PAILLIER_KEY_FIELDS
+
+  * \param[in] ctx      paillier_ctx representing the key
+*/
+void paillier_key_fields(mpz_ptr * fields, paillier_ctx * ctx) {
+  fields[0]=ctx->n;
+  fields[1]=ctx->n_squared;
+  fields[2]=ctx->hs;
+  fields[3]=ctx->p;
+  fields[4]=ctx->q;
+  fields[5]=ctx->p_squared;
+  fields[6]=ctx->q_squared;
+  fields[7]=ctx->p_minus_1;
+  fields[8]=ctx->q_minus_1;
+  fields[9]=ctx->hp;
+  fields[10]=ctx->hq;
+  fields[11]=ctx->q_inv_p;
+  fields[12]=ctx->p2_inv_q2;
+}
+
+/**
+  * \fn int paillier_key_save(paillier_ctx * ctx, char * path, int with_sk)
+  * \brief This function writes a key and all its precomputed values to a binary file
+
+  * The file is a sequence of 64-bit words: PAILLIER_KEY_MAGIC, sizeof(mp_limb_t), has_sk, PAILLIER_KEY_FIELDS,
+  * then for each value its number of limbs followed by its limbs, least significant first, in the byte order
+  * of the machine. Every value is thus aligned on 8 bytes and can be read in place once the file is mapped.
+
+  * \param[in] ctx      paillier_ctx representing the key
+  * \param[in] path     char array representing the path of the file
+  * \param[in] with_sk  int, 1 to store the secret values, 0 to store the public key only
+
+  * \return 0 if the key is written
+  * \return 1 if the file can not be written
+*/
+int paillier_key_save(paillier_ctx * ctx, char * path, int with_sk) {
+
+  mpz_ptr fields[PAILLIER_KEY_FIELDS];
+  uint64_t header[4], size;
+  int error=0;
+  FILE * file=fopen(path,"wb");
+  if (file==NULL) return 1;
+
+  with_sk=with_sk && ctx->has_sk;
+  paillier_key_fields(fields,ctx);
+  header[0]=PAILLIER_KEY_MAGIC;
+  header[1]=sizeof(mp_limb_t);
+  header[2]=with_sk;
+  header[3]=PAILLIER_KEY_FIELDS;
+  error|=(fwrite(header,sizeof(uint64_t),4,file)!=4);
+
+  for (int i=0 ; i<PAILLIER_KEY_FIELDS ; i++) {
+    size=(i<3 || with_sk) ? mpz_size(fields[i]) : 0;
+    error|=(fwrite(&size,sizeof(uint64_t),1,file)!=1);
+    error|=(fwrite(mpz_limbs_read(fields[i]),sizeof(mp_limb_t),size,file)!=size);
+  }
+
+  error|=(fclose(file)!=0);
+  return error;
+}
+
+/**
+  * \fn int paillier_key_load(paillier_ctx * ctx, char * path)
+  * \brief This function sets a key from a file written by paillier_key_save, without recomputing anything
+
+  * The file is mapped in memory and every value is copied from its limbs in place. Only the Montgomery
+  * constants, one reduction per modulus, are derived.
+
+  * \param[out] ctx   paillier_ctx freshly initialized, set to the stored key
+
+  * \param[in] path   char array representing the path of the file
+
+  * \return 0 if the key is loaded
+  * \return 1 if the file can not be read
+  * \return 2 if the file is not a key file, or was not written with 64-bit limbs as used here
+*/
+int paillier_key_load(paillier_ctx * ctx, char * path) {
+
+  mpz_ptr fields[PAILLIER_KEY_FIELDS];
+  mpz_t stored;
+  struct stat st;
+  uint64_t * words, nb_words, pos=4, size;
+  int error=0;
+
+  int fd=open(path,O_RDONLY);
+  if (fd<0) return 1;
+  if (fstat(fd,&st)!=0 || st.st_size<(off_t) (4*sizeof(uint64_t))) {
+    close(fd);
+    return 1;
+  }
+  words=mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+  close(fd);
+  if (words==MAP_FAILED) return 1;
+  nb_words=st.st_size/sizeof(uint64_t);
+
+  if (words[0]!=PAILLIER_KEY_MAGIC || words[1]!=sizeof(mp_limb_t) || sizeof(mp_limb_t)!=sizeof(uint64_t) || words[3]!=PAILLIER_KEY_FIELDS) error=2;
+
+  paillier_key_fields(fields,ctx);
+  for (int i=0 ; i<PAILLIER_KEY_FIELDS && !error ; i++) {
+    if (pos>=nb_words) {
+      error=2;
+      break;
+    }
+    size=words[pos++];
+    if (size>nb_words-pos) {
+      error=2;
+      break;
+    }
+    mpz_set(fields[i],mpz_roinit_n(stored,(mp_limb_t *) (words+pos),size));
+    pos+=size;
+  }
+  if (!error) ctx->has_sk=(int) words[2];
+
+  munmap(words,st.st_size);
+  return error;
+}
@@ -0,0 +1,333 @@
+/**
+  * \file paillier_ops.c
+  * \brief implementation of the homomorphic operations on Paillier ciphertexts
+*/
+
+#include "paillier_ops.h"
+
+/**
+  * \fn void paillier_add(mpz_t c, mpz_t a, mpz_t b, paillier_ctx * ctx)
+  * \brief This function computes an encryption of the sum of the plaintexts of two ciphertexts
+
+  * \param[out] c   mpz_t representing the encryption of a+b, may be a or b
+
+  * \param[in] a    mpz_t representing the first ciphertext
+  * \param[in] b    mpz_t representing the second ciphertext
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_add(mpz_t c, mpz_t a, mpz_t b, paillier_ctx * ctx) {
+  mpz_mul(c,a,b);
+  mpz_mod(c,c,ctx->n_squared);
+}
+
+/**
+  * \fn void paillier_add_plain(mpz_t c, mpz_t a, mpz_t m, paillier_ctx * ctx)
+  * \brief This function adds a plaintext to the plaintext of a ciphertext, without any exponentiation since g = n+1
+
+  * \param[out] c   mpz_t representing the encryption of a+m, may be a or m
+
+  * \param[in] a    mpz_t representing the ciphertext
+  * \param[in] m    mpz_t representing the plaintext to add, may be negative
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_add_plain(mpz_t c, mpz_t a, mpz_t m, paillier_ctx * ctx) {
+  mpz_t g_m;
+  mpz_init(g_m);
+
+  // (n+1)^m = 1 + m n mod n^2
+  mpz_mod(g_m,m,ctx->n);
+  mpz_mul(g_m,g_m,ctx->n);
+  mpz_add_ui(g_m,g_m,1);
+  mpz_mul(c,a,g_m);
+  mpz_mod(c,c,ctx->n_squared);
+
+  mpz_clear(g_m);
+}
+
+/**
+  * \fn void paillier_sub(mpz_t c, mpz_t a, mpz_t b, paillier_ctx * ctx)
+  * \brief This function computes an encryption of the difference of the plaintexts of two ciphertexts
+
+  * \param[out] c   mpz_t representing the encryption of a-b mod n, may be a or b
+
+  * \param[in] a    mpz_t representing the first ciphertext
+  * \param[in] b    mpz_t representing the ciphertext to subtract
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_sub(mpz_t c, mpz_t a, mpz_t b, paillier_ctx * ctx) {
+  mpz_t b_inv;
+  mpz_init(b_inv);
+
+  mpz_invert(b_inv,b,ctx->n_squared);
+  mpz_mul(c,a,b_inv);
+  mpz_mod(c,c,ctx->n_squared);
+
+  mpz_clear(b_inv);
+}
+
+/**
+  * \fn int paillier_signed_exponent(mpz_t b, mpz_t e, mpz_t a, mpz_t k, paillier_ctx * ctx)
+  * \brief This function rewrites a^k mod n^2 on a ciphertext as b^e with the shortest non negative exponent
+
+  * Plaintexts live modulo n, so k is reduced modulo n. When the result is above n/2, as for a small negative k,
+  * a is inverted and e = n - (k mod n), which replaces an exponentiation by a full size exponent with an
+  * inversion and a short exponentiation.
+
+  * \param[out] b   mpz_t representing a or a^-1 mod n^2, may be a
+  * \param[out] e   mpz_t representing the exponent, at most n/2, may be k
+
+  * \param[in] a    mpz_t representing the ciphertext
+  * \param[in] k    mpz_t representing the scalar, may be negative
+  * \param[in] ctx  paillier_ctx representing the key
+
+  * \return 1 if a was inverted
+  * \return 0 otherwise
+*/
+int paillier_signed_exponent(mpz_t b, mpz_t e, mpz_t a, mpz_t k, paillier_ctx * ctx) {
+  int inverted = 0;
+  mpz_t half;
+  mpz_init(half);
+
+  mpz_mod(e,k,ctx->n);
+  mpz_fdiv_q_2exp(half,ctx->n,1);
+  if (mpz_cmp(e,half)>0) {
+    mpz_sub(e,ctx->n,e);
+    mpz_invert(b,a,ctx->n_squared);
+    inverted=1;
+  }
+  else mpz_set(b,a);
+
+  mpz_clear(half);
+  return inverted;
+}
+
+/**
+  * \fn void paillier_mul_scalar(mpz_t c, mpz_t a, mpz_t k, paillier_ctx * ctx)
+  * \brief This function computes an encryption of the product of the plaintext of a ciphertext by a scalar
+
+  * \param[out] c   mpz_t representing the encryption of k a mod n, may be a or k
+
+  * \param[in] a    mpz_t representing the ciphertext
+  * \param[in] k    mpz_t representing the scalar, may be negative
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_mul_scalar(mpz_t c, mpz_t a, mpz_t k, paillier_ctx * ctx) {
+  mpz_t b, e;
+  mpz_inits(b,e,NULL);
+
+  paillier_signed_exponent(b,e,a,k,ctx);
+  mpz_powm(c,b,e,ctx->n_squared);
+
+  mpz_clears(b,e,NULL);
+}
+
+/**
+  * \fn void paillier_rerandomize(mpz_t c, mpz_t a, paillier_ctx * ctx)
+  * \brief This function multiplies a ciphertext by a fresh n-th residue, so that it can not be linked to the original
+
+  * \param[out] c   mpz_t representing a new encryption of the plaintext of a, may be a
+
+  * \param[in] a    mpz_t representing the ciphertext
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_rerandomize(mpz_t c, mpz_t a, paillier_ctx * ctx) {
+  mpz_t r;
+  mpz_init(r);
+
+  paillier_gen_randomizer(r,ctx);
+  mpz_mul(c,a,r);
+  mpz_mod(c,c,ctx->n_squared);
+
+  mpz_clear(r);
+}
+
+/**
+  * \fn static int exp_digit(mpz_t e, long pos, int w)
+  * \brief This function reads the w bits of e starting at bit pos
+*/
+static int exp_digit(mpz_t e, long pos, int w) {
+  int d=0;
+  for (int s=w-1 ; s>=0 ; s--) d=(d<<1)|mpz_tstbit(e,pos+s);
+  return d;
+}
+
+/**
+  * \fn static long exp_max_bits(mpz_t * e, int nb)
+  * \brief This function returns the size in bits of the largest of nb non negative exponents
+*/
+static long exp_max_bits(mpz_t * e, int nb) {
+  long bits=0;
+  for (int i=0 ; i<nb ; i++) if (mpz_sgn(e[i]) && (long) mpz_sizeinbase(e[i],2)>bits) bits=mpz_sizeinbase(e[i],2);
+  return bits;
+}
+
+/**
+  * \fn void paillier_multi_exp_straus(mpz_t c, mpz_t * b, mpz_t * e, int nb, int w, mpz_t mod)
+  * \brief This function computes the product of the b[i]^e[i] mod mod with Straus' interleaved fixed window method
+
+  * Each base gets a table of its 2^w-1 first powers. The squarings of the accumulator are shared by all the
+  * bases, so that the cost is about nb (2^w + bits/w) + bits multiplications instead of nb (bits/w + bits).
+
+  * \param[out] c   mpz_t representing the product, may not be one of the b[i] or e[i]
+
+  * \param[in] b    mpz_t array of nb bases
+  * \param[in] e    mpz_t array of nb non negative exponents
+  * \param[in] nb   int representing the number of bases
+  * \param[in] w    int representing the window width
+  * \param[in] mod  mpz_t representing the modulus
+*/
+void paillier_multi_exp_straus(mpz_t c, mpz_t * b, mpz_t * e, int nb, int w, mpz_t mod) {
+
+  int digits = (1<<w)-1, d;
+  long bits = exp_max_bits(e,nb), nw = (bits+w-1)/w;
+  mpz_t * table = calloc(nb*digits,sizeof(mpz_t));
+
+  // table[i*digits+d-1] = b[i]^d
+  for (int i=0 ; i<nb ; i++) {
+    mpz_init(table[i*digits]);
+    mpz_mod(table[i*digits],b[i],mod);
+    for (d=1 ; d<digits ; d++) {
+      mpz_init(table[i*digits+d]);
+      mpz_mul(table[i*digits+d],table[i*digits+d-1],table[i*digits]);
+      mpz_mod(table[i*digits+d],table[i*digits+d],mod);
+    }
+  }
+
+  mpz_set_ui(c,1);
+  for (long win=nw-1 ; win>=0 ; win--) {
+    if (win!=nw-1) for (int s=0 ; s<w ; s++) {
+      mpz_mul(c,c,c);
+      mpz_mod(c,c,mod);
+    }
+    for (int i=0 ; i<nb ; i++) {
+      d=exp_digit(e[i],win*w,w);
+      if (d==0) continue;
+      mpz_mul(c,c,table[i*digits+d-1]);
+      mpz_mod(c,c,mod);
+    }
+  }
+  mpz_mod(c,c,mod);
+
+  for (int i=0 ; i<nb*digits ; i++) mpz_clear(table[i]);
+  free(table);
+}
+
+/**
+  * \fn void paillier_multi_exp_pippenger(mpz_t c, mpz_t * b, mpz_t * e, int nb, int w, mpz_t mod)
+  * \brief This function computes the product of the b[i]^e[i] mod mod with Pippenger's bucket method
+
+  * For each window, every base is multiplied into the bucket of its digit, then the buckets are combined as
+  * prod_d B[d]^d with 2 (2^w-1) multiplications by running products from the largest digit down. The cost is
+  * about bits/w (nb + 2^(w+1)) + bits multiplications, which beats Straus for many bases.
+
+  * \param[out] c   mpz_t representing the product, may not be one of the b[i] or e[i]
+
+  * \param[in] b    mpz_t array of nb bases
+  * \param[in] e    mpz_t array of nb non negative exponents
+  * \param[in] nb   int representing the number of bases
+  * \param[in] w    int representing the window width
+  * \param[in] mod  mpz_t representing the modulus
+*/
+void paillier_multi_exp_pippenger(mpz_t c, mpz_t * b, mpz_t * e, int nb, int w, mpz_t mod) {
+
+  int buckets = (1<<w)-1, d, run_set;
+  long bits = exp_max_bits(e,nb), nw = (bits+w-1)/w;
+  mpz_t * bucket = calloc(buckets,sizeof(mpz_t));
+  int * used = calloc(buckets,sizeof(int));
+  mpz_t run;
+
+  mpz_init(run);
+  for (d=0 ; d<buckets ; d++) mpz_init(bucket[d]);
+
+  mpz_set_ui(c,1);
+  for (long win=nw-1 ; win>=0 ; win--) {
+    if (win!=nw-1) for (int s=0 ; s<w ; s++) {
+      mpz_mul(c,c,c);
+      mpz_mod(c,c,mod);
+    }
+
+    memset(used,0,buckets*sizeof(int));
+    for (int i=0 ; i<nb ; i++) {
+      d=exp_digit(e[i],win*w,w);
+      if (d==0) continue;
+      if (used[d-1]) mpz_mul(bucket[d-1],bucket[d-1],b[i]);
+      else mpz_set(bucket[d-1],b[i]);
+      mpz_mod(bucket[d-1],bucket[d-1],mod);
+      used[d-1]=1;
+    }
+
+    // run = B[buckets] ... B[d], and c gathers the product of the runs, that is prod_d B[d]^d
+    run_set=0;
+    for (d=buckets ; d>=1 ; d--) {
+      if (used[d-1]) {
+        if (run_set) mpz_mul(run,run,bucket[d-1]);
+        else mpz_set(run,bucket[d-1]);
+        mpz_mod(run,run,mod);
+        run_set=1;
+      }
+      if (run_set) {
+        mpz_mul(c,c,run);
+        mpz_mod(c,c,mod);
+      }
+    }
+  }
+  mpz_mod(c,c,mod);
+
+  for (d=0 ; d<buckets ; d++) mpz_clear(bucket[d]);
+  mpz_clear(run);
+  free(bucket);
+  free(used);
+}
+
+/**
+  * \fn void paillier_enc_dot(mpz_t c, mpz_t * ct, mpz_t * w, int nb, paillier_ctx * ctx)
+  * \brief This function computes an encryption of the dot product of encrypted values by clear weights
+
+  * The result is prod ct[i]^w[i] mod n^2, computed as one multi-exponentiation. Negative weights invert their
+  * ciphertext instead of being reduced to full size exponents. Straus' method or Pippenger's bucket method is
+  * picked with its window width by comparing their numbers of multiplications. The result is not rerandomized:
+  * call paillier_rerandomize before sending it to the key holder if the weights must stay hidden.
+  * To compare it with cmp_Alice_step1_ct, the weighted sum must lie in [0, 2^PARAM_L).
+
+  * \param[out] c   mpz_t representing the encryption of sum w[i] x[i] mod n
+
+  * \param[in] ct   mpz_t array of nb ciphertexts of the x[i]
+  * \param[in] w    mpz_t array of nb weights, may be negative
+  * \param[in] nb   int representing the number of terms
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_enc_dot(mpz_t c, mpz_t * ct, mpz_t * w, int nb, paillier_ctx * ctx) {
+
+  mpz_t * b = calloc(nb,sizeof(mpz_t)), * e = calloc(nb,sizeof(mpz_t));
+  long bits, cost, best_cost = -1;
+  int best_w = 1, pippenger = 0;
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_inits(b[i],e[i],NULL);
+    paillier_signed_exponent(b[i],e[i],ct[i],w[i],ctx);
+  }
+  bits=exp_max_bits(e,nb);
+
+  for (int k=1 ; k<=PAILLIER_DOT_MAX_WINDOW ; k++) {
+    cost=(long) nb*((1<<k)-2)+(long) nb*((bits+k-1)/k);
+    if (best_cost<0 || cost<best_cost) {
+      best_cost=cost;
+      best_w=k;
+    }
+  }
+  for (int k=1 ; k<=PAILLIER_DOT_MAX_BUCKET_WINDOW ; k++) {
+    cost=((bits+k-1)/k)*((long) nb+(2L<<k));
+    if (cost<best_cost) {
+      best_cost=cost;
+      best_w=k;
+      pippenger=1;
+    }
+  }
+
+  if (pippenger) paillier_multi_exp_pippenger(c,b,e,nb,best_w,ctx->n_squared);
+  else paillier_multi_exp_straus(c,b,e,nb,best_w,ctx->n_squared);
+
+  for (int i=0 ; i<nb ; i++) mpz_clears(b[i],e[i],NULL);
+  free(b);
+  free(e);
+}
@@ -0,0 +1,27 @@
+/**
+  * \file paillier_ops.h
+  * \brief Homomorphic operations on Paillier ciphertexts: sums, scalar products and encrypted dot products
+*/
+
+#ifndef PAILLIER_OPS_H
+#define PAILLIER_OPS_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gmp.h"
+#include "parameters.h"
+#include "paillier.h"
+
+void paillier_add(mpz_t c, mpz_t a, mpz_t b, paillier_ctx * ctx);
+void paillier_add_plain(mpz_t c, mpz_t a, mpz_t m, paillier_ctx * ctx);
+void paillier_sub(mpz_t c, mpz_t a, mpz_t b, paillier_ctx * ctx);
+void paillier_mul_scalar(mpz_t c, mpz_t a, mpz_t k, paillier_ctx * ctx);
+void paillier_rerandomize(mpz_t c, mpz_t a, paillier_ctx * ctx);
+
+int paillier_signed_exponent(mpz_t b, mpz_t e, mpz_t a, mpz_t k, paillier_ctx * ctx);
+void paillier_multi_exp_straus(mpz_t c, mpz_t * b, mpz_t * e, int nb, int w, mpz_t mod);
+void paillier_multi_exp_pippenger(mpz_t c, mpz_t * b, mpz_t * e, int nb, int w, mpz_t mod);
+void paillier_enc_dot(mpz_t c, mpz_t * ct, mpz_t * w, int nb, paillier_ctx * ctx);
+
+#endif
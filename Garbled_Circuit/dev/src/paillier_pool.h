@@ -0,0 +1,38 @@
+/**
+  * \file paillier_pool.h
+  * \brief Offline pool of Paillier randomizers refilled by a background thread
+*/
+
+#ifndef PAILLIER_POOL_H
+#define PAILLIER_POOL_H
+
+#include <pthread.h>
+
+#include "gmp.h"
+#include "paillier.h"
+
+/**
+  * \typedef paillier_pool
+  * \brief Structure for a ring of precomputed n-th residues modulo n^2
+  */
+typedef struct paillier_pool {
+  paillier_ctx * ctx ; /**< Key the randomizers are computed for */
+  mpz_t * ring ; /**< Ready randomizers */
+  int depth ; /**< Size of the ring */
+  int low_water ; /**< The worker refills the ring once it holds less than low_water values */
+  int head ; /**< Index of the next randomizer to draw */
+  int count ; /**< Number of ready randomizers */
+  int stop ; /**< Set to 1 to stop the worker */
+  pthread_t worker ; /**< Background refill thread */
+  pthread_mutex_t lock ; /**< Protects the ring, head, count, stop and fallback_seed */
+  pthread_cond_t refill ; /**< Signalled when the ring goes below low_water or on stop */
+  gmp_randstate_t worker_seed ; /**< Random state owned by the worker */
+  gmp_randstate_t fallback_seed ; /**< Random state used when the ring is empty */
+} paillier_pool ;
+
+void paillier_pool_start(paillier_ctx * ctx, int depth, int low_water);
+void paillier_pool_stop(paillier_ctx * ctx);
+void paillier_pool_get(mpz_t rn, paillier_pool * pool);
+void * paillier_pool_worker(void * arg);
+
+#endif
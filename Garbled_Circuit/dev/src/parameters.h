@@ -17,9 +17,16 @@
 //General paramters
 #define PARAM_L 8 /**< Inputs size in bits*/
 #define PARAM_K 40 /**< Expected security level */
-#define KEY_SIZE 256 /**< Key size used for garbling */
+#define KEY_SIZE 128 /**< Key size used for garbling, the size of a block label */
+#define PARAM_SLOT_SIZE (PARAM_L+PARAM_K+2) /**< Size in bits of a slot of a packed Paillier plaintext, with headroom for 2^L + rho - b + a */
+#define PARAM_SLOTS ((PAILLIER_KEY_SIZE-1)/PARAM_SLOT_SIZE) /**< Number of comparisons packed into one Paillier ciphertext */
 //#define HASH_SIZE 32 /**< Hash size */
 
+//Garbling
+#ifndef PARAM_THREE_HALVES
+#define PARAM_THREE_HALVES 0 /**< 1 to garble the AND gates with the three-halves scheme of Rosulek and Roy, 3 half labels and 12 control bits per gate, 0 with half-gates, 2 labels per gate and less hashes (see bench-garbling) */
+#endif
+
 
 //Twisted Edwards curve parameters for OT
 #define TED_CURVE_SIZE 255 /**< size of the ted_curve parameters */
@@ -29,10 +36,38 @@
 #define TED_CURVE_BX "216936D3CD6E53FEC0A4E231FDD6DC5C692CC7609525A7B2C9562D608F25D51A"  /**< generator abscissa */
 #define TED_CURVE_BY "6666666666666666666666666666666666666666666666666666666666666658" /**< generator ordinate */
 
+//Oblivious transfers
+#define PARAM_OT_EXTENSION 1 /**< 1 to run the OTs of the batched comparisons as extensions of OT_EXT_KAPPA base OTs, 0 to run PARAM_L+1 base OTs per comparison */
+#define PARAM_OT_CORRELATED 1 /**< 1 to derive Bob's keys from correlated OTs of the extension with the freeXOR offset, a single value sent per OT, 0 to send both masked keys (ignored without PARAM_OT_EXTENSION, the base OTs always send both) */
+#define PARAM_OT_PRECOMPUTE 1 /**< 1 to precompute random OTs for the batched comparisons before their inputs are known (requires PARAM_OT_EXTENSION), derandomized online */
+#define PARAM_OT_SESSION_USES 256 /**< Number of comparisons with the same party sharing the sender's (y, S, T) of the base OTs before they are drawn again, 0 to never rotate, 1 for new values per comparison */
+#define OT_EXT_KAPPA 128 /**< Number of base OTs of an extension session (computational security), multiple of 8 */
+
 //Paillier private key
 #define PAILLIER_KEY_SIZE 2048 /**< Paillier key size */
+#define PAILLIER_MAX_KEY_SIZE 4096 /**< Largest Paillier modulus the exchanged ciphertext buffers can hold, for keys loaded at runtime */
 #define PAILLIER_SK_P "FCFF1B719A7C3771CEEA224200DDBDD6F930C89FF2B17AF788C031ED5A9A199D48A36AC45257110A750EE0A298600351D273907C48478AB7DA7ECCFD7C67FE7E21CABACB4CBBCF17F76117F4121F450823259F2CD46B0D29B65281E6983D56519FA25536B31B5713E30A47809FD91F8885B20216E5E1AB589489CA4343B0A58B" /**< value p of the paillier secret key*/
 #define PAILLIER_SK_Q "A362293EEE6EAF77459A4625F95012CF2C64E3A2D80396E127C676BC8B275B221D9157899421A4BD1FD951EF56A5E92BB7653573BBC116C5146EFC441466A175F9772C124AF815AA4B149F3303D26949A005AE66EB761C4378F8274F194B6E065276774DD7EAFF21EE1EE9E17A0C9C7AEEB0A3FF2579AE95A23616EFCDC31EC3" /**< value q of the paillier secret key*/
 #define PAILLIER_PK_N "A17770E4E3AAA0A5AAD871A984A93F04AAACF7579B13D92CD765F75513DC9BA4BC652981156C92A3E3771124FA80D1293148895125226D51B0995AFF02857371735F43C5B49A1B2E4749FA1BFE82AC08D493EFACF8C95F5A9C5E8CAB3CDF3BC5B214D7EFF4BFFE8C6EC8B6EA4EEBE3498FAB201235981D9E2F081019FCD048726ECA019D28549E0D2BAA3BA712AF8B44A61E3CC53782E136C19FF19BB91277535A6B95950BC73F4E98CD08F8801A2D055DFC933552B6D6088089F2A19811D9EEC175F6713F114559DFF82DCE8A334B7472091EF09C535607C66B1161B7E7293D93D077B3F36789A3A8814764C0BC55A833A0910B8B78E2577A90760EAAD562E1" /**< value n of the public paillier key*/
 
+//Paillier key generation
+#define PAILLIER_KEYGEN_THREADS 4 /**< Number of threads searching for the primes of a new key */
+#define PAILLIER_KEYGEN_SIEVE_BOUND 65536 /**< Candidates with a prime factor below this bound are discarded before any primality test */
+#define PAILLIER_KEYGEN_SIEVE_SIZE 4096 /**< Number of consecutive odd candidates sieved at once by each thread */
+#define PAILLIER_PRIME_TEST_ITERATIONS 30 /**< Number of Miller-Rabin rounds run on the candidates surviving the sieve */
+
+//Paillier randomizers pool
+#define PAILLIER_POOL_DEPTH 16 /**< Number of randomizers kept ready by the pool */
+#define PAILLIER_POOL_LOW_WATER 4 /**< The pool is refilled once it holds less randomizers than this */
+
+//Paillier encryption mode
+#define PAILLIER_ENC_MODE PAILLIER_MODE_STANDARD /**< PAILLIER_MODE_STANDARD or PAILLIER_MODE_DJN (short exponent randomizers) */
+#define PAILLIER_DJN_EXP_SIZE 256 /**< Size in bits of the DJN short exponents (twice the computational security) */
+#define PAILLIER_DJN_WINDOW 4 /**< Window width in bits of the DJN fixed-base table */
+#define PAILLIER_DJN_WINDOWS ((PAILLIER_DJN_EXP_SIZE+PAILLIER_DJN_WINDOW-1)/PAILLIER_DJN_WINDOW) /**< Number of rows of the DJN fixed-base table */
+
+//Paillier homomorphic operations
+#define PAILLIER_DOT_MAX_WINDOW 6 /**< Largest window width of the Straus multi-exponentiation, each base stores 2^w-1 powers */
+#define PAILLIER_DOT_MAX_BUCKET_WINDOW 16 /**< Largest window width of the Pippenger multi-exponentiation, which stores 2^w-1 buckets */
+
 #endif
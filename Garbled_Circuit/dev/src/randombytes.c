@@ -34,3 +34,40 @@ void random_bytes(uint8_t* bytes_array, uint32_t nb_bytes) {
     nb_bytes -= i;
   }
 }
+
+/**
+  * \fn void random_seed(gmp_randstate_t seed)
+  * \brief This function initializes a GMP random state seeded from the system random generator
+
+  * \param[out] seed the random state to initialize, to be released with gmp_randclear
+*/
+void random_seed(gmp_randstate_t seed) {
+  mpz_t s;
+  uint8_t bytes_array[32];
+  random_bytes(bytes_array,32);
+  mpz_init(s);
+  mpz_import(s,32,-1,1,0,0,bytes_array);
+  gmp_randinit_default(seed);
+  gmp_randseed(seed,s);
+  mpz_clear(s);
+}
+
+/**
+  * \fn void random_mpz_mod(mpz_t r, mpz_t m)
+  * \brief This function draws a random value modulo m from the system random generator
+
+  * 8 more bytes than the size of m are reduced, the bias is below 2^-64. Cheaper than random_seed
+  * for the few values drawn per comparison.
+
+  * \param[out] r mpz_t representing the random value in [0,m)
+  * \param[in]  m mpz_t representing the modulus
+*/
+void random_mpz_mod(mpz_t r, mpz_t m) {
+  size_t nb_bytes = (mpz_sizeinbase(m,2)+7)/8+8;
+  uint8_t * bytes_array = malloc(nb_bytes);
+  random_bytes(bytes_array,nb_bytes);
+  mpz_import(r,nb_bytes,-1,1,0,0,bytes_array);
+  mpz_mod(r,r,m);
+  memset(bytes_array,0,nb_bytes);
+  free(bytes_array);
+}
@@ -7,7 +7,12 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gmp.h"
 
 void random_bytes(uint8_t* bytes_array, uint32_t nb_bytes);
+void random_seed(gmp_randstate_t seed);
+void random_mpz_mod(mpz_t r, mpz_t m);
 
 #endif
\ No newline at end of file
@@ -5,19 +5,21 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "twisted_edwards_curves.h"
+#include "ted_base_table.h"
 
 
 /**
   * \fn ted_point* ted_point_init()
   * \brief This function initializes a twisted Edwards curve  point
 
-  * \return P a ted_point
+  * \return P a ted_point, set to the neutral element
 */
 ted_point* ted_point_init() {
   ted_point* P = (ted_point*) malloc(sizeof(ted_point));
-  mpz_inits(P->x,P->y,NULL);
+  ted_point_set_neutral(P);
   return P;
 }
 
@@ -28,13 +30,12 @@ ted_point* ted_point_init() {
   * \param[in] P the ted_point to free
 */
 void ted_point_clear(ted_point* P) {
-  mpz_clears(P->x,P->y,NULL);
   free(P);
 }
 
 /**
   * \fn void ted_point_set_str(ted_point* P,   char * x,   char * y, int base)
-  * \brief This function sets a point from given strings and bases
+  * \brief This function sets a point from the given strings of its affine coordinates and bases
 
   * \param[out] P    ted_point representing the point to set
 
@@ -43,8 +44,14 @@ void ted_point_clear(ted_point* P) {
   * \param[in] base int representing the base on which the point is setted
 */
 void ted_point_set_str(ted_point* P, char * x, char * y, int base) {
-  mpz_set_str(P->x,x,base);
-  mpz_set_str(P->y,y,base);
+  mpz_t temp;
+  mpz_init_set_str(temp,x,base);
+  fe_set_mpz(P->x,temp);
+  mpz_set_str(temp,y,base);
+  fe_set_mpz(P->y,temp);
+  fe_1(P->z);
+  fe_mul(P->t,P->x,P->y);
+  mpz_clear(temp);
 }
 
 /**
@@ -55,8 +62,89 @@ void ted_point_set_str(ted_point* P, char * x, char * y, int base) {
   * \param[in]  Q   ted_point representing the refererent point
 */
 void ted_point_set(ted_point* P, ted_point* Q) {
-  mpz_set(P->x, Q->x);
-  mpz_set(P->y, Q->y);
+  fe_copy(P->x, Q->x);
+  fe_copy(P->y, Q->y);
+  fe_copy(P->z, Q->z);
+  fe_copy(P->t, Q->t);
+}
+
+/**
+  * \fn void ted_point_set_neutral(ted_point* P)
+  * \brief This function sets a ted_point to the neutral element (0:1:1:0)
+
+  * \param[out] P   ted_point to set
+*/
+void ted_point_set_neutral(ted_point* P) {
+  fe_0(P->x);
+  fe_1(P->y);
+  fe_1(P->z);
+  fe_0(P->t);
+}
+
+/**
+  * \fn void ted_point_normalize(ted_point* P)
+  * \brief This function rewrites a ted_point with Z = 1, so that x and y hold its affine coordinates
+
+  * This is the only inversion of the point arithmetic, done once before a point is encoded or hashed. It is skipped
+  * if Z is already 1.
+
+  * \param[in,out] P   ted_point to normalize
+*/
+void ted_point_normalize(ted_point* P) {
+  fe25519 z_inv;
+  fe_1(z_inv);
+  if (fe_equal(P->z,z_inv)) return;
+  fe_invert(z_inv,P->z);
+  fe_mul(P->x,P->x,z_inv);
+  fe_mul(P->y,P->y,z_inv);
+  fe_mul(P->t,P->x,P->y);
+  fe_1(P->z);
+}
+
+/**
+  * \fn void ted_point_normalize_batch(ted_point** P, int nb)
+  * \brief This function normalizes nb ted_point with a single inversion (Montgomery's trick)
+
+  * The prefix products Z_0 ... Z_(i-1) are kept, their total is inverted once and each 1/Z_i is then recovered
+  * with 2 multiplications, 3(nb-1) multiplications and 1 inversion instead of nb inversions.
+
+  * \param[in,out] P   array of nb ted_point to normalize, none of them with Z = 0
+  * \param[in]     nb  number of points
+*/
+void ted_point_normalize_batch(ted_point** P, int nb) {
+
+  fe25519 * prefix = malloc(nb*sizeof(fe25519));
+  fe25519 acc, z_inv;
+
+  fe_1(acc);
+  for (int i=0 ; i<nb ; i++) {
+    fe_copy(prefix[i],acc);
+    fe_mul(acc,acc,P[i]->z);
+  }
+  fe_invert(acc,acc);
+  for (int i=nb-1 ; i>=0 ; i--) {
+    fe_mul(z_inv,acc,prefix[i]); // 1/Z_i
+    fe_mul(acc,acc,P[i]->z); // 1/(Z_0 ... Z_(i-1))
+    fe_mul(P[i]->x,P[i]->x,z_inv);
+    fe_mul(P[i]->y,P[i]->y,z_inv);
+    fe_mul(P[i]->t,P[i]->x,P[i]->y);
+    fe_1(P[i]->z);
+  }
+  free(prefix);
+}
+
+/**
+  * \fn void ted_point_get_affine(mpz_t x, mpz_t y, ted_point* P)
+  * \brief This function returns the affine coordinates of a ted_point as integers in [0,q)
+
+  * \param[out] x    abscissa of P
+  * \param[out] y    ordinate of P
+  * \param[in,out] P ted_point, normalized in place
+*/
+void ted_point_get_affine(mpz_t x, mpz_t y, ted_point* P) {
+  ted_point_normalize(P);
+  fe_get_mpz(x,P->x);
+  fe_get_mpz(y,P->y);
 }
 
 /**
@@ -67,13 +155,15 @@ void ted_point_set(ted_point* P, ted_point* Q) {
   * \param[in]  P   ted_point representing point to oppose
 */
 void ted_point_opp(ted_point * opP , ted_point * P) {
-  mpz_set(opP->y,P->y);
-  mpz_mul_si(opP->x,P->x,-1);
+  fe_copy(opP->y,P->y);
+  fe_copy(opP->z,P->z);
+  fe_neg(opP->x,P->x);
+  fe_neg(opP->t,P->t);
 }
 
 /**
   * \fn int ted_curve_in(ted_point * P)
-  * \brief This function tests if a given point belong to the curve.
+  * \brief This function tests if a given point belong to the curve, -X²Z²+Y²Z² = Z⁴+dX²Y² and XY = ZT in extended coordinates.
 
   * \param[in] P ted_point representing the point to test
 
@@ -82,208 +172,589 @@ void ted_point_opp(ted_point * opP , ted_point * P) {
   */
 int ted_curve_in(ted_point * P) {
 
-  mpz_t TED_C_Q, TED_C_D,R_x,R_y,temp1,temp2,temp3 ;
-  mpz_inits(TED_C_Q, TED_C_D, R_x,R_y,temp1,temp2,temp3, NULL);
-  mpz_set_str(TED_C_Q,TED_CURVE_Q,16);
-  mpz_set_str(TED_C_D,TED_CURVE_D,16);
-
-  //copy of the inputs values to don't modify them
-  mpz_set(R_x,P->x);
-  mpz_set(R_y,P->y);
-
-  //computation of -x²+y²
-  mpz_powm_ui(temp1,R_x,2,TED_C_Q);
-  mpz_set(temp3,temp1);
-  mpz_mul_si(temp1,temp1,-1);
-  mpz_mod(R_x,R_x,TED_C_Q);
-  mpz_mul(temp2,R_y,R_y);
-  mpz_mod(temp2,temp2,TED_C_Q);
-  mpz_add(R_x,temp2,temp1);
-  mpz_mod(R_x,R_x,TED_C_Q);
-
-  //computation of 1 + d * x² * y²
-  mpz_mul(R_y,temp3,temp2);
-  mpz_mod(R_y,R_y,TED_C_Q);
-  mpz_mul(R_y,R_y,TED_C_D);
-  mpz_mod(R_y,R_y,TED_C_Q);
-  mpz_add_ui(R_y,R_y,1);
-  mpz_mod(R_y,R_y,TED_C_Q);
-
-  //comparison
-  if (mpz_cmp(R_x,R_y)==0) {
-    mpz_clears(TED_C_Q, TED_C_D, R_x,R_y,temp1,temp2,temp3, NULL);
-    return 1;
-  }
-  mpz_clears(TED_C_Q, TED_C_D, R_x,R_y,temp1,temp2,temp3, NULL);
-  return 0;
+  fe25519 X2, Y2, Z2, lhs, rhs;
+
+  fe_sq(X2,P->x);
+  fe_sq(Y2,P->y);
+  fe_sq(Z2,P->z);
+
+  //computation of (-X²+Y²) Z²
+  fe_sub(lhs,Y2,X2);
+  fe_mul(lhs,lhs,Z2);
+
+  //computation of Z⁴ + d X² Y²
+  fe_mul(rhs,X2,Y2);
+  fe_mul(rhs,rhs,FE_D);
+  fe_sq(Z2,Z2);
+  fe_add(rhs,rhs,Z2);
+
+  //comparison, and consistency of T with XY = ZT
+  if (fe_is_zero(P->z) || !fe_equal(lhs,rhs)) return 0;
+  fe_mul(lhs,P->x,P->y);
+  fe_mul(rhs,P->z,P->t);
+  return fe_equal(lhs,rhs);
 }
 
 /**
   * \fn int ted_point_add(ted_point* R, ted_point* P1, ted_point* P2)
   * \brief This function returns the sum of two points
 
-  * \param[out] R ted_point representing the sum of the points
+  * Unified addition in extended coordinates for a = -1 (Hisil, Wong, Carter, Dawson 2008), 8 multiplications
+  * and no inversion. It is also valid when P1 = P2.
+
+  * \param[out] R ted_point representing the sum of the points, may be P1 or P2
 
   * \param[in] P1 ted_point representing the first point to sum
   * \param[in] P2 ted_point representing the second point to sum
 */
 void ted_point_add(ted_point* R, ted_point* P1, ted_point* P2) {
 
-  mpz_t TED_C_Q, TED_C_D, den_x,den_y;
-  mpz_inits(TED_C_Q, TED_C_D, den_x,den_y, NULL);
-  mpz_set_str(TED_C_Q,TED_CURVE_Q,16);
-  mpz_set_str(TED_C_D,TED_CURVE_D,16);
-
-  mpz_mul(R->x,P1->x,P2->y); // x1 * y2
-  mpz_mod(R->x,R->x,TED_C_Q);
-  mpz_mul(R->y,P2->x,P1->y); // x2 * y1
-  mpz_mod(R->y,R->y,TED_C_Q);
-  mpz_mul(den_x,R->x,R->y); // x1*x2*y1*y2
-  mpz_mul(den_x,den_x,TED_C_D); // d * x1 * x2 * y1 * y2
-  mpz_mod(den_x,den_x,TED_C_Q);
-  mpz_set(den_y,den_x); //  d * x1 * x2 * y1 * y2
-
-  mpz_add_ui(den_x,den_x,1); //1 + d * x1 * x2 * y1 * y2
-  mpz_invert(den_x,den_x,TED_C_Q); // (1 + d * x1 * x2 * y1 * y2)^-1
-  mpz_add(R->x,R->x,R->y);// x1 * y2 + x2 * y1
-  mpz_mod(R->x,R->x,TED_C_Q);
-  mpz_mul(R->x,R->x,den_x); //(x1 * y2 + x2 * y1)*(1 + d * x1 * x2 * y1 * y2)^-1
-  mpz_mod(R->x,R->x,TED_C_Q);
-
-  mpz_ui_sub(den_y,1,den_y);// (1 - d * x1 * x2 * y1 * y2)
-  mpz_invert(den_y,den_y,TED_C_Q); // (1 - d * x1 * x2 * y1 * y2)^-1
-  mpz_mul(den_x,P1->x,P2->x);// x1 * x2
-  mpz_mul(R->y,P1->y,P2->y); // y1 * y2
-  mpz_add(R->y,den_x,R->y); // x1 * x2 + y1 * y2
-  mpz_mul(R->y,R->y,den_y); // (x1 * x2 + y1 * y2) * (1 - d * x1 * x2 * y1 * y2)^-1
-  mpz_mod(R->y,R->y,TED_C_Q);
-
-  mpz_clears(TED_C_Q, TED_C_D, den_x,den_y, NULL);
+  fe25519 A, B, C, D, tmp;
+
+  fe_sub(A,P1->y,P1->x);
+  fe_sub(tmp,P2->y,P2->x);
+  fe_mul(A,A,tmp); // A = (Y1-X1)(Y2-X2)
+  fe_add(B,P1->y,P1->x);
+  fe_add(tmp,P2->y,P2->x);
+  fe_mul(B,B,tmp); // B = (Y1+X1)(Y2+X2)
+  fe_mul(C,P1->t,P2->t);
+  fe_mul(C,C,FE_D2); // C = 2d T1 T2
+  fe_mul(D,P1->z,P2->z);
+  fe_add(D,D,D); // D = 2 Z1 Z2
+
+  fe_sub(tmp,B,A); // E = B-A
+  fe_add(B,B,A); // H = B+A
+  fe_sub(A,D,C); // F = D-C
+  fe_add(D,D,C); // G = D+C
+
+  fe_mul(R->x,tmp,A); // X3 = E F
+  fe_mul(R->y,D,B); // Y3 = G H
+  fe_mul(R->t,tmp,B); // T3 = E H
+  fe_mul(R->z,A,D); // Z3 = F G
+}
+
+/**
+  * \fn static void ted_point_double_t(ted_point * R, ted_point * P, int with_t)
+  * \brief This function computes the double of a ted_point, T3 is only computed if it is read afterwards
+
+  * \param[out] R      ted_point representing the computed value, may be P
+  * \param[in]  P      ted_point representing the point to double
+  * \param[in]  with_t 1 to compute T3, 0 if R is doubled again before any addition
+*/
+static void ted_point_double_t(ted_point * R, ted_point * P, int with_t) {
+
+  fe25519 A, B, C, E, G;
+
+  fe_sq(A,P->x); // A = X²
+  fe_sq(B,P->y); // B = Y²
+  fe_sq(C,P->z);
+  fe_add(C,C,C); // C = 2 Z²
+  fe_add(E,P->x,P->y);
+  fe_sq(E,E);
+  fe_sub(E,E,A);
+  fe_sub(E,E,B); // E = (X+Y)² - A - B = 2XY
+
+  fe_sub(G,B,A); // G = -A + B
+  fe_add(A,A,B);
+  fe_neg(A,A); // H = -A - B
+  fe_sub(C,G,C); // F = G - C
+
+  fe_mul(R->x,E,C); // X3 = E F
+  fe_mul(R->y,G,A); // Y3 = G H
+  if (with_t) fe_mul(R->t,E,A); // T3 = E H
+  fe_mul(R->z,C,G); // Z3 = F G
 }
 
 /**
   * \fn void ted_point_double(ted_point * R, ted_point * P)
   * \brief This function computes the double of a ted_point
 
-  * \param[out] R ted_point representing the computed value
+  * Dedicated doubling in extended coordinates for a = -1 (Hisil, Wong, Carter, Dawson 2008), 4 multiplications,
+  * 4 squarings and no inversion. T is not read, so the doubling of a point in projective coordinates works too.
+
+  * \param[out] R ted_point representing the computed value, may be P
 
   * \param[in] P ted_point representing the point to double
 */
 void ted_point_double(ted_point * R, ted_point * P) {
+  ted_point_double_t(R,P,1);
+}
+
+/**
+  * \fn void ted_cached_set(ted_cached * Q, ted_point * P)
+  * \brief This function converts a ted_point to the (Y+X, Y-X, 2Z, 2dT) form of ted_point_add_cached
+
+  * \param[out] Q the converted point
+  * \param[in]  P the ted_point to convert
+*/
+void ted_cached_set(ted_cached * Q, ted_point * P) {
+  fe_add(Q->yplusx,P->y,P->x);
+  fe_sub(Q->yminusx,P->y,P->x);
+  fe_add(Q->z2,P->z,P->z);
+  fe_mul(Q->t2d,P->t,FE_D2);
+}
+
+/**
+  * \fn void ted_point_add_cached(ted_point* R, ted_point* P, const ted_cached * Q)
+  * \brief This function adds a point in cached form to a ted_point
+
+  * Same formulas as ted_point_add, the sums and the products by 2 and 2d of the second point are precomputed.
+
+  * \param[out] R ted_point representing the sum, may be P
+  * \param[in]  P ted_point in extended coordinates
+  * \param[in]  Q point to add, in cached form
+*/
+void ted_point_add_cached(ted_point* R, ted_point* P, const ted_cached * Q) {
+
+  fe25519 A, B, C, D, E;
+
+  fe_sub(A,P->y,P->x);
+  fe_mul(A,A,Q->yminusx); // A = (Y1-X1)(Y2-X2)
+  fe_add(B,P->y,P->x);
+  fe_mul(B,B,Q->yplusx); // B = (Y1+X1)(Y2+X2)
+  fe_mul(C,P->t,Q->t2d); // C = 2d T1 T2
+  fe_mul(D,P->z,Q->z2); // D = 2 Z1 Z2
+
+  fe_sub(E,B,A); // E = B-A
+  fe_add(B,B,A); // H = B+A
+  fe_sub(A,D,C); // F = D-C
+  fe_add(D,D,C); // G = D+C
+
+  fe_mul(R->x,E,A); // X3 = E F
+  fe_mul(R->y,D,B); // Y3 = G H
+  fe_mul(R->t,E,B); // T3 = E H
+  fe_mul(R->z,A,D); // Z3 = F G
+}
+
+/**
+  * \fn void ted_point_sub_cached(ted_point* R, ted_point* P, const ted_cached * Q)
+  * \brief This function subtracts a point in cached form from a ted_point
+
+  * -Q = (-X2, Y2, Z2, -T2), so Y2+X2 and Y2-X2 are swapped and the sign of C is changed.
 
-  mpz_t TED_C_Q, TED_C_D, x2, y2, den_x,den_y;
-  mpz_inits(TED_C_Q, TED_C_D, x2, y2, den_x,den_y, NULL);
-  mpz_set_str(TED_C_Q,TED_CURVE_Q,16);
-  mpz_set_str(TED_C_D,TED_CURVE_D,16);
-
-  mpz_powm_ui(x2,P->x,2,TED_C_Q);
-  mpz_powm_ui(y2,P->y,2,TED_C_Q);
-
-  mpz_mul(R->x,P->x,P->y); //rx = x * y
-  mpz_mul_ui(R->x,R->x,2); //rx = 2 * x * y mod q = x * y
-  mpz_mod(R->x,R->x,TED_C_Q); //rx = 2xy mod q = 2xy
-
-  mpz_sub(den_x,y2,x2); // den_x = y2 - x2
-  mpz_mod(den_x,den_x,TED_C_Q);
-  mpz_invert(R->y,den_x,TED_C_Q); //ry = (y2-x2)^(-1)
-  mpz_mul(R->x,R->x,R->y); // 2xy * (y2-x2)^(-1)
-  mpz_mod(R->x,R->x,TED_C_Q);
-
-  mpz_add(R->y,y2,x2);
-  mpz_mod(R->y,R->y,TED_C_Q);
-  mpz_ui_sub(den_y,2,den_x);
-  mpz_mod(den_y,den_y,TED_C_Q);
-  mpz_invert(den_y,den_y,TED_C_Q);
-  mpz_mul(R->y,R->y,den_y);
-  mpz_mod(R->y,R->y,TED_C_Q);
-
-  mpz_clears(TED_C_Q, TED_C_D, x2, y2, den_x,den_y, NULL);
+  * \param[out] R ted_point representing the difference, may be P
+  * \param[in]  P ted_point in extended coordinates
+  * \param[in]  Q point to subtract, in cached form
+*/
+void ted_point_sub_cached(ted_point* R, ted_point* P, const ted_cached * Q) {
+
+  fe25519 A, B, C, D, E;
+
+  fe_sub(A,P->y,P->x);
+  fe_mul(A,A,Q->yplusx); // A = (Y1-X1)(Y2+X2)
+  fe_add(B,P->y,P->x);
+  fe_mul(B,B,Q->yminusx); // B = (Y1+X1)(Y2-X2)
+  fe_mul(C,P->t,Q->t2d); // -C = 2d T1 T2
+  fe_mul(D,P->z,Q->z2); // D = 2 Z1 Z2
+
+  fe_sub(E,B,A); // E = B-A
+  fe_add(B,B,A); // H = B+A
+  fe_add(A,D,C); // F = D-C
+  fe_sub(D,D,C); // G = D+C
+
+  fe_mul(R->x,E,A); // X3 = E F
+  fe_mul(R->y,D,B); // Y3 = G H
+  fe_mul(R->t,E,B); // T3 = E H
+  fe_mul(R->z,A,D); // Z3 = F G
+}
+
+/**
+  * \fn int ted_wnaf(signed char * naf, mpz_t s, int w)
+  * \brief This function writes the width-w non-adjacent form of |s|, |s| = sum naf[i] 2^i
+
+  * Every non-zero digit is odd, lies in ]-2^(w-1),2^(w-1)[ and is followed by at least w-1 zero digits.
+
+  * \param[out] naf array of at least mpz_sizeinbase(s,2)+1 digits
+  * \param[in]  s   mpz_t representing the scalar value, its sign is ignored
+  * \param[in]  w   width, between 2 and 8
+
+  * \return the number of digits written, the last one is non-zero
+*/
+int ted_wnaf(signed char * naf, mpz_t s, int w) {
+
+  int bits = mpz_sizeinbase(s,2), len = 0, carry = 0, pos = 0, window;
+  int nb_bytes = (bits+7)/8 + 2;
+  uint8_t a[nb_bytes];
+
+  memset(a,0,nb_bytes);
+  memset(naf,0,bits+1);
+  mpz_export(a,NULL,-1,1,0,0,s);
+
+  while (pos<=bits) {
+    // w bits of |s| starting at pos, plus the carry of the previous digit
+    window = ((a[pos/8] | (a[pos/8+1] << 8)) >> (pos%8)) & ((1<<w)-1);
+    window += carry;
+    if ((window & 1)==0) {
+      pos++;
+      continue;
+    }
+    if (window < (1<<(w-1))) {
+      naf[pos] = window;
+      carry = 0;
+    }
+    else {
+      naf[pos] = window - (1<<w);
+      carry = 1;
+    }
+    len = pos+1;
+    pos += w;
+  }
+  return len;
+}
+
+/**
+  * \fn static void ted_wnaf_table(ted_cached * table, ted_point * P)
+  * \brief This function computes the odd multiples table[k] = (2k+1) P, k < TED_WNAF_MULTIPLES, in cached form
+
+  * \param[out] table the TED_WNAF_MULTIPLES odd multiples of P
+  * \param[in]  P     ted_point to multiply
+*/
+static void ted_wnaf_table(ted_cached * table, ted_point * P) {
+
+  ted_cached P2;
+  ted_point T;
+
+  ted_point_double(&T,P);
+  ted_cached_set(&P2,&T);
+  ted_point_set(&T,P);
+  ted_cached_set(&table[0],&T);
+  for (int k=1 ; k<TED_WNAF_MULTIPLES ; k++) {
+    ted_point_add_cached(&T,&T,&P2);
+    ted_cached_set(&table[k],&T);
+  }
 }
 
 /**
   * \fn int ted_point_mult(ted_point * out, ted_point * P, mpz_t s)
   * \brief This function computes the product of a scalar and a point
 
-  * \param[out] out ted_point representing the computed point
+  * Left to right width-w NAF, with TED_WNAF_WIDTH = 5: the odd multiples P, 3P, ..., 15P are computed first, then
+  * each bit costs a doubling and one digit in six on average an addition or a subtraction of one of them. T is only
+  * computed by the doublings followed by an addition and by the last one.
+
+  * \param[out] out ted_point representing the computed point, may be P
   * \param[in] P    ted_point representing the ted_point to multiply
   * \param[in] s    mpz_t representing the scalar value
-
-  * \return -1 if P is not on the twisted Edwards curve
-  * \return 0  if the computation succeed
 */
 void ted_point_mult(ted_point * out, ted_point * P, mpz_t s) {
 
-  ted_point* T=ted_point_init();
-  mpz_set_ui(T->y,1); //Initialisation of T as neutral element
-  for (int i=mpz_sizeinbase(s,2)-1 ; i>=0 ; i--) {
-    ted_point_double(out,T);
-    mpz_set(T->x,out->x);
-    mpz_set(T->y,out->y);
-    if (mpz_tstbit(s,i)==1) {
-      ted_point_add(out,P,T);
-      mpz_set(T->x,out->x);
-      mpz_set(T->y,out->y);
+  ted_cached table[TED_WNAF_MULTIPLES];
+  ted_point T;
+  signed char naf[mpz_sizeinbase(s,2)+1];
+  int len = ted_wnaf(naf,s,TED_WNAF_WIDTH);
+
+  ted_wnaf_table(table,P);
+  ted_point_set_neutral(&T);
+  for (int i=len-1 ; i>=0 ; i--) {
+    ted_point_double_t(&T,&T,naf[i]!=0 || i==0);
+    if (naf[i]>0) ted_point_add_cached(&T,&T,&table[naf[i]/2]);
+    else if (naf[i]<0) ted_point_sub_cached(&T,&T,&table[(-naf[i])/2]);
+  }
+  if (mpz_sgn(s)<0) ted_point_opp(&T,&T);
+  ted_point_set(out,&T);
+}
+
+/**
+  * \fn void ted_point_mult_batch(ted_point ** out, ted_point ** P, int nb, mpz_t s)
+  * \brief This function computes out[i] = s P[i] for nb points and a single scalar
+
+  * The scalar is recoded once and the points are processed by groups of TED_BATCH_CHUNK, every point of a group
+  * following the same sequence of doublings, additions and subtractions as ted_point_mult.
+
+  * \param[out] out array of nb ted_point, out[i] may be P[i]
+  * \param[in]  P   array of nb ted_point to multiply
+  * \param[in]  nb  number of points, any size
+  * \param[in]  s   mpz_t representing the scalar value
+*/
+void ted_point_mult_batch(ted_point ** out, ted_point ** P, int nb, mpz_t s) {
+
+  ted_cached table[TED_BATCH_CHUNK][TED_WNAF_MULTIPLES];
+  ted_point T[TED_BATCH_CHUNK];
+  signed char naf[mpz_sizeinbase(s,2)+1];
+  int len = ted_wnaf(naf,s,TED_WNAF_WIDTH), m;
+
+  for (int c=0 ; c<nb ; c+=TED_BATCH_CHUNK) {
+    m = (nb-c < TED_BATCH_CHUNK) ? nb-c : TED_BATCH_CHUNK;
+    for (int j=0 ; j<m ; j++) {
+      ted_wnaf_table(table[j],P[c+j]);
+      ted_point_set_neutral(&T[j]);
+    }
+
+    for (int i=len-1 ; i>=0 ; i--) {
+      int d = naf[i];
+      for (int j=0 ; j<m ; j++) ted_point_double_t(&T[j],&T[j],d!=0 || i==0);
+      if (d>0) for (int j=0 ; j<m ; j++) ted_point_add_cached(&T[j],&T[j],&table[j][d/2]);
+      else if (d<0) for (int j=0 ; j<m ; j++) ted_point_sub_cached(&T[j],&T[j],&table[j][(-d)/2]);
+    }
+
+    for (int j=0 ; j<m ; j++) {
+      if (mpz_sgn(s)<0) ted_point_opp(&T[j],&T[j]);
+      ted_point_set(out[c+j],&T[j]);
+    }
+  }
+}
+
+/**
+  * \fn void ted_precomp_set(ted_precomp * Q, ted_point * P)
+  * \brief This function converts a ted_point to the (y+x, y-x, 2dxy) form of the mixed addition
+
+  * \param[out]    Q the converted point
+  * \param[in,out] P the ted_point to convert, normalized in place
+*/
+void ted_precomp_set(ted_precomp * Q, ted_point * P) {
+  ted_point_normalize(P);
+  fe_add(Q->yplusx,P->y,P->x);
+  fe_sub(Q->yminusx,P->y,P->x);
+  fe_mul(Q->xy2d,P->t,FE_D2);
+}
+
+/**
+  * \fn void ted_point_add_precomp(ted_point* R, ted_point* P, const ted_precomp * Q)
+  * \brief This function adds an affine point in (y+x, y-x, 2dxy) form to a ted_point
+
+  * Same formulas as ted_point_add with Z2 = 1 and the products of the second point precomputed, 7 multiplications.
+
+  * \param[out] R ted_point representing the sum, may be P
+  * \param[in]  P ted_point in extended coordinates
+  * \param[in]  Q precomputed affine point
+*/
+void ted_point_add_precomp(ted_point* R, ted_point* P, const ted_precomp * Q) {
+
+  fe25519 A, B, C, D, E;
+
+  fe_sub(A,P->y,P->x);
+  fe_mul(A,A,Q->yminusx); // A = (Y1-X1)(y2-x2)
+  fe_add(B,P->y,P->x);
+  fe_mul(B,B,Q->yplusx); // B = (Y1+X1)(y2+x2)
+  fe_mul(C,P->t,Q->xy2d); // C = 2d T1 x2 y2
+  fe_add(D,P->z,P->z); // D = 2 Z1
+
+  fe_sub(E,B,A); // E = B-A
+  fe_add(B,B,A); // H = B+A
+  fe_sub(A,D,C); // F = D-C
+  fe_add(D,D,C); // G = D+C
+
+  fe_mul(R->x,E,A); // X3 = E F
+  fe_mul(R->y,D,B); // Y3 = G H
+  fe_mul(R->t,E,B); // T3 = E H
+  fe_mul(R->z,A,D); // Z3 = F G
+}
+
+/**
+  * \fn static void ted_table_select(ted_precomp * Q, const ted_precomp * row, int digit)
+  * \brief This function reads digit 16^i P from row i of a fixed-base table, digit in [-8,8]
+
+  * All the entries of the row are read and the right one is kept with conditional moves, so that the memory
+  * accesses do not depend on the secret scalar.
+
+  * \param[out] Q     the selected point, the neutral element for digit 0
+  * \param[in]  row   the TED_BASE_MULTIPLES entries j 16^i P of the row
+  * \param[in]  digit signed digit of the scalar
+*/
+static void ted_table_select(ted_precomp * Q, const ted_precomp * row, int digit) {
+
+  int neg = (digit >> 8) & 1;
+  int abs = digit - ((-neg & digit) << 1);
+  fe25519 minus_xy2d;
+
+  fe_1(Q->yplusx);
+  fe_1(Q->yminusx);
+  fe_0(Q->xy2d);
+  for (int j=1 ; j<=TED_BASE_MULTIPLES ; j++) {
+    int eq = ((unsigned) (abs ^ j) - 1) >> 31;
+    fe_cmov(Q->yplusx,row[j-1].yplusx,eq);
+    fe_cmov(Q->yminusx,row[j-1].yminusx,eq);
+    fe_cmov(Q->xy2d,row[j-1].xy2d,eq);
+  }
+
+  // -(x,y) = (-x,y) swaps y+x and y-x and negates 2dxy
+  fe_copy(minus_xy2d,Q->yplusx);
+  fe_cmov(Q->yplusx,Q->yminusx,neg);
+  fe_cmov(Q->yminusx,minus_xy2d,neg);
+  fe_neg(minus_xy2d,Q->xy2d);
+  fe_cmov(Q->xy2d,minus_xy2d,neg);
+}
+
+/**
+  * \fn void ted_table_set(ted_precomp * table, ted_point * P)
+  * \brief This function builds the fixed-base table of a point P, table[i*TED_BASE_MULTIPLES+j-1] = j 16^i P
+
+  * Same layout as TED_BASE_TABLE, the TED_BASE_ROWS*TED_BASE_MULTIPLES points are normalized with a single inversion.
+  * Worth it for a point multiplied by many scalars, such as the point S of an OT_receiver_session.
+
+  * \param[out] table array of TED_BASE_ROWS*TED_BASE_MULTIPLES ted_precomp
+  * \param[in]  P     ted_point of the table
+*/
+void ted_table_set(ted_precomp * table, ted_point * P) {
+
+  int nb = TED_BASE_ROWS*TED_BASE_MULTIPLES;
+  ted_point ** jP = calloc(nb,sizeof(ted_point *));
+  ted_point * row = ted_point_init();
+
+  ted_point_set(row,P);
+  for (int i=0 ; i<TED_BASE_ROWS ; i++) {
+    for (int j=0 ; j<TED_BASE_MULTIPLES ; j++) {
+      jP[i*TED_BASE_MULTIPLES+j] = ted_point_init();
+      if (j==0) ted_point_set(jP[i*TED_BASE_MULTIPLES],row);
+      else ted_point_add(jP[i*TED_BASE_MULTIPLES+j],jP[i*TED_BASE_MULTIPLES+j-1],row);
     }
+    for (int k=0 ; k<TED_BASE_WINDOW ; k++) ted_point_double(row,row);
+  }
+  ted_point_normalize_batch(jP,nb);
+
+  for (int i=0 ; i<nb ; i++) {
+    ted_precomp_set(&table[i],jP[i]);
+    ted_point_clear(jP[i]);
   }
-  ted_point_clear(T);
+  ted_point_clear(row);
+  free(jP);
+}
+
+/**
+  * \fn void ted_point_mult_table(ted_point * out, const ted_precomp * table, mpz_t s)
+  * \brief This function computes s P with the fixed-base table of P built by ted_table_set
+
+  * s is written with 64 signed digits e_i in [-8,8], s = sum e_i 16^i, and s P is the sum of the 64 table entries
+  * e_i 16^i P: 64 mixed additions and no doubling. Scalars outside [0,2^255) are first reduced modulo the order of B.
+
+  * \param[out] out   ted_point representing s P
+  * \param[in]  table fixed-base table of P, TED_BASE_ROWS*TED_BASE_MULTIPLES entries
+  * \param[in]  s     mpz_t representing the scalar value
+*/
+void ted_point_mult_table(ted_point * out, const ted_precomp * table, mpz_t s) {
+
+  uint8_t a[FE_BYTES] = {0};
+  signed char e[2*FE_BYTES];
+  int carry = 0;
+  ted_precomp Q;
+
+  if (mpz_sgn(s)<0 || mpz_sizeinbase(s,2)>TED_CURVE_SIZE) {
+    mpz_t TED_C_P, r;
+    mpz_init_set_str(TED_C_P,TED_CURVE_P,16);
+    mpz_init(r);
+    mpz_mod(r,s,TED_C_P);
+    mpz_export(a,NULL,-1,1,0,0,r);
+    mpz_clears(TED_C_P,r,NULL);
+  }
+  else mpz_export(a,NULL,-1,1,0,0,s);
+
+  for (int i=0 ; i<FE_BYTES ; i++) {
+    e[2*i] = a[i] & 15;
+    e[2*i+1] = a[i] >> 4;
+  }
+  // recentering of the digits from [0,15] to [-8,7], the last one is at most 8 since s < 2^255
+  for (int i=0 ; i<TED_BASE_ROWS-1 ; i++) {
+    e[i] += carry;
+    carry = (e[i] + 8) >> TED_BASE_WINDOW;
+    e[i] -= carry << TED_BASE_WINDOW;
+  }
+  e[TED_BASE_ROWS-1] += carry;
+
+  ted_point_set_neutral(out);
+  for (int i=0 ; i<TED_BASE_ROWS ; i++) {
+    ted_table_select(&Q,&table[i*TED_BASE_MULTIPLES],e[i]);
+    ted_point_add_precomp(out,out,&Q);
+  }
+}
+
+/**
+  * \fn void ted_point_mult_base(ted_point * out, mpz_t s)
+  * \brief This function computes s B for the generator B of the curve with the fixed-base table TED_BASE_TABLE
+
+  * \param[out] out ted_point representing s B
+  * \param[in]  s   mpz_t representing the scalar value
+*/
+void ted_point_mult_base(ted_point * out, mpz_t s) {
+  ted_point_mult_table(out,&TED_BASE_TABLE[0][0],s);
 }
 
 /**
   * \fn void ted_encode(uint8_t * enc, ted_point * P)
-  * \brief This function encodes a ted_point into a 256 bits
+  * \brief This function encodes a ted_point into a 256 bits, 2y + (x mod 2) in little endian
 
-  * \param[out] enc the encoding of a ted_point
+  * \param[out] enc the encoding of a ted_point, 32 bytes
 
-  * \param[in] P the ted_point to encode
+  * \param[in,out] P the ted_point to encode, normalized in place
 */
 void ted_encode(uint8_t * enc, ted_point * P) {
-  mpz_t temp, a,z,e,r;
-  mpz_inits(temp,a,z,e,r,NULL);
-
-  mpz_set(temp,P->y);
-  mpz_mul_ui(temp,temp,2);
-  mpz_add_ui(temp,temp,mpz_tstbit(P->x,0));
-  mpz_export(enc,NULL,-1,1,0,0,temp);
-  mpz_clears(temp,a,z,e,r,NULL);
+  uint8_t s[FE_BYTES];
+
+  ted_point_normalize(P);
+  fe_to_bytes(s,P->y);
+  for (int i=FE_BYTES-1 ; i>0 ; i--) enc[i] = (s[i] << 1) | (s[i-1] >> 7);
+  enc[0] = (s[0] << 1) | fe_is_odd(P->x);
 }
 
 /**
-  * \fn void ted_decode(ted_point * P, uint8_t * enc)
-  * \brief This function retrieves a ted_point from an encoded point
+  * \fn void ted_encode_batch(uint8_t ** enc, ted_point ** P, int nb)
+  * \brief This function encodes nb ted_point, normalized together with a single inversion
 
-  * \param[out] P the decoded ted_point
-  
-  * \param[in] enc the encoded ted_point
+  * \param[out]    enc array of nb encodings of 32 bytes
+  * \param[in,out] P   array of nb ted_point to encode, normalized in place
+  * \param[in]     nb  number of points
 */
-void ted_decode(ted_point * P,   uint8_t * enc) {
+void ted_encode_batch(uint8_t ** enc, ted_point ** P, int nb) {
+  ted_point_normalize_batch(P,nb);
+  for (int i=0 ; i<nb ; i++) ted_encode(enc[i],P[i]);
+}
+
+/**
+  * \fn int ted_decode(ted_point * P, uint8_t * enc)
+  * \brief This function retrieves a ted_point from an encoded point and checks that it belongs to the curve
 
-  mpz_t TED_C_Q, TED_C_D, r,a,y_square,E ;
-  mpz_inits(TED_C_Q, TED_C_D, r,a,y_square,E,NULL);
-  mpz_set_str(TED_C_Q,TED_CURVE_Q,16);
-  mpz_set_str(TED_C_D,TED_CURVE_D,16);
+  * x is a square root of (y²-1)/(dy²+1) with the encoded parity, computed by fe_sqrt_ratio without inversion.
+  * When it exists, (x,y) is on the curve by construction and no further check is needed. If there is none,
+  * x is left off the curve so that ted_curve_in rejects the point too. Only the canonical encoding of a point
+  * is accepted: y must be below p, and the sign bit must be 0 when x is 0.
 
-  mpz_sub_ui(a,TED_C_Q,1);
-  mpz_cdiv_q_ui(a,a,2);
-  mpz_import(E,1,-1,32,0,0,enc);
-  int sign = mpz_tstbit(E,0);
-  mpz_sub_ui(E,E,mpz_tstbit(E,0));
-  mpz_cdiv_q_ui(P->y,E,2);
-  mpz_powm_ui(y_square,P->y,2,TED_C_Q);
+  * \param[out] P the decoded ted_point
 
-  mpz_sub_ui(r,y_square,1); // y²-1
+  * \param[in] enc the encoded ted_point, 32 bytes
 
-  mpz_mul(y_square,y_square,TED_C_D);
-  mpz_add_ui(y_square,y_square,1);
-  mpz_mod(y_square,y_square,TED_C_Q);
+  * \return 1 if enc is the encoding of a point of the curve
+  * \return 0 otherwise
+*/
+int ted_decode(ted_point * P,   uint8_t * enc) {
+
+  uint8_t s[FE_BYTES], canonical[FE_BYTES], diff = 0;
+  fe25519 u, v;
+  int sign = enc[0] & 1, valid;
+
+  for (int i=0 ; i<FE_BYTES-1 ; i++) s[i] = (enc[i] >> 1) | (enc[i+1] << 7);
+  s[FE_BYTES-1] = enc[FE_BYTES-1] >> 1;
+  fe_from_bytes(P->y,s);
+  // a y >= p stands for y - p, whose canonical bytes differ from s
+  fe_to_bytes(canonical,P->y);
+  for (int i=0 ; i<FE_BYTES ; i++) diff |= s[i] ^ canonical[i];
+
+  fe_sq(u,P->y);
+  fe_mul(v,u,FE_D);
+  fe_1(P->z);
+  fe_sub(u,u,P->z); // y²-1
+  fe_add(v,v,P->z); // dy²+1, never 0 since -1/d is not a square
+  valid = fe_sqrt_ratio(P->x,u,v);
+  valid &= (diff == 0) & !(fe_is_zero(P->x) & sign);
+
+  if (fe_is_odd(P->x)!=sign) fe_neg(P->x,P->x);
+  fe_mul(P->t,P->x,P->y);
+  return valid;
+}
 
-  mpz_invert(y_square,y_square,TED_C_Q);
-  mpz_mul(r,r,y_square);
-  mpz_mod(r,r,TED_C_Q);
-  mpz_quad_res(P->x,r,TED_C_Q);
+/**
+  * \fn int ted_decode_batch(ted_point ** P, uint8_t ** enc, int nb)
+  * \brief This function decodes and checks nb encoded points
 
-  if (mpz_tstbit(P->x,0)!=sign) mpz_mul_si(P->x,P->x,-1);
-  mpz_mod(P->x,P->x,TED_C_Q);
+  * Every point is decoded, even after an invalid one, so that the running time does not reveal which one failed.
 
-  mpz_clears(TED_C_Q, TED_C_D, r,a,y_square,E,NULL);
+  * \param[out] P   array of nb decoded ted_point
+  * \param[in]  enc array of nb encodings of 32 bytes
+  * \param[in]  nb  number of points
 
+  * \return 1 if all the encodings are points of the curve
+  * \return 0 otherwise
+*/
+int ted_decode_batch(ted_point ** P, uint8_t ** enc, int nb) {
+  int valid = 1;
+  for (int i=0 ; i<nb ; i++) valid &= ted_decode(P[i],enc[i]);
+  return valid;
 }
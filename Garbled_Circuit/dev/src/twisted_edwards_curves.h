@@ -8,22 +8,60 @@
 
 #include <gmp.h>
 #include "auxiliary_functions.h"
+#include "field_25519.h"
 
 /**
   * \typedef ted_point
-  * \brief Structure of a point of an Twisted Edwards Curve
+  * \brief Structure of a point of an Twisted Edwards Curve in extended coordinates (X:Y:Z:T)
+
+  * The affine point is (X/Z, Y/Z) and T = XY/Z. After ted_point_normalize, Z = 1 and x, y hold the affine coordinates.
+  * The coordinates are elements of GF(2^255-19) stored in the structure, so the point arithmetic never allocates.
   */
 typedef struct ted_point{
-  mpz_t x ; /**< First coordinate of the point */
-  mpz_t y ; /**< Second coordinate of the point */
+  fe25519 x ; /**< First coordinate of the point, X */
+  fe25519 y ; /**< Second coordinate of the point, Y */
+  fe25519 z ; /**< Projective coordinate Z */
+  fe25519 t ; /**< Auxiliary coordinate T = XY/Z */
 } ted_point;
 
+#define TED_BASE_WINDOW 4 /**< number of bits of a signed digit of the fixed-base multiplication */
+#define TED_BASE_ROWS 64 /**< number of digits of a scalar below 2^255, one table row per digit */
+#define TED_BASE_MULTIPLES 8 /**< multiples j 16^i B, 1 <= j <= 8, stored in row i of the table */
+#define TED_WNAF_WIDTH 5 /**< width of the NAF of the variable-base multiplication, odd digits in ]-2^(w-1),2^(w-1)[ */
+#define TED_WNAF_MULTIPLES (1<<(TED_WNAF_WIDTH-2)) /**< number of odd multiples P, 3P, ..., (2^(w-1)-1)P precomputed */
+#define TED_BATCH_CHUNK 16 /**< number of points processed together by ted_point_mult_batch, their tables stay on the stack */
+
+/**
+  * \typedef ted_precomp
+  * \brief Affine point stored as (y+x, y-x, 2dxy), the form read by the mixed addition ted_point_add_precomp
+  */
+typedef struct ted_precomp{
+  fe25519 yplusx ; /**< y+x */
+  fe25519 yminusx ; /**< y-x */
+  fe25519 xy2d ; /**< 2dxy */
+} ted_precomp;
+
+/**
+  * \typedef ted_cached
+  * \brief Point in extended coordinates stored as (Y+X, Y-X, 2Z, 2dT), the form read by ted_point_add_cached
+  */
+typedef struct ted_cached{
+  fe25519 yplusx ; /**< Y+X */
+  fe25519 yminusx ; /**< Y-X */
+  fe25519 z2 ; /**< 2Z */
+  fe25519 t2d ; /**< 2dT */
+} ted_cached;
+
 
 ted_point* ted_point_init();
 void ted_point_clear(ted_point* P);
 
 void ted_point_set_str(ted_point *P, char* x, char* y, int base);
 void ted_point_set(ted_point* P, ted_point* Q);
+void ted_point_set_neutral(ted_point* P);
+void ted_point_normalize(ted_point* P);
+void ted_point_normalize_batch(ted_point** P, int nb);
+void ted_point_get_affine(mpz_t x, mpz_t y, ted_point* P);
 
 int ted_curve_in(ted_point * P);
 
@@ -31,9 +69,23 @@ void ted_point_opp(ted_point * opP , ted_point * P);
 
 void ted_point_add(ted_point* R, ted_point* P1, ted_point* P2);
 void ted_point_mult(ted_point* out, ted_point* P, mpz_t s);
+void ted_point_mult_batch(ted_point** out, ted_point** P, int nb, mpz_t s);
+
+void ted_cached_set(ted_cached * Q, ted_point * P);
+void ted_point_add_cached(ted_point* R, ted_point* P, const ted_cached * Q);
+void ted_point_sub_cached(ted_point* R, ted_point* P, const ted_cached * Q);
+int ted_wnaf(signed char * naf, mpz_t s, int w);
+
+void ted_precomp_set(ted_precomp * Q, ted_point * P);
+void ted_point_add_precomp(ted_point* R, ted_point* P, const ted_precomp * Q);
+void ted_table_set(ted_precomp * table, ted_point * P);
+void ted_point_mult_table(ted_point* out, const ted_precomp * table, mpz_t s);
+void ted_point_mult_base(ted_point* out, mpz_t s);
 void ted_point_double(ted_point * R, ted_point * P);
 
 void ted_encode( uint8_t * enc_P , ted_point * P);
-void ted_decode(ted_point * P, uint8_t * enc);
+void ted_encode_batch(uint8_t ** enc, ted_point ** P, int nb);
+int ted_decode(ted_point * P, uint8_t * enc);
+int ted_decode_batch(ted_point ** P, uint8_t ** enc, int nb);
 
 #endif
@@ -0,0 +1,23 @@
+/**
+  * \file bench.h
+  * \brief Cycle counter and number of runs shared by the benchmarks
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS 5 /**< Number of runs a measure is averaged over, a benchmark can define its own before including this file */
+#endif
+
+/**
+  * \fn static inline unsigned long long cpucycles(void)
+  * \brief This function returns the time stamp counter of the processor
+*/
+static inline unsigned long long cpucycles(void) {
+  unsigned long long result;
+  __asm__ volatile(".byte 15;.byte 49;shlq $32,%%rdx;orq %%rdx,%%rax" : "=a" (result) :: "%rdx");
+  return result;
+}
+
+#endif
@@ -0,0 +1,177 @@
+#include "../src/parameters.h"
+#include "../src/circuit.h"
+#include "../src/aes_hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+
+#define BENCH_WIDTH 32 /**< size in bits of the values of the equality, addition and maximum circuits */
+
+/**
+  * \fn uint64_t bits_get(const uint8_t * bits, int n)
+  * \brief This function returns the value of n bits, least significant first
+*/
+uint64_t bits_get(const uint8_t * bits, int n) {
+  uint64_t v=0;
+  for (int i=n-1 ; i>=0 ; i--) v=2*v+bits[i];
+  return v;
+}
+
+/**
+  * \fn int ref_cmp(const uint8_t * in, const uint8_t * out)
+  * \brief This function checks the output of circuit_cmp(PARAM_L, PARAM_INEQ)
+*/
+int ref_cmp(const uint8_t * in, const uint8_t * out) {
+  uint64_t a=bits_get(in,PARAM_L), b=bits_get(in+PARAM_L+1,PARAM_L);
+  int r=(PARAM_INEQ % 4 > 1) ? (a<b) : (a>b);
+  return out[0]==(r^in[PARAM_L]^in[2*PARAM_L+1]);
+}
+
+/**
+  * \fn int ref_eq(const uint8_t * in, const uint8_t * out)
+  * \brief This function checks the output of circuit_eq(BENCH_WIDTH)
+*/
+int ref_eq(const uint8_t * in, const uint8_t * out) {
+  return out[0]==(bits_get(in,BENCH_WIDTH)==bits_get(in+BENCH_WIDTH,BENCH_WIDTH));
+}
+
+/**
+  * \fn int ref_add(const uint8_t * in, const uint8_t * out)
+  * \brief This function checks the output of circuit_add(BENCH_WIDTH)
+*/
+int ref_add(const uint8_t * in, const uint8_t * out) {
+  return bits_get(out,BENCH_WIDTH+1)==bits_get(in,BENCH_WIDTH)+bits_get(in+BENCH_WIDTH,BENCH_WIDTH);
+}
+
+/**
+  * \fn int ref_max(const uint8_t * in, const uint8_t * out)
+  * \brief This function checks the output of circuit_max(BENCH_WIDTH)
+*/
+int ref_max(const uint8_t * in, const uint8_t * out) {
+  uint64_t a=bits_get(in,BENCH_WIDTH), b=bits_get(in+BENCH_WIDTH,BENCH_WIDTH);
+  return bits_get(out,BENCH_WIDTH)==(a>b ? a : b);
+}
+
+/**
+  * \fn int ref_aes128(const uint8_t * in, const uint8_t * out)
+  * \brief This function checks the output of circuit_aes128 on the example of FIPS-197, appendix C.1, any other input is an error
+*/
+int ref_aes128(const uint8_t * in, const uint8_t * out) {
+  static const uint8_t ct[16]={0x69,0xc4,0xe0,0xd8,0x6a,0x7b,0x04,0x30,0xd8,0xcd,0xb7,0x80,0x70,0xb4,0xc5,0x5a};
+  for (int i=0 ; i<16 ; i++) if (bits_get(in+8*i,8)!=(uint64_t)i || bits_get(in+128+8*i,8)!=(uint64_t)(0x11*i)) return 0;
+  for (int i=0 ; i<16 ; i++) if (bits_get(out+8*i,8)!=ct[i]) return 0;
+  return 1;
+}
+
+/**
+  * \fn void set_aes128_example(uint8_t * in)
+  * \brief This function sets the key 000102...0f and the plaintext 0011...ff of FIPS-197, appendix C.1
+*/
+void set_aes128_example(uint8_t * in) {
+  for (int i=0 ; i<16 ; i++) for (int j=0 ; j<8 ; j++) {
+    in[8*i+j]=(i>>j) & 1;
+    in[128+8*i+j]=((0x11*i)>>j) & 1;
+  }
+}
+
+/**
+  * \fn int same_circuit(const circuit * C, const circuit * D)
+  * \brief This function returns 1 if both circuits have the same wires and gates
+*/
+int same_circuit(const circuit * C, const circuit * D) {
+  if (C->nb_gates!=D->nb_gates || C->nb_wires!=D->nb_wires || C->nb_and!=D->nb_and) return 0;
+  if (C->nb_input_wires!=D->nb_input_wires || C->nb_output_wires!=D->nb_output_wires) return 0;
+  return !memcmp(C->type,D->type,C->nb_gates) && !memcmp(C->in0,D->in0,C->nb_gates*sizeof(uint32_t))
+    && !memcmp(C->in1,D->in1,C->nb_gates*sizeof(uint32_t)) && !memcmp(C->out,D->out,C->nb_gates*sizeof(uint32_t));
+}
+
+/**
+  * \fn void bench_circuit(const char * name, const circuit * C, int (*ref)(const uint8_t *, const uint8_t *), void (*set_input)(uint8_t *), int errors)
+  * \brief This function garbles and evaluates a circuit on random inputs, or the ones of set_input, and checks the decoded outputs
+*/
+void bench_circuit(const char * name, const circuit * C, int (*ref)(const uint8_t *, const uint8_t *), void (*set_input)(uint8_t *), int errors) {
+  block * in0=calloc(C->nb_input_wires,sizeof(block)), * in=calloc(C->nb_input_wires,sizeof(block));
+  block * out0=calloc(C->nb_output_wires,sizeof(block)), * out=calloc(C->nb_output_wires,sizeof(block)), offset;
+  uint8_t * bits=calloc(C->nb_input_wires,1), * expected=calloc(C->nb_output_wires,1);
+  uint8_t * ct_AND=calloc(C->nb_and+1,GATE_AND_BYTES);
+  unsigned long long t_garb=0, t_eval=0;
+
+  for (int k=0 ; k<BENCH_ITERATIONS ; k++) {
+    for (int i=0 ; i<C->nb_input_wires ; i++) bits[i]=rand() & 1;
+    if (set_input!=NULL) set_input(bits);
+    circuit_eval_plain(C,bits,expected);
+    if (ref!=NULL) errors+=!ref(bits,expected);
+
+    gen_offset(&offset);
+    gen_labels(in0,C->nb_input_wires);
+    unsigned long long t1=cpucycles();
+    circuit_garble(C,in0,out0,ct_AND,offset);
+    unsigned long long t2=cpucycles();
+    t_garb+=t2-t1;
+
+    for (int i=0 ; i<C->nb_input_wires ; i++) in[i]=block_xor(in0[i],block_select(offset,bits[i]));
+    t1=cpucycles();
+    circuit_eval(C,in,out,ct_AND);
+    t2=cpucycles();
+    t_eval+=t2-t1;
+    for (int i=0 ; i<C->nb_output_wires ; i++) errors+=!block_equal(out[i],block_xor(out0[i],block_select(offset,expected[i])));
+  }
+
+  int nb_and=C->nb_and ? C->nb_and : 1;
+  printf("%-16s | %8d gates | %8d AND | %10d bytes | %8llu garbling | %8llu evaluation CPUCYCLES per AND %s\n", name, C->nb_gates, C->nb_and,
+    C->nb_and*GATE_AND_BYTES, t_garb/BENCH_ITERATIONS/nb_and, t_eval/BENCH_ITERATIONS/nb_and, errors ? "ERROR" : "");
+
+  free(in0);
+  free(in);
+  free(out0);
+  free(out);
+  free(bits);
+  free(expected);
+  free(ct_AND);
+}
+
+/**
+  * \fn int save_and_load(const circuit * C)
+  * \brief This function writes a circuit to a Bristol Fashion file and reads it back, it returns 1 if they differ
+*/
+int save_and_load(const circuit * C) {
+  char path[]="/tmp/circuitXXXXXX";
+  int fd=mkstemp(path), error;
+  if (fd<0) return 1;
+  close(fd);
+  circuit * D=circuit_init();
+  error=circuit_save(C,path) || circuit_load(D,path) || !same_circuit(C,D);
+  circuit_clear(D);
+  unlink(path);
+  return error;
+}
+
+int main(int argc, char * argv[]){
+  const char * names[5]={"comparison","equality","addition","maximum","AES-128"};
+  int (*refs[5])(const uint8_t *, const uint8_t *)={ref_cmp,ref_eq,ref_add,ref_max,ref_aes128};
+
+  aes_hash_init();
+  printf("Circuits garbled with %s, average over %d runs, AES-NI %s\n", PARAM_THREE_HALVES ? "three halves" : "half-gates", BENCH_ITERATIONS, aes_hash_uses_aesni() ? "on" : "off");
+  for (int c=0 ; c<5 ; c++) {
+    circuit * C=circuit_init();
+    if (c==0) circuit_cmp(C,PARAM_L,PARAM_INEQ);
+    if (c==1) circuit_eq(C,BENCH_WIDTH);
+    if (c==2) circuit_add(C,BENCH_WIDTH);
+    if (c==3) circuit_max(C,BENCH_WIDTH);
+    if (c==4) circuit_aes128(C);
+    bench_circuit(names[c],C,refs[c],c==4 ? set_aes128_example : NULL,save_and_load(C));
+    circuit_clear(C);
+  }
+
+  //Bristol Fashion files given on the command line, checked against their evaluation in the clear
+  for (int f=1 ; f<argc ; f++) {
+    circuit * C=circuit_init();
+    int error=circuit_load(C,argv[f]);
+    if (error) printf("%-16s | can not be loaded (%d)\n", argv[f], error);
+    else bench_circuit(argv[f],C,NULL,NULL,0);
+    circuit_clear(C);
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include "../src/parameters.h"
+#include "../src/paillier.h"
+#include "../src/damgard_jurik.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_ITERATIONS 20
+#include "bench.h"
+
+#define BENCH_MAX_S 4
+
+int main(){
+
+  unsigned long long t1, t2, t_enc, t_dec, t_add, t_mul;
+  mpz_t m1, m2, k, c1, c2, c, d, expected;
+  mpz_inits(m1, m2, k, c1, c2, c, d, expected, NULL);
+  gmp_randstate_t seed ;
+  gmp_randinit_default (seed);
+  gmp_randseed_ui(seed,time(NULL));
+
+  printf("Damgard-Jurik cost, average over %d runs (%d-bit modulus, key holder encryption)\n", BENCH_ITERATIONS, PAILLIER_KEY_SIZE);
+  printf(" s | plaintext | ciphertext | slots |    encrypt |    decrypt |    add |  scalar mul | enc+dec per slot\n");
+
+  for (int s=1 ; s<=BENCH_MAX_S ; s++) {
+
+    dj_ctx * ctx = dj_ctx_init(s);
+    dj_ctx_set_str(ctx, PAILLIER_PK_N, PAILLIER_SK_P, PAILLIER_SK_Q, 16);
+    int slots=(s*PAILLIER_KEY_SIZE-1)/PARAM_SLOT_SIZE;
+    t_enc=t_dec=t_add=t_mul=0;
+
+    for (int i=0 ; i<BENCH_ITERATIONS ; i++) {
+      mpz_urandomm(m1, seed, ctx->n_pow[s]);
+      mpz_urandomm(m2, seed, ctx->n_pow[s]);
+      mpz_urandomb(k, seed, PARAM_SLOT_SIZE);
+
+      t1 = cpucycles();
+      dj_encrypt(c1, m1, ctx);
+      t2 = cpucycles();
+      t_enc += t2 - t1;
+      dj_encrypt(c2, m2, ctx);
+
+      t1 = cpucycles();
+      dj_decrypt(d, c1, ctx);
+      t2 = cpucycles();
+      t_dec += t2 - t1;
+      if (mpz_cmp(d, m1)) printf("Error : wrong decryption for s=%d\n", s);
+
+      t1 = cpucycles();
+      dj_add(c, c1, c2, ctx);
+      t2 = cpucycles();
+      t_add += t2 - t1;
+      dj_decrypt(d, c, ctx);
+      mpz_add(expected, m1, m2);
+      mpz_mod(expected, expected, ctx->n_pow[s]);
+      if (mpz_cmp(d, expected)) printf("Error : wrong addition for s=%d\n", s);
+
+      t1 = cpucycles();
+      dj_mul_scalar(c, c1, k, ctx);
+      t2 = cpucycles();
+      t_mul += t2 - t1;
+      dj_decrypt(d, c, ctx);
+      mpz_mul(expected, m1, k);
+      mpz_mod(expected, expected, ctx->n_pow[s]);
+      if (mpz_cmp(d, expected)) printf("Error : wrong scalar multiplication for s=%d\n", s);
+    }
+
+    printf("%2d | %9d | %10d | %5d | %10llu | %10llu | %6llu | %11llu | %llu\n", s, s*PAILLIER_KEY_SIZE, (s+1)*PAILLIER_KEY_SIZE, slots,
+      t_enc/BENCH_ITERATIONS, t_dec/BENCH_ITERATIONS, t_add/BENCH_ITERATIONS, t_mul/BENCH_ITERATIONS, (t_enc+t_dec)/BENCH_ITERATIONS/slots);
+
+    dj_ctx_clear(ctx);
+  }
+
+  mpz_clears(m1, m2, k, c1, c2, c, d, expected, NULL);
+  gmp_randclear(seed);
+}
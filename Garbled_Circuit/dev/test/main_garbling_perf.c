@@ -0,0 +1,134 @@
+#include "../src/parameters.h"
+#include "../src/gate_functions.h"
+#include "../src/aes_hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+#define BENCH_CHAIN_GATES (1<<16) /**< number of AND gates of the synthetic circuit */
+
+typedef void (*garb_fn)(block *, uint8_t *, const block *, const block *, block, uint64_t);
+typedef void (*eval_fn)(block *, block, block, const uint8_t *, uint64_t);
+
+/**
+  * \fn int check_gate(garb_fn garb, eval_fn eval, int nb)
+  * \brief This function garbles nb AND gates on random labels and counts the input combinations whose output is wrongly decoded
+*/
+int check_gate(garb_fn garb, eval_fn eval, int nb) {
+  int errors=0;
+  block offset, A[2], B[2], C[2], out;
+  uint8_t ct[GATE_HALF_GATES_BYTES];
+  gen_offset(&offset);
+  for (int g=0 ; g<nb ; g++) {
+    gen_labels(&A[0],1);
+    gen_labels(&B[0],1);
+    A[1]=block_xor(A[0],offset);
+    B[1]=block_xor(B[0],offset);
+    garb(&C[0],ct,A,B,offset,g);
+    C[1]=block_xor(C[0],offset);
+    for (int x=0 ; x<2 ; x++) for (int y=0 ; y<2 ; y++) {
+      eval(&out,A[x],B[y],ct,g);
+      errors+=!block_equal(out,C[x&y]);
+    }
+  }
+  return errors;
+}
+
+/**
+  * \fn void bench_chain(garb_fn garb, eval_fn eval, int ct_bytes, int nb, unsigned long long * t_garb, unsigned long long * t_eval, int * errors)
+  * \brief This function measures nb chained AND gates, the output of each gate being the first input of the next one
+*/
+void bench_chain(garb_fn garb, eval_fn eval, int ct_bytes, int nb, unsigned long long * t_garb, unsigned long long * t_eval, int * errors) {
+  block offset, A[2], * B=calloc(nb,sizeof(block)), * E=calloc(nb,sizeof(block)), Ab, C[2];
+  uint8_t * ct=calloc(nb,ct_bytes);
+  int * x=calloc(nb+1,sizeof(int));
+  gen_offset(&offset);
+  gen_labels(&A[0],1);
+  gen_labels(B,nb);
+  for (int i=0 ; i<nb+1 ; i++) x[i]=rand()&1;
+  block A_in=block_xor(A[0],block_select(offset,x[nb]));
+
+  unsigned long long t1=cpucycles();
+  for (int i=0 ; i<nb ; i++) {
+    block Bp[2]={B[i],block_xor(B[i],offset)};
+    A[1]=block_xor(A[0],offset);
+    garb(&A[0],ct+i*ct_bytes,A,Bp,offset,i);
+  }
+  unsigned long long t2=cpucycles();
+  *t_garb+=t2-t1;
+  C[0]=A[0];
+  C[1]=block_xor(A[0],offset);
+
+  int v=x[nb];
+  for (int i=0 ; i<nb ; i++) {
+    E[i]=block_xor(B[i],block_select(offset,x[i]));
+    v&=x[i];
+  }
+  t1=cpucycles();
+  Ab=A_in;
+  for (int i=0 ; i<nb ; i++) eval(&Ab,Ab,E[i],ct+i*ct_bytes,i);
+  t2=cpucycles();
+  *t_eval+=t2-t1;
+  *errors+=!block_equal(Ab,C[v]);
+
+  free(B);
+  free(E);
+  free(ct);
+  free(x);
+}
+
+/**
+  * \fn void bench_cmp(garb_fn garb, eval_fn eval, int ct_bytes, unsigned long long * t_garb, unsigned long long * t_eval)
+  * \brief This function measures the PARAM_L AND gates of one comparison
+*/
+void bench_cmp(garb_fn garb, eval_fn eval, int ct_bytes, unsigned long long * t_garb, unsigned long long * t_eval) {
+  block offset, A[2], B[2], out;
+  uint8_t * ct=calloc(PARAM_L,ct_bytes);
+  gen_offset(&offset);
+  gen_labels(&A[0],1);
+  gen_labels(&B[0],1);
+  A[1]=block_xor(A[0],offset);
+  B[1]=block_xor(B[0],offset);
+
+  unsigned long long t1=cpucycles();
+  for (int i=0 ; i<PARAM_L ; i++) garb(&out,ct+i*ct_bytes,A,B,offset,i);
+  unsigned long long t2=cpucycles();
+  *t_garb+=t2-t1;
+  t1=cpucycles();
+  for (int i=0 ; i<PARAM_L ; i++) eval(&out,A[1],B[0],ct+i*ct_bytes,i);
+  t2=cpucycles();
+  *t_eval+=t2-t1;
+  free(ct);
+}
+
+int main(){
+  const char * names[2]={"half-gates","three halves"};
+  garb_fn garbs[2]={gate_and_garb_half_gates,gate_and_garb_three_halves};
+  eval_fn evals[2]={gate_and_eval_half_gates,gate_and_eval_three_halves};
+  int bytes[2]={GATE_HALF_GATES_BYTES,GATE_THREE_HALVES_BYTES};
+  char label[64];
+
+  aes_hash_init();
+  printf("AND gates, average over %d runs, AES-NI %s, PARAM_THREE_HALVES = %d\n", BENCH_ITERATIONS, aes_hash_uses_aesni() ? "on" : "off", PARAM_THREE_HALVES);
+  for (int s=0 ; s<2 ; s++) {
+    unsigned long long t_garb=0, t_eval=0;
+    int errors=check_gate(garbs[s],evals[s],1000);
+
+    printf("%-40s | %12d bytes per AND gate\n", names[s], bytes[s]);
+    for (int k=0 ; k<BENCH_ITERATIONS ; k++) bench_cmp(garbs[s],evals[s],bytes[s],&t_garb,&t_eval);
+    snprintf(label,sizeof(label),"%s, garbling, %d gates", names[s], PARAM_L);
+    printf("%-40s | %12llu CPUCYCLES per gate %s\n", label, t_garb/BENCH_ITERATIONS/PARAM_L, errors ? "ERROR" : "");
+    snprintf(label,sizeof(label),"%s, evaluation, %d gates", names[s], PARAM_L);
+    printf("%-40s | %12llu CPUCYCLES per gate %s\n", label, t_eval/BENCH_ITERATIONS/PARAM_L, errors ? "ERROR" : "");
+
+    t_garb=0;
+    t_eval=0;
+    for (int k=0 ; k<BENCH_ITERATIONS ; k++) bench_chain(garbs[s],evals[s],bytes[s],BENCH_CHAIN_GATES,&t_garb,&t_eval,&errors);
+    snprintf(label,sizeof(label),"%s, garbling, %d gates", names[s], BENCH_CHAIN_GATES);
+    printf("%-40s | %12llu CPUCYCLES per gate %s\n", label, t_garb/BENCH_ITERATIONS/BENCH_CHAIN_GATES, errors ? "ERROR" : "");
+    snprintf(label,sizeof(label),"%s, evaluation, %d gates", names[s], BENCH_CHAIN_GATES);
+    printf("%-40s | %12llu CPUCYCLES per gate %s\n", label, t_eval/BENCH_ITERATIONS/BENCH_CHAIN_GATES, errors ? "ERROR" : "");
+  }
+  return 0;
+}
@@ -0,0 +1,76 @@
+#include "../src/parameters.h"
+#include "../src/paillier.h"
+#include "../src/montgomery.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_ITERATIONS 100
+#include "bench.h"
+
+#define BENCH_BATCH 16
+
+/**
+  * \fn void bench_batch(char * name, mpz_t m, mpz_t e, gmp_randstate_t seed)
+  * \brief This function compares BENCH_BATCH exponentiations run one by one with mpz_powm and run by mont_powm_batch
+*/
+void bench_batch(char * name, mpz_t m, mpz_t e, gmp_randstate_t seed) {
+
+  unsigned long long t1, t2, t_gmp=0, t_batch=0;
+  int errors=0;
+  mpz_t b[BENCH_BATCH], ee[BENCH_BATCH], r[BENCH_BATCH], ref;
+
+  mpz_init(ref);
+  for (int i=0 ; i<BENCH_BATCH ; i++) mpz_inits(b[i], ee[i], r[i], NULL);
+
+  for (int it=0 ; it<BENCH_ITERATIONS/10 ; it++) {
+    for (int i=0 ; i<BENCH_BATCH ; i++) {
+      mpz_urandomm(b[i], seed, m);
+      mpz_set(ee[i], e);
+    }
+
+    t1 = cpucycles();
+    mont_powm_batch(r, b, ee, BENCH_BATCH, m);
+    t2 = cpucycles();
+    t_batch += t2 - t1;
+
+    t1 = cpucycles();
+    for (int i=0 ; i<BENCH_BATCH ; i++) mpz_powm(ref, b[i], e, m);
+    t2 = cpucycles();
+    t_gmp += t2 - t1;
+
+    for (int i=0 ; i<BENCH_BATCH ; i++) {
+      mpz_powm(ref, b[i], e, m);
+      errors += (mpz_cmp(ref, r[i])!=0);
+    }
+  }
+
+  printf("%-28s | %5zu | %5zu | %10llu | %10llu | %.2f %s\n", name, mpz_sizeinbase(m,2), mpz_sizeinbase(e,2),
+    t_gmp/(BENCH_ITERATIONS/10)/BENCH_BATCH, t_batch/(BENCH_ITERATIONS/10)/BENCH_BATCH, (double) t_gmp/t_batch, errors ? "ERROR" : "");
+
+  for (int i=0 ; i<BENCH_BATCH ; i++) mpz_clears(b[i], ee[i], r[i], NULL);
+  mpz_clear(ref);
+}
+
+int main(){
+
+  gmp_randstate_t seed ;
+  gmp_randinit_default (seed);
+  gmp_randseed_ui(seed,time(NULL));
+  paillier_ctx * ctx = paillier_ctx_init();
+  paillier_ctx_set_str(ctx, PAILLIER_PK_N, PAILLIER_SK_P, PAILLIER_SK_Q, 16);
+  mpz_t e;
+  mpz_init(e);
+
+  printf("Batched exponentiation cost per exponentiation, %d at once, %d lanes\n", BENCH_BATCH, mont_batch_lanes());
+  printf("%-28s | m bits| e bits|   mpz_powm |      batch | speedup\n", "operation");
+  bench_batch("r^n mod n^2", ctx->n_squared, ctx->n, seed);
+  bench_batch("(r mod p)^p mod p^2", ctx->p_squared, ctx->p, seed);
+  mpz_urandomb(e, seed, PAILLIER_DJN_EXP_SIZE);
+  bench_batch("hs^a mod n^2, short exponent", ctx->n_squared, e, seed);
+  mpz_urandomb(e, seed, 160);
+  bench_batch("h^r mod n, 160-bit exponent", ctx->n, e, seed);
+
+  mpz_clear(e);
+  paillier_ctx_clear(ctx);
+  gmp_randclear(seed);
+}
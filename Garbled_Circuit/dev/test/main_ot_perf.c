@@ -0,0 +1,249 @@
+#include "../src/parameters.h"
+#include "../src/oblivious_transfer.h"
+#include "../src/ot_extension.h"
+#include "../src/randombytes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+/**
+  * \fn mpz_t ** alloc_pairs(int nb)
+  * \brief This function allocates nb pairs of mpz_t
+*/
+mpz_t ** alloc_pairs(int nb) {
+  mpz_t ** K = calloc(nb,sizeof(mpz_t *));
+  for (int i=0 ; i<nb ; i++) {
+    K[i]=calloc(2,sizeof(mpz_t));
+    mpz_inits(K[i][0],K[i][1],NULL);
+  }
+  return K;
+}
+
+/**
+  * \fn void free_pairs(mpz_t ** K, int nb)
+  * \brief This function releases nb pairs of mpz_t
+*/
+void free_pairs(mpz_t ** K, int nb) {
+  for (int i=0 ; i<nb ; i++) {
+    mpz_clears(K[i][0],K[i][1],NULL);
+    free(K[i]);
+  }
+  free(K);
+}
+
+/**
+  * \fn unsigned long long bench_base(gmp_randstate_t seed, OT_sender_session * sen_session, OT_receiver_session * rec_session, int * errors)
+  * \brief This function measures the PARAM_L+1 base OTs of one comparison, with reused sessions if not NULL
+*/
+unsigned long long bench_base(gmp_randstate_t seed, OT_sender_session * sen_session, OT_receiver_session * rec_session, int * errors) {
+
+  int n=PARAM_L+1;
+  mpz_t y, rho;
+  mpz_t * x=calloc(n,sizeof(mpz_t)), * keys=calloc(n,sizeof(mpz_t));
+  mpz_t ** kB=alloc_pairs(n), ** K=alloc_pairs(n);
+  OT_sender * S=OT_sender_init();
+  OT_receiver * R=OT_receiver_init();
+  mpz_inits(y,rho,NULL);
+  for (int i=0 ; i<n ; i++) {
+    mpz_inits(x[i],keys[i],NULL);
+    mpz_urandomb(kB[i][0],seed,KEY_SIZE);
+    mpz_urandomb(kB[i][1],seed,KEY_SIZE);
+  }
+  mpz_urandomb(rho,seed,n);
+
+  unsigned long long t1=cpucycles();
+  if (sen_session!=NULL) {
+    OT_sender_session_setup(sen_session,S->sen_enc_S,y,S->sen_S,S->sen_T);
+    OT_receiver_session_update(rec_session,S->sen_enc_S);
+    OT_receiver_choose_point(R->rec_enc_R,x,R->rec_R,rec_session->S,rho);
+  }
+  else {
+    OT_sender_setup(S->sen_enc_S,y,S->sen_S,S->sen_T);
+    OT_receiver_choose(R->rec_enc_R,x,R->rec_R,S->sen_enc_S,rho);
+  }
+  OT_sender_key_derivation(K,kB,R->rec_enc_R,S->sen_T,y);
+  if (sen_session!=NULL) OT_receiver_retrieve_session(keys,K,x,rec_session,rho);
+  else OT_receiver_retrieve(keys,K,x,S->sen_enc_S,rho);
+  unsigned long long t2=cpucycles();
+
+  for (int i=0 ; i<n ; i++) *errors += mpz_cmp(keys[i],kB[i][mpz_tstbit(rho,i)])!=0;
+
+  for (int i=0 ; i<n ; i++) mpz_clears(x[i],keys[i],NULL);
+  mpz_clears(y,rho,NULL);
+  free_pairs(kB,n);
+  free_pairs(K,n);
+  free(x);
+  free(keys);
+  OT_sender_clear(S);
+  OT_receiver_clear(R);
+  return t2-t1;
+}
+
+/**
+  * \fn unsigned long long bench_session(OT_ext_sender * S, OT_ext_receiver * R)
+  * \brief This function measures the OT_EXT_KAPPA base OTs of an extension session
+*/
+unsigned long long bench_session(OT_ext_sender * S, OT_ext_receiver * R) {
+
+  unsigned long long t1=cpucycles();
+  OT_ext_receiver_base_setup(R);
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) memcpy(S->base[c]->rec_enc_S,R->base[c]->sen_enc_S,32);
+  OT_ext_sender_base_choose(S);
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) for (int i=0 ; i<PARAM_L+1 ; i++) memcpy(R->base[c]->sen_enc_R[i],S->base[c]->rec_enc_R[i],32);
+  OT_ext_receiver_base_transfer(R);
+  for (int c=0 ; c<OT_EXT_BASE_CHUNKS ; c++) for (int i=0 ; i<PARAM_L+1 ; i++) for (int j=0 ; j<2 ; j++) memcpy(S->base[c]->rec_keys[i][j],R->base[c]->sen_keys[i][j],bits_to_bytes(KEY_SIZE));
+  OT_ext_sender_base_retrieve(S);
+  return cpucycles()-t1;
+}
+
+/**
+  * \fn unsigned long long bench_extension(OT_ext_sender * S, OT_ext_receiver * R, int nb_ot, gmp_randstate_t seed, int correlated, int * errors)
+  * \brief This function measures one extension of nb_ot OTs, correlated by a random offset or not, and checks the retrieved keys
+*/
+unsigned long long bench_extension(OT_ext_sender * S, OT_ext_receiver * R, int nb_ot, gmp_randstate_t seed, int correlated, int * errors) {
+
+  mpz_t rho, offset;
+  mpz_t * keys=calloc(nb_ot,sizeof(mpz_t));
+  mpz_t ** kB=alloc_pairs(nb_ot), ** K=alloc_pairs(nb_ot);
+  uint8_t * choices=calloc(bits_to_bytes(nb_ot),sizeof(uint8_t));
+  mpz_inits(rho,offset,NULL);
+  mpz_urandomb(offset,seed,KEY_SIZE);
+  for (int i=0 ; i<nb_ot ; i++) {
+    mpz_init(keys[i]);
+    mpz_urandomb(kB[i][0],seed,KEY_SIZE);
+    mpz_urandomb(kB[i][1],seed,KEY_SIZE);
+  }
+  random_bytes(choices,bits_to_bytes(nb_ot));
+  mpz_import(rho,bits_to_bytes(nb_ot),-1,1,0,0,choices);
+
+  unsigned long long t1=cpucycles();
+  OT_ext_receiver_choose(R,choices,nb_ot);
+  memcpy(S->u,R->u,OT_ext_u_size(nb_ot));
+  OT_ext_sender_expand(S,nb_ot);
+  if (correlated) {
+    OT_ext_sender_correlated(S,K,kB,offset,0,nb_ot);
+    OT_ext_receiver_retrieve_correlated(R,keys,K,rho,0,nb_ot);
+  }
+  else {
+    OT_ext_sender_transfer(S,K,kB,0,nb_ot);
+    OT_ext_receiver_retrieve(R,keys,K,rho,0,nb_ot);
+  }
+  unsigned long long t2=cpucycles();
+
+  for (int i=0 ; i<nb_ot ; i++) *errors += mpz_cmp(keys[i],kB[i][mpz_tstbit(rho,i)])!=0;
+
+  for (int i=0 ; i<nb_ot ; i++) mpz_clear(keys[i]);
+  mpz_clears(rho,offset,NULL);
+  free_pairs(kB,nb_ot);
+  free_pairs(K,nb_ot);
+  free(keys);
+  free(choices);
+  return t2-t1;
+}
+
+/**
+  * \fn unsigned long long bench_precomputed(OT_ext_sender * S, OT_ext_receiver * R, int nb_ot, gmp_randstate_t seed, int correlated, int * errors)
+  * \brief This function measures the online derandomization of nb_ot precomputed random OTs, correlated by a random offset or not, and checks the retrieved keys
+*/
+unsigned long long bench_precomputed(OT_ext_sender * S, OT_ext_receiver * R, int nb_ot, gmp_randstate_t seed, int correlated, int * errors) {
+
+  mpz_t rho, offset;
+  mpz_t * keys=calloc(nb_ot,sizeof(mpz_t));
+  mpz_t ** kB=alloc_pairs(nb_ot), ** K=alloc_pairs(nb_ot);
+  uint8_t * corrections=calloc(bits_to_bytes(nb_ot),sizeof(uint8_t));
+  mpz_inits(rho,offset,NULL);
+  mpz_urandomb(offset,seed,KEY_SIZE);
+  mpz_urandomb(rho,seed,nb_ot);
+  for (int i=0 ; i<nb_ot ; i++) {
+    mpz_init(keys[i]);
+    mpz_urandomb(kB[i][0],seed,KEY_SIZE);
+    mpz_urandomb(kB[i][1],seed,KEY_SIZE);
+  }
+
+  //Offline phase, not measured
+  OT_ext_receiver_precompute(R,nb_ot);
+  memcpy(S->u,R->u,OT_ext_u_size(nb_ot));
+  OT_ext_sender_precompute(S,nb_ot);
+
+  unsigned long long t1=cpucycles();
+  int index=OT_ext_receiver_correct(R,corrections,rho,nb_ot);
+  OT_ext_sender_reserve(S,nb_ot);
+  if (correlated) {
+    OT_ext_sender_derandomize_correlated(S,K,kB,offset,corrections,index,nb_ot);
+    OT_ext_receiver_derandomize_correlated(R,keys,K,rho,index,nb_ot);
+  }
+  else {
+    OT_ext_sender_derandomize(S,K,kB,corrections,index,nb_ot);
+    OT_ext_receiver_derandomize(R,keys,K,rho,index,nb_ot);
+  }
+  unsigned long long t2=cpucycles();
+
+  for (int i=0 ; i<nb_ot ; i++) *errors += mpz_cmp(keys[i],kB[i][mpz_tstbit(rho,i)])!=0;
+
+  for (int i=0 ; i<nb_ot ; i++) mpz_clear(keys[i]);
+  mpz_clears(rho,offset,NULL);
+  free_pairs(kB,nb_ot);
+  free_pairs(K,nb_ot);
+  free(keys);
+  free(corrections);
+  return t2-t1;
+}
+
+int main(){
+
+  int errors, total=0, sizes[3]={1, PARAM_SLOTS, 4096};
+  const char * modes[2]={"", "correlated "};
+  char label[64];
+  unsigned long long t;
+  gmp_randstate_t seed;
+  gmp_randinit_default(seed);
+  gmp_randseed_ui(seed,time(NULL));
+
+  //Correlated OTs only run on the extension, a base OT needs both pads whatever the keys
+  //The first comparison of a session draws (y, S, T) and builds the table of S, the following ones reuse them
+  OT_sender_session * sen_session=OT_sender_session_init(PARAM_OT_SESSION_USES);
+  OT_receiver_session * rec_session=OT_receiver_session_init();
+  unsigned long long t_session=0;
+  bench_base(seed,sen_session,rec_session,&total);
+  printf("OT cost per comparison (%d OTs of %d-bit keys), average over %d runs\n", PARAM_L+1, KEY_SIZE, BENCH_ITERATIONS);
+  errors=0;
+  t=0;
+  for (int it=0 ; it<BENCH_ITERATIONS ; it++) {
+    t+=bench_base(seed,NULL,NULL,&errors);
+    t_session+=bench_base(seed,sen_session,rec_session,&errors);
+  }
+  printf("%-40s | %12llu CPUCYCLES | reused session %12llu CPUCYCLES %s\n", "base OTs", t/BENCH_ITERATIONS, t_session/BENCH_ITERATIONS, errors ? "ERROR" : "");
+  total+=errors;
+  OT_sender_session_clear(sen_session);
+  OT_receiver_session_clear(rec_session);
+
+  OT_ext_sender * S=OT_ext_sender_init(sizes[2]*(PARAM_L+1));
+  OT_ext_receiver * R=OT_ext_receiver_init(sizes[2]*(PARAM_L+1));
+  t=bench_session(S,R);
+  printf("%-40s | %12llu CPUCYCLES, once per session\n", "extension session, base OTs", t);
+
+  for (int c=0 ; c<2 ; c++) for (int k=0 ; k<3 ; k++) {
+    errors=0;
+    t=0;
+    for (int it=0 ; it<BENCH_ITERATIONS ; it++) t+=bench_extension(S,R,sizes[k]*(PARAM_L+1),seed,c,&errors);
+    snprintf(label,sizeof(label),"%sextension, %d comparisons", modes[c], sizes[k]);
+    printf("%-40s | %12llu CPUCYCLES %s\n", label, t/BENCH_ITERATIONS/sizes[k], errors ? "ERROR" : "");
+    total+=errors;
+  }
+
+  for (int c=0 ; c<2 ; c++) for (int k=0 ; k<3 ; k++) {
+    errors=0;
+    t=0;
+    for (int it=0 ; it<BENCH_ITERATIONS ; it++) t+=bench_precomputed(S,R,sizes[k]*(PARAM_L+1),seed,c,&errors);
+    snprintf(label,sizeof(label),"%sonline random OTs, %d cmp", modes[c], sizes[k]);
+    printf("%-40s | %12llu CPUCYCLES %s\n", label, t/BENCH_ITERATIONS/sizes[k], errors ? "ERROR" : "");
+    total+=errors;
+  }
+
+  OT_ext_sender_clear(S);
+  OT_ext_receiver_clear(R);
+  gmp_randclear(seed);
+  return total;
+}
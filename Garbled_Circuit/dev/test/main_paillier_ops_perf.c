@@ -0,0 +1,158 @@
+#include "../src/parameters.h"
+#include "../src/cmp_steps.h"
+#include "../src/paillier.h"
+#include "../src/paillier_ops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+#define BENCH_WEIGHT_SIZE 16
+#define BENCH_VALUE_SIZE 16
+
+/**
+  * \fn void bench_dot(int nb, int weight_bits, paillier_ctx * ctx, gmp_randstate_t seed)
+  * \brief This function compares paillier_enc_dot with nb separate exponentiations and checks the decrypted dot product
+*/
+void bench_dot(int nb, int weight_bits, paillier_ctx * ctx, gmp_randstate_t seed) {
+
+  unsigned long long t1, t2, t_naive=0, t_dot=0;
+  int errors=0;
+  mpz_t * ct = calloc(nb,sizeof(mpz_t)), * x = calloc(nb,sizeof(mpz_t)), * w = calloc(nb,sizeof(mpz_t));
+  mpz_t c_naive, c_dot, term, expected, plain;
+  mpz_inits(c_naive, c_dot, term, expected, plain, NULL);
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_inits(ct[i], x[i], w[i], NULL);
+    mpz_urandomb(x[i], seed, BENCH_VALUE_SIZE);
+    paillier_encrypt(ct[i], x[i], ctx);
+  }
+
+  for (int it=0 ; it<BENCH_ITERATIONS ; it++) {
+    mpz_set_ui(expected, 0);
+    for (int i=0 ; i<nb ; i++) {
+      mpz_urandomb(w[i], seed, weight_bits);
+      if (i%4==3) mpz_neg(w[i], w[i]);
+      mpz_addmul(expected, w[i], x[i]);
+    }
+    mpz_mod(expected, expected, ctx->n);
+
+    t1 = cpucycles();
+    mpz_set_ui(c_naive, 1);
+    for (int i=0 ; i<nb ; i++) {
+      paillier_mul_scalar(term, ct[i], w[i], ctx);
+      paillier_add(c_naive, c_naive, term, ctx);
+    }
+    t2 = cpucycles();
+    t_naive += t2 - t1;
+
+    t1 = cpucycles();
+    paillier_enc_dot(c_dot, ct, w, nb, ctx);
+    t2 = cpucycles();
+    t_dot += t2 - t1;
+
+    paillier_decrypt(plain, c_dot, ctx);
+    errors += (mpz_cmp(plain, expected)!=0) + (mpz_cmp(c_naive, c_dot)!=0);
+  }
+
+  printf("%6d | %6d | %12llu | %12llu | %.2f %s\n", nb, weight_bits, t_naive/BENCH_ITERATIONS, t_dot/BENCH_ITERATIONS,
+    (double) t_naive/t_dot, errors ? "ERROR" : "");
+
+  for (int i=0 ; i<nb ; i++) mpz_clears(ct[i], x[i], w[i], NULL);
+  mpz_clears(c_naive, c_dot, term, expected, plain, NULL);
+  free(ct);
+  free(x);
+  free(w);
+}
+
+/**
+  * \fn int compare_score(paillier_ctx * Alice_paillier, paillier_ctx * Bob_paillier, gmp_randstate_t seed)
+  * \brief This function compares an encrypted weighted score with a threshold through the comparison steps
+
+  * \return 0 if the comparison result matches the clear computation
+*/
+int compare_score(paillier_ctx * Alice_paillier, paillier_ctx * Bob_paillier, gmp_randstate_t seed) {
+
+  int nb = 8, result, expected;
+  mpz_t ct[8], x[8], w[8], score, ct_score, threshold;
+  mpz_inits(score, ct_score, threshold, NULL);
+  uint8_t Bob_input[bits_to_bytes(PARAM_L)];
+
+  Alice_struct * Alice=cmp_Alice_init();
+  OT_sender * Alice_OT = OT_sender_init();
+  Bob_struct * Bob=cmp_Bob_init();
+  OT_receiver * Bob_OT = OT_receiver_init();
+
+  // score = sum of 8 products of (PARAM_L-4) bits, so that it fits in PARAM_L-1 bits
+  mpz_set_ui(score, 0);
+  for (int i=0 ; i<nb ; i++) {
+    mpz_inits(ct[i], x[i], w[i], NULL);
+    mpz_urandomb(x[i], seed, (PARAM_L-4)/2);
+    mpz_urandomb(w[i], seed, PARAM_L-4-(PARAM_L-4)/2);
+    mpz_addmul(score, w[i], x[i]);
+    paillier_encrypt(ct[i], x[i], Alice_paillier);
+  }
+  paillier_enc_dot(ct_score, ct, w, nb, Alice_paillier);
+  mpz_urandomb(threshold, seed, PARAM_L-3);
+  memset(Bob_input, 0, bits_to_bytes(PARAM_L));
+  mpz_export(Bob_input, NULL, -1, 1, 0, 0, threshold);
+
+  cmp_Alice_step1_ct(Alice, Alice_OT, ct_score, Alice_paillier);
+  for (int i=0 ; i < PAILLIER_MAX_KEY_SIZE/4 ; ++i) Bob->ct_Alice[i]=Alice->ct_Alice[i];
+  for (int i=0 ; i<32 ; ++i) Bob_OT->rec_enc_S[i]=Alice_OT->sen_enc_S[i];
+
+  gmp_printf("( %Zu < ", score);
+  if (cmp_Bob_step2(Bob , Bob_OT, Bob_input, Bob_paillier)) {
+    printf("Error : Bob can not choose the OTs\n");
+    return 1;
+  }
+  for (int i=0 ; i < PAILLIER_MAX_KEY_SIZE/4 ; ++i) Alice->ct_gamma[i]=Bob->ct_gamma[i];
+  for (int i=0 ; i < 32*(PARAM_L+1) ; ++i) Alice_OT->sen_enc_R[i/32][i%32]=Bob_OT->rec_enc_R[i/32][i%32];
+
+  if (cmp_Alice_step3(Alice , Alice_OT, Alice_paillier)) {
+    printf("Error : Alice can not run the OTs\n");
+    return 1;
+  }
+  memcpy(Bob->trans_table, Alice->trans_table, 2*BLOCK_BYTES);
+  for (int i=0 ; i<2*(PARAM_L+1) ; ++i) for (uint32_t j=0 ; j<bits_to_bytes(KEY_SIZE) ; ++j) Bob_OT->rec_keys[i/2][i%2][j]=Alice_OT->sen_keys[i/2][i%2][j];
+  memcpy(Bob->Alice_keys, Alice->Alice_keys, (PARAM_L+1)*BLOCK_BYTES);
+  memcpy(Bob->ct_AND, Alice->ct_AND, PARAM_L*GATE_AND_BYTES);
+
+  result = cmp_Bob_step4(Bob , Bob_OT);
+  expected = mpz_cmp(score, threshold)<0;
+  printf("%d %s\n", result, result==expected ? "" : "ERROR");
+
+  for (int i=0 ; i<nb ; i++) mpz_clears(ct[i], x[i], w[i], NULL);
+  mpz_clears(score, ct_score, threshold, NULL);
+  cmp_Alice_clear(Alice);
+  cmp_Bob_clear(Bob);
+  OT_receiver_clear(Bob_OT);
+  OT_sender_clear(Alice_OT);
+  return result!=expected;
+}
+
+int main(){
+
+  gmp_randstate_t seed ;
+  gmp_randinit_default (seed);
+  gmp_randseed_ui(seed,time(NULL));
+  paillier_ctx * sk = paillier_ctx_init();
+  paillier_ctx_set_str(sk, PAILLIER_PK_N, PAILLIER_SK_P, PAILLIER_SK_Q, 16);
+  paillier_ctx * pk = paillier_ctx_init();
+  paillier_ctx_set_str(pk, PAILLIER_PK_N, NULL, NULL, 16);
+
+  printf("Encrypted dot product cost, average over %d runs (%d-bit modulus), one weight in four is negative\n", BENCH_ITERATIONS, PAILLIER_KEY_SIZE);
+  printf("%6s | %6s | %12s | %12s | speedup\n", "terms", "w bits", "separate", "enc_dot");
+  bench_dot(16, BENCH_WEIGHT_SIZE, sk, seed);
+  bench_dot(256, BENCH_WEIGHT_SIZE, sk, seed);
+  bench_dot(16, PAILLIER_KEY_SIZE/2, sk, seed);
+  bench_dot(256, PAILLIER_KEY_SIZE/2, sk, seed);
+
+  printf("\nEncrypted score compared with a threshold\n");
+  int errors = compare_score(sk, pk, seed);
+
+  paillier_ctx_clear(sk);
+  paillier_ctx_clear(pk);
+  gmp_randclear(seed);
+  return errors;
+}
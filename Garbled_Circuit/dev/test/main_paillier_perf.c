@@ -0,0 +1,65 @@
+#include "../src/parameters.h"
+#include "../src/paillier.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_ITERATIONS 100
+#include "bench.h"
+
+int main(){
+
+  unsigned long long t1, t2, t_std=0, t_crt=0, t_djn=0, t_short=0;
+  mpz_t r, a, rn;
+  mpz_inits(r, a, rn, NULL);
+  gmp_randstate_t seed ;
+  gmp_randinit_default (seed);
+  gmp_randseed_ui(seed,time(NULL));
+
+  paillier_ctx * pk = paillier_ctx_init();
+  paillier_ctx_set_str(pk, PAILLIER_PK_N, NULL, NULL, 16);
+  paillier_ctx * sk = paillier_ctx_init();
+  paillier_ctx_set_str(sk, PAILLIER_PK_N, PAILLIER_SK_P, PAILLIER_SK_Q, 16);
+  paillier_ctx * djn = paillier_ctx_init();
+  paillier_ctx_set_str(djn, PAILLIER_PK_N, NULL, NULL, 16);
+  t1 = cpucycles();
+  paillier_set_mode(djn, PAILLIER_MODE_DJN);
+  t2 = cpucycles();
+  printf("DJN table precomputation: %llu CPUCYCLES\n\n", t2 - t1);
+
+  for (int i=0 ; i<BENCH_ITERATIONS ; i++) {
+    mpz_urandomm(r, seed, pk->n);
+    mpz_urandomb(a, seed, PAILLIER_DJN_EXP_SIZE);
+
+    t1 = cpucycles();
+    paillier_randomizer(rn, r, pk);
+    t2 = cpucycles();
+    t_std += t2 - t1;
+
+    t1 = cpucycles();
+    paillier_randomizer(rn, r, sk);
+    t2 = cpucycles();
+    t_crt += t2 - t1;
+
+    t1 = cpucycles();
+    paillier_randomizer(rn, a, djn);
+    t2 = cpucycles();
+    t_djn += t2 - t1;
+
+    t1 = cpucycles();
+    mpz_powm(rn, djn->hs, a, djn->n_squared);
+    t2 = cpucycles();
+    t_short += t2 - t1;
+  }
+
+  printf("Randomizer cost, average over %d runs (%d-bit modulus)\n", BENCH_ITERATIONS, PAILLIER_KEY_SIZE);
+  printf("standard r^n mod n^2:            %llu CPUCYCLES\n", t_std / BENCH_ITERATIONS);
+  printf("key holder CRT:                  %llu CPUCYCLES\n", t_crt / BENCH_ITERATIONS);
+  printf("DJN hs^a, mpz_powm:              %llu CPUCYCLES\n", t_short / BENCH_ITERATIONS);
+  printf("DJN hs^a, fixed-base table:      %llu CPUCYCLES\n", t_djn / BENCH_ITERATIONS);
+
+  paillier_ctx_clear(pk);
+  paillier_ctx_clear(sk);
+  paillier_ctx_clear(djn);
+  mpz_clears(r, a, rn, NULL);
+  gmp_randclear(seed);
+}
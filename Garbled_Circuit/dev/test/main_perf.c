@@ -5,12 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-inline unsigned long long cpucycles(void) {
-  unsigned long long result;
-  __asm__ volatile(".byte 15;.byte 49;shlq $32,%%rdx;orq %%rdx,%%rax" : "=a" (result) :: "%rdx");
-  return result;
-}
+#include "bench.h"
 
 int main(){
 
@@ -30,7 +25,7 @@ int main(){
   cmp_Alice_step1(Alice_input , Alice , Alice_OT);
   unsigned long long t_Alice_step1_2 = cpucycles();
    //This corresponds to the first network exchange (Alice -> Bob)
-  for (int i=0 ; i < PAILLIER_KEY_SIZE/4 ; ++i) Bob->ct_Alice[i]=Alice->ct_Alice[i];
+  for (int i=0 ; i < PAILLIER_MAX_KEY_SIZE/4 ; ++i) Bob->ct_Alice[i]=Alice->ct_Alice[i];
   for (int i=0 ; i<32 ; ++i) Bob_OT->rec_enc_S[i]=Alice_OT->sen_enc_S[i];
 
 
@@ -38,7 +33,7 @@ int main(){
   cmp_Bob_step2(Bob_input , Bob , Bob_OT);
   unsigned long long t_Bob_step2_2 = cpucycles();
   //This corresponds to the second network exchange (Bob -> Alice)
-  for (int i=0 ; i < PAILLIER_KEY_SIZE/4 ; ++i) Alice->ct_gamma[i]=Bob->ct_gamma[i];
+  for (int i=0 ; i < PAILLIER_MAX_KEY_SIZE/4 ; ++i) Alice->ct_gamma[i]=Bob->ct_gamma[i];
   for (int i=0 ; i < 32*(PARAM_L+1) ; ++i) Alice_OT->sen_enc_R[i/32][i%32]=Bob_OT->rec_enc_R[i/32][i%32];
 
 
@@ -46,10 +41,10 @@ int main(){
   cmp_Alice_step3(Alice , Alice_OT);
   unsigned long long t_Alice_step3_2 = cpucycles();
   //This corresponds to the third network exchange (Alice -> Bob)
-  for (int i=0 ; i<2*32 ; ++i) Bob->trans_table[i/32][i%32]=Alice->trans_table[i/32][i%32];
-  for (int i=0 ; i<2*(PARAM_L+1) ; ++i) for (int j=0 ; j<32 ; ++j) Bob_OT->rec_keys[i/2][i%2][j]=Alice_OT->sen_keys[i/2][i%2][j];
-  for (int i=0 ; i<32*(PARAM_L+1) ; ++i) Bob->Alice_keys[i/32][i%32]=Alice->Alice_keys[i/32][i%32];
-  for (int i=0 ; i<2*PARAM_L ; ++i) for (int j=0 ; j<32 ; ++j) Bob->ct_AND[i/2][i%2][j]=Alice->ct_AND[i/2][i%2][j];
+  memcpy(Bob->trans_table, Alice->trans_table, 2*BLOCK_BYTES);
+  for (int i=0 ; i<2*(PARAM_L+1) ; ++i) for (int j=0 ; j<bits_to_bytes(KEY_SIZE) ; ++j) Bob_OT->rec_keys[i/2][i%2][j]=Alice_OT->sen_keys[i/2][i%2][j];
+  memcpy(Bob->Alice_keys, Alice->Alice_keys, (PARAM_L+1)*BLOCK_BYTES);
+  memcpy(Bob->ct_AND, Alice->ct_AND, PARAM_L*GATE_AND_BYTES);
 
 
   unsigned long long t_Bob_step4_1 = cpucycles();
@@ -0,0 +1,52 @@
+#include "../src/parameters.h"
+#include "../src/gate_functions.h"
+#include "../src/aes_hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK_OFFSETS 256 /**< number of random offsets */
+#define CHECK_GATES 64 /**< number of AND gates garbled with each offset */
+
+/**
+  * \fn int check_offset(int first, int * rows)
+  * \brief This function garbles CHECK_GATES AND gates with three halves for a random offset and evaluates the 4 input combinations of each
+
+  * The color rows (a, b) reached by the evaluator are counted in rows, so that every row of the masks and of the
+  * selection of the half ciphertexts is exercised.
+
+  * \param[in] first     int representing the index of the first gate, so that every gate has its own tweaks
+  * \param[in,out] rows  int array of 4 counters, one per color row 2a+b
+
+  * \return the number of wrong outputs
+*/
+int check_offset(int first, int * rows) {
+  int errors=0;
+  block offset, A[2], B[2], C[2], out;
+  uint8_t ct[GATE_THREE_HALVES_BYTES];
+
+  gen_offset(&offset);
+  for (int g=0 ; g<CHECK_GATES ; g++) {
+    gen_labels(&A[0],1);
+    gen_labels(&B[0],1);
+    A[1]=block_xor(A[0],offset);
+    B[1]=block_xor(B[0],offset);
+    gate_and_garb_three_halves(&C[0],ct,A,B,offset,first+g);
+    C[1]=block_xor(C[0],offset);
+    for (int x=0 ; x<2 ; x++) for (int y=0 ; y<2 ; y++) {
+      gate_and_eval_three_halves(&out,A[x],B[y],ct,first+g);
+      rows[2*block_lsb(A[x])+block_lsb(B[y])]++;
+      errors+=!block_equal(out,C[x&y]);
+    }
+  }
+  return errors;
+}
+
+int main(){
+  int errors=0, rows[4]={0};
+
+  aes_hash_init();
+  for (int o=0 ; o<CHECK_OFFSETS ; o++) errors+=check_offset(o*CHECK_GATES,rows);
+
+  printf("%d gates, rows (0,0) %d (0,1) %d (1,0) %d (1,1) %d, %d wrong\n", CHECK_OFFSETS*CHECK_GATES, rows[0], rows[1], rows[2], rows[3], errors);
+  return errors>0 || rows[0]==0 || rows[1]==0 || rows[2]==0 || rows[3]==0;
+}
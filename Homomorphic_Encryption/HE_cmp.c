@@ -1,7 +1,11 @@
 #include "HE_cmp_struct.c"
+#include "paillier/montgomery.c"
 #include "dgk/dgk.c"
 #include "dgk/key_generation.c"
 #include "paillier/paillier.c"
+#include "paillier/paillier_pool.c"
+#include "paillier/paillier_key.c"
+#include "dgk/randombytes.c"
 
 gmp_randstate_t seed ;
 
@@ -9,172 +13,177 @@ void d(mpz_t d_alpha, mpz_t alpha) {
   mpz_fdiv_q_2exp(d_alpha,alpha,PARAM_L);
 }
 
-void dgk_Bob_gen_inputs(cmp_HE_Bob * Bob) {
+void dgk_Bob_gen_inputs(cmp_HE_Bob * Bob, paillier_ctx * ctx) {
 
-  srand(time(NULL));
-  mpz_t p,q,n,temp,n_squared;
-
-  mpz_inits(p,q,n,temp,n_squared, NULL);
-  gmp_randinit_default(seed);
-  gmp_randseed_ui(seed,time(NULL));
-
-  mpz_set_str(p,PAILLIER_SK_P,16);
-  mpz_set_str(q,PAILLIER_SK_Q,16);
-  mpz_mul(n,p,q);
-  mpz_mul(n_squared,n,n);
+  random_seed(seed);
 
   mpz_urandomb(Bob->rho,seed,PARAM_L+PARAM_K);
   mpz_ui_pow_ui(Bob->ct_gamma,2,PARAM_L);
   mpz_add(Bob->ct_gamma,Bob->ct_gamma,Bob->rho);
   mpz_sub(Bob->ct_gamma,Bob->ct_gamma,Bob->input);
-  paillier_encrypt(Bob->ct_gamma,Bob->ct_gamma);
+  paillier_encrypt(Bob->ct_gamma,Bob->ct_gamma,ctx);
   mpz_mul(Bob->ct_gamma,Bob->ct_gamma,Bob->ct_Alice);
-  mpz_mod(Bob->ct_gamma,Bob->ct_gamma,n_squared);
+  mpz_mod(Bob->ct_gamma,Bob->ct_gamma,ctx->n_squared);
 
   mpz_mod_ui(Bob->r,Bob->rho,1<<PARAM_L);
 
   gmp_randclear(seed);
-  mpz_clears(p,q,n,temp,n_squared, NULL);
 }
 
-void step1_Alice(cmp_HE_Alice * Alice) {
-  paillier_encrypt(Alice->ct_input,Alice->input);
+void step1_Alice(cmp_HE_Alice * Alice, paillier_ctx * ctx) {
+  paillier_encrypt(Alice->ct_input,Alice->input,ctx);
 }
 
-void step2_Bob(cmp_HE_Bob * Bob) {
-  dgk_Bob_gen_inputs(Bob);
+void step2_Bob(cmp_HE_Bob * Bob, paillier_ctx * ctx) {
+  dgk_Bob_gen_inputs(Bob,ctx);
 }
 
-void step3_Alice(cmp_HE_Alice * Alice, dgk_pk * DGK_publicKey) {
+void step3_Alice(cmp_HE_Alice * Alice, dgk_pk * DGK_publicKey, paillier_ctx * ctx) {
   mpz_t d_gamma ;
   mpz_init(d_gamma);
-  paillier_decrypt(Alice->gamma, Alice->ct_gamma);
+  paillier_decrypt(Alice->gamma, Alice->ct_gamma, ctx);
   gmp_printf("gamma : %Zu\n",Alice->gamma);
   mpz_mod_ui(Alice->c,Alice->gamma,1<<PARAM_L);
   d(d_gamma,Alice->gamma);
-  for (int i=0 ; i<PARAM_L;i++) dgk_encrypt_ui(Alice->ct_bits_c[i],mpz_tstbit(Alice->c,i),DGK_publicKey);
+  unsigned int bits_c[PARAM_L];
+  for (int i=0 ; i<PARAM_L;i++) bits_c[i]=mpz_tstbit(Alice->c,i);
+  dgk_encrypt_ui_batch(Alice->ct_bits_c,bits_c,PARAM_L,DGK_publicKey);
 
   mpz_clear(d_gamma);
 }
 
-void step4_Bob(cmp_HE_Bob * Bob, dgk_pk * DGK_publicKey) {
-
-  mpz_t tmp1, tmp2, d_rho, n, n_squared;
-  mpz_inits(tmp1,tmp2,d_rho,n,n_squared,NULL);
-  gmp_randinit_default (seed);
-  gmp_randseed_ui(seed,rand());
+void step4_Bob(cmp_HE_Bob * Bob, dgk_pk * DGK_publicKey, paillier_ctx * ctx) {
 
-  mpz_set_str(n,PAILLIER_PK_N,16);
-  mpz_mul(n_squared,n,n);
+  mpz_t tmp1, tmp2, d_rho;
+  mpz_inits(tmp1,tmp2,d_rho,NULL);
+  random_seed(seed);
 
-  int sum=0,tmp=0;
+  int sum=0;
+  unsigned int e[PARAM_L+1];
   Bob->s=1;
   d(d_rho, Bob->rho);
   gmp_printf("rho : %Zu\n", Bob->rho);
   mpz_add_ui(tmp1,d_rho,1);
-  mpz_invert(tmp2,Bob->ct_d_gamma,n_squared);
+  mpz_invert(tmp2,Bob->ct_d_gamma,ctx->n_squared);
   mpz_mul(Bob->ct_delta,tmp1,tmp2);
   for (int i=0 ; i<PARAM_L;i++) {
     sum=0;
     for(int j=i+1 ; j<PARAM_L ; j++) sum+=mpz_tstbit(Bob->c,j)^mpz_tstbit(Bob->r,i);
-    tmp=Bob->s+mpz_tstbit(Bob->r,i)-mpz_tstbit(Bob->c,i)+3*sum;
-    dgk_encrypt_ui(Bob->ct_e[i],tmp,DGK_publicKey);
+    e[i]=Bob->s+mpz_tstbit(Bob->r,i)-mpz_tstbit(Bob->c,i)+3*sum;
   }
   for(int j=0 ; j<PARAM_L ; j++) sum+=mpz_tstbit(Bob->c,j)^mpz_tstbit(Bob->r,j);
-  tmp=Bob->s-1+3*sum;
-  dgk_encrypt_ui(Bob->ct_e[PARAM_L],tmp,DGK_publicKey);
+  e[PARAM_L]=Bob->s-1+3*sum;
+  dgk_encrypt_ui_batch(Bob->ct_e,e,PARAM_L+1,DGK_publicKey);
 
   int s_i ;
-  mpz_t sp_i ;
-  mpz_init(sp_i);
+  mpz_t h[PARAM_L+1], sp[PARAM_L+1] ;
+  for (int i=0 ; i<PARAM_L+1;i++) {
+    mpz_init_set(h[i],DGK_publicKey->h);
+    mpz_init(sp[i]);
+    mpz_urandomb(sp[i],seed,2 * T_SIZE);
+  }
+  mont_powm_batch(sp,h,sp,PARAM_L+1,DGK_publicKey->n);
   for (int i=0 ; i<PARAM_L+1;i++) {
-    s_i = rand()%(DGK_publicKey->u);
-    mpz_urandomb(sp_i,seed,2 * T_SIZE);
-    mpz_powm(tmp1,DGK_publicKey->h,sp_i,DGK_publicKey->n);
+    s_i = gmp_urandomm_ui(seed,DGK_publicKey->u);
     mpz_powm_ui(Bob->ct_ep[i],Bob->ct_e[i],s_i,DGK_publicKey->n);
-    mpz_mul(Bob->ct_ep[i],Bob->ct_ep[i],tmp1);
-    mpz_mod(Bob->ct_ep[i],Bob->ct_ep[i],n);
-
-
+    mpz_mul(Bob->ct_ep[i],Bob->ct_ep[i],sp[i]);
+    mpz_mod(Bob->ct_ep[i],Bob->ct_ep[i],ctx->n);
+    mpz_clears(h[i],sp[i],NULL);
   }
   gmp_randclear(seed);
-  mpz_clears(tmp1,tmp2,d_rho,n,n_squared,sp_i,NULL);
+  mpz_clears(tmp1,tmp2,d_rho,NULL);
 
 }
 
-void step5_Alice(cmp_HE_Alice * Alice, dgk_sk * DGK_secretKey) {
+void step5_Alice(cmp_HE_Alice * Alice, dgk_sk * DGK_secretKey, paillier_ctx * ctx) {
 
-  int tau=1 ;
+  int tau=1, is_0[PARAM_L+1] ;
+  dgk_is_0_encryption_batch(is_0, Alice->ct_ep, PARAM_L+1, DGK_secretKey);
   for (int i=0 ; i<=PARAM_L ; i++ ) {
-    if (dgk_is_0_encryption(Alice->ct_ep[i], DGK_secretKey)) {
+    if (is_0[i]) {
       tau=0;
       break;
     }
   }
   printf("tau : %u\n", tau);
-  paillier_encrypt_ui(Alice->ct_tau,tau);
+  paillier_encrypt_ui(Alice->ct_tau,tau,ctx);
 }
 
-void step6_Bob(cmp_HE_Bob * Bob) {
-    mpz_t n,n_squared,tmp1,tmp2;
-    mpz_inits(n,n_squared,tmp1,tmp2, NULL);
+void step6_Bob(cmp_HE_Bob * Bob, paillier_ctx * ctx) {
+    mpz_t tmp1,tmp2;
+    mpz_inits(tmp1,tmp2, NULL);
 
-    mpz_set_str(n,PAILLIER_PK_N,16);
-    mpz_mul(n_squared,n,n);
   if (!Bob->s) {
-    mpz_invert(tmp1,Bob->ct_tau,n);
-    paillier_encrypt_ui(tmp2,1);
+    mpz_invert(tmp1,Bob->ct_tau,ctx->n);
+    paillier_encrypt_ui(tmp2,1,ctx);
     mpz_mul(Bob->ct_epsilon,tmp1,tmp2);
-    mpz_mod(Bob->ct_epsilon, Bob->ct_epsilon,n);
+    mpz_mod(Bob->ct_epsilon, Bob->ct_epsilon,ctx->n);
   }
 
   mpz_mul(Bob->ct_delta,Bob->ct_delta,Bob->ct_epsilon);
-  mpz_mod(Bob->ct_delta,Bob->ct_delta,n_squared);
+  mpz_mod(Bob->ct_delta,Bob->ct_delta,ctx->n_squared);
 
-  mpz_clears(n,n_squared,tmp1,tmp2, NULL);
+  mpz_clears(tmp1,tmp2, NULL);
 
 }
 
-void step7_Alice(cmp_HE_Alice * Alice) {
+void step7_Alice(cmp_HE_Alice * Alice, paillier_ctx * ctx) {
   mpz_t delta;
   mpz_init(delta);
   gmp_printf("test : %Zu\n",Alice->ct_delta);
-  paillier_decrypt(delta,Alice->ct_delta);
+  paillier_decrypt(delta,Alice->ct_delta,ctx);
 
   mpz_clear(delta);
 }
 
-void main(){
+void main(int argc, char ** argv){
   cmp_HE_Alice * Alice=cmp_HE_Alice_init();
   cmp_HE_Bob * Bob=cmp_HE_Bob_init();
   dgk_pk * DGK_publicKey=dgk_pk_init() ;
   dgk_sk * DGK_secretKey=dgk_sk_init() ;
   dgk_key_generation(DGK_publicKey, DGK_secretKey);
+  //Key files written by paillier_key_save are used if given, the compiled-in key otherwise
+  paillier_ctx * Alice_paillier=paillier_ctx_init() ;
+  paillier_ctx * Bob_paillier=paillier_ctx_init() ;
+  if (argc==3) {
+    if (paillier_key_load(Alice_paillier, argv[1]) || paillier_key_load(Bob_paillier, argv[2])) {
+      printf("Error : the key files can not be read\n");
+      return;
+    }
+  }
+  else {
+    paillier_ctx_set_str(Alice_paillier, PAILLIER_PK_N, PAILLIER_SK_P, PAILLIER_SK_Q, 16);
+    paillier_ctx_set_str(Bob_paillier, PAILLIER_PK_N, NULL, NULL, 16);
+  }
+  paillier_set_mode(Bob_paillier, PAILLIER_ENC_MODE);
+  paillier_pool_start(Bob_paillier, PAILLIER_POOL_DEPTH, PAILLIER_POOL_LOW_WATER);
   mpz_set_ui(Bob->input, 3);
   mpz_set_ui(Alice->input, 2);
 
-  step1_Alice(Alice);
+  step1_Alice(Alice,Alice_paillier);
   mpz_set(Bob->ct_Alice,Alice->ct_input);
 
-  step2_Bob(Bob);
+  step2_Bob(Bob,Bob_paillier);
   mpz_set(Alice->ct_gamma, Bob->ct_gamma);
 
-  step3_Alice(Alice,DGK_publicKey);
+  step3_Alice(Alice,DGK_publicKey,Alice_paillier);
   mpz_set(Bob->c,Alice->c);
 
-  step4_Bob(Bob,DGK_publicKey);
+  step4_Bob(Bob,DGK_publicKey,Bob_paillier);
   for (int i=0 ; i<=PARAM_L ; i++) mpz_set(Alice->ct_ep[i],Bob->ct_ep[i]);
 
-  step5_Alice(Alice,DGK_secretKey);
+  step5_Alice(Alice,DGK_secretKey,Alice_paillier);
   mpz_set(Bob->ct_tau,Alice->ct_tau);
 
-  step6_Bob(Bob);
+  step6_Bob(Bob,Bob_paillier);
   mpz_set(Alice->ct_delta,Bob->ct_delta);
 
-  step7_Alice(Alice);
+  step7_Alice(Alice,Alice_paillier);
 
    cmp_HE_Alice_clear(Alice) ;
    cmp_HE_Bob_clear(Bob) ;
    dgk_pk_clear(DGK_publicKey);
    dgk_sk_clear(DGK_secretKey);
+   paillier_ctx_clear(Alice_paillier);
+   paillier_ctx_clear(Bob_paillier);
 }
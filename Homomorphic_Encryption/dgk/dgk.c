@@ -34,6 +34,44 @@ void dgk_encrypt_ui(mpz_t cipher, unsigned int plain, dgk_pk * publicKey) {
 	gmp_randclear(seed);
 }
 
+/**
+	* \fn void dgk_encrypt_ui_batch(mpz_t * cipher, unsigned int * plain, int nb, dgk_pk * publicKey)
+	* \brief This function encrypts nb plaintexts thanks to the public key, the h^r exponentiations being batched by mont_powm_batch
+
+	* \param[out] cipher		mpz_t array of nb encrypted values
+
+	* \param[in] plain 			unsigned int array of nb plaintexts to encrypt
+	* \param[in] nb 				int representing the number of plaintexts
+	* \param[in] publicKey	dgk_pk stocking the public key values
+*/
+void dgk_encrypt_ui_batch(mpz_t * cipher, unsigned int * plain, int nb, dgk_pk * publicKey) {
+
+	gmp_randstate_t seed ;
+	mpz_t * r = calloc(nb,sizeof(mpz_t)), * base = calloc(nb,sizeof(mpz_t));
+	mpz_t temp;
+	mpz_init(temp);
+
+	gmp_randinit_default (seed);
+	gmp_randseed_ui(seed,rand());
+	for (int i=0;i<nb;i++) {
+		mpz_init_set(base[i],publicKey->h);
+		mpz_init(r[i]);
+		mpz_urandomm(r[i],seed,publicKey->n);
+	}
+	mont_powm_batch(r,base,r,nb,publicKey->n);
+	for (int i=0;i<nb;i++) {
+		mpz_powm_ui(temp,publicKey->g,plain[i],publicKey->n);
+		mpz_mul(cipher[i],temp,r[i]);
+		mpz_mod(cipher[i],cipher[i],publicKey->n);
+		mpz_clears(r[i],base[i],NULL);
+	}
+
+	free(r);
+	free(base);
+	mpz_clear(temp);
+	gmp_randclear(seed);
+}
+
 /**
 	* \fn void dgk_encrypt_mpz(mpz_t cipher, mpz_t plain, dgk_pk * publicKey)
 	* \brief This function encrypts a plaintext thanks to the public key
@@ -132,3 +170,30 @@ int dgk_is_0_encryption(mpz_t cipher, dgk_sk * secretKey) {
 	return r;
 
 }
+
+/**
+	* \fn void dgk_is_0_encryption_batch(int * is_0, mpz_t * cipher, int nb, dgk_sk * secretKey)
+	* \brief This function tests nb ciphertexts for encryptions of 0, the exponentiations being batched by mont_powm_batch
+
+	* \param[out] is_0			int array, is_0[i] is 1 if cipher[i] is an encryption of 0 and 0 otherwise
+
+	* \param[in] cipher 		mpz_t array of nb encrypted values to test
+	* \param[in] nb 				int representing the number of ciphertexts
+	* \param[in] secretKey	dgk_sk stocking the secretKey values
+*/
+void dgk_is_0_encryption_batch(int * is_0, mpz_t * cipher, int nb, dgk_sk * secretKey) {
+	mpz_t * temp = calloc(nb,sizeof(mpz_t)), * v = calloc(nb,sizeof(mpz_t));
+
+	for (int i=0;i<nb;i++) {
+		mpz_init_set(v[i],secretKey->v_p);
+		mpz_init(temp[i]);
+	}
+	mont_powm_batch(temp,cipher,v,nb,secretKey->p);
+	for (int i=0;i<nb;i++) {
+		is_0[i]=(mpz_cmp_ui(temp[i],1)==0);
+		mpz_clears(temp[i],v[i],NULL);
+	}
+
+	free(temp);
+	free(v);
+}
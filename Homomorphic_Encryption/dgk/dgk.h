@@ -9,9 +9,11 @@
 #include "key_generation.h"
 
 void dgk_encrypt_ui(mpz_t cipher, unsigned int plain, dgk_pk * publicKey);
+void dgk_encrypt_ui_batch(mpz_t * cipher, unsigned int * plain, int nb, dgk_pk * publicKey);
 void dgk_encrypt_mpz(mpz_t cipher, mpz_t plain, dgk_pk * publicKey);
 void dgk_precom_decrypt(mpz_t * decrypt_table, dgk_pk * publicKey, dgk_sk * secretKey);
 void dgk_decrypt(mpz_t plain, mpz_t cipher, mpz_t * decrypt_table, dgk_pk * publicKey, dgk_sk * secretKey);
 int dgk_is_0_encryption(mpz_t cipher, dgk_sk * secretKey);
+void dgk_is_0_encryption_batch(int * is_0, mpz_t * cipher, int nb, dgk_sk * secretKey);
 
 #endif
@@ -12,6 +12,7 @@
 #include "time.h"
 #include "math.h"
 #include "parameters.h"
+#include "../paillier/montgomery.h"
 
 /**
   * \typedef dgk_pk
@@ -34,3 +34,20 @@ void random_bytes(uint8_t* bytes_array, uint32_t nb_bytes) {
     nb_bytes -= i;
   }
 }
+
+/**
+  * \fn void random_seed(gmp_randstate_t seed)
+  * \brief This function initializes a GMP random state seeded from the system random generator
+
+  * \param[out] seed the random state to initialize, to be released with gmp_randclear
+*/
+void random_seed(gmp_randstate_t seed) {
+  mpz_t s;
+  uint8_t bytes_array[32];
+  random_bytes(bytes_array,32);
+  mpz_init(s);
+  mpz_import(s,32,-1,1,0,0,bytes_array);
+  gmp_randinit_default(seed);
+  gmp_randseed(seed,s);
+  mpz_clear(s);
+}
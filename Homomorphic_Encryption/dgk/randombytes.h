@@ -7,7 +7,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdint.h>
+#include "gmp.h"
 
 void random_bytes(uint8_t* bytes_array, uint32_t nb_bytes);
+void random_seed(gmp_randstate_t seed);
 
 #endif
\ No newline at end of file
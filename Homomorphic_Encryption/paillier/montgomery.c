@@ -0,0 +1,298 @@
+/**
+  * \file montgomery.c
+  * \brief implementation of the batched Montgomery exponentiation
+*/
+
+#include "montgomery.h"
+
+/**
+  * \fn void mont_to_digits(uint64_t * d, mpz_t x, int k, int lane, int lanes, int digit_bits)
+  * \brief This function writes the k digits of digit_bits bits of x into one lane of a vector array
+
+  * \param[out] d         uint64_t array of k lanes words, digit j of x goes to d[j*lanes+lane]
+
+  * \param[in] x          mpz_t representing a non negative value smaller than 2^(digit_bits k)
+  * \param[in] k          int representing the number of digits
+  * \param[in] lane       int representing the lane to write
+  * \param[in] lanes      int representing the number of lanes
+  * \param[in] digit_bits int representing the size of a digit, at most 63
+*/
+void mont_to_digits(uint64_t * d, mpz_t x, int k, int lane, int lanes, int digit_bits) {
+  const mp_limb_t * limbs = mpz_limbs_read(x);
+  mp_size_t size = mpz_size(x);
+  unsigned long bit, limb, shift;
+  uint64_t v, mask = (1ULL<<digit_bits)-1;
+
+  for (int j=0 ; j<k ; j++) {
+    bit=(unsigned long) j*digit_bits;
+    limb=bit/GMP_NUMB_BITS;
+    shift=bit%GMP_NUMB_BITS;
+    v=0;
+    if (limb<(unsigned long) size) v=limbs[limb]>>shift;
+    if (shift+digit_bits>GMP_NUMB_BITS && limb+1<(unsigned long) size) v|=limbs[limb+1]<<(GMP_NUMB_BITS-shift);
+    d[j*lanes+lane]=v&mask;
+  }
+}
+
+/**
+  * \fn void mont_from_digits(mpz_t x, uint64_t * d, int k, int lane, int lanes, int digit_bits)
+  * \brief This function reads a value from its k normalized digits in one lane of a vector array
+
+  * \param[out] x         mpz_t representing the value
+
+  * \param[in] d          uint64_t array of k lanes words
+  * \param[in] k          int representing the number of digits
+  * \param[in] lane       int representing the lane to read
+  * \param[in] lanes      int representing the number of lanes
+  * \param[in] digit_bits int representing the size of a digit, at most 63
+*/
+void mont_from_digits(mpz_t x, uint64_t * d, int k, int lane, int lanes, int digit_bits) {
+  mp_size_t size = ((mp_size_t) k*digit_bits+GMP_NUMB_BITS-1)/GMP_NUMB_BITS;
+  mp_limb_t * limbs = mpz_limbs_write(x,size);
+  unsigned long bit, limb, shift;
+
+  memset(limbs,0,size*sizeof(mp_limb_t));
+  for (int j=0 ; j<k ; j++) {
+    bit=(unsigned long) j*digit_bits;
+    limb=bit/GMP_NUMB_BITS;
+    shift=bit%GMP_NUMB_BITS;
+    limbs[limb]|=d[j*lanes+lane]<<shift;
+    if (shift+digit_bits>GMP_NUMB_BITS) limbs[limb+1]|=d[j*lanes+lane]>>(GMP_NUMB_BITS-shift);
+  }
+  mpz_limbs_finish(x,size);
+}
+
+/**
+  * \fn void mont_mul_avx2(uint64_t * r, uint64_t * a, uint64_t * b, uint64_t * m, uint64_t minv, int k, uint64_t * t)
+  * \brief This function computes r = a b 2^(-26 k) mod m in each of the MONT_AVX2_LANES lanes
+
+  * Operand scanning Montgomery multiplication on digits of MONT_AVX2_DIGIT_BITS bits held in 64-bit lanes. The
+  * accumulators are only normalized at the end: each of them receives at most 2k products of two digits,
+  * which fits in 64 bits as long as k < 2^10. With 2^(26 k) > 4m, inputs smaller than 2m give an output
+  * smaller than 2m, so no subtraction is needed between two multiplications.
+
+  * \param[out] r   uint64_t array of k MONT_AVX2_LANES normalized digits, may be a or b
+
+  * \param[in] a    uint64_t array of k MONT_AVX2_LANES normalized digits
+  * \param[in] b    uint64_t array of k MONT_AVX2_LANES normalized digits
+  * \param[in] m    uint64_t array of k MONT_AVX2_LANES digits, the modulus repeated in every lane
+  * \param[in] minv uint64_t representing -m^-1 mod 2^26
+  * \param[in] k    int representing the number of digits
+  * \param[in] t    uint64_t array of k MONT_AVX2_LANES words used as scratch space
+*/
+__attribute__((target("avx2")))
+void mont_mul_avx2(uint64_t * r, uint64_t * a, uint64_t * b, uint64_t * m, uint64_t minv, int k, uint64_t * t) {
+  __m256i * R = (__m256i *) r, * A = (__m256i *) a, * B = (__m256i *) b, * M = (__m256i *) m, * T = (__m256i *) t;
+  __m256i mask = _mm256_set1_epi64x((1ULL<<MONT_AVX2_DIGIT_BITS)-1), vminv = _mm256_set1_epi64x(minv), zero = _mm256_setzero_si256();
+  __m256i ai, q, acc, carry;
+
+  for (int j=0 ; j<k ; j++) _mm256_storeu_si256(T+j,zero);
+
+  for (int i=0 ; i<k ; i++) {
+    ai=_mm256_loadu_si256(A+i);
+    // q is chosen so that the lowest accumulator becomes a multiple of 2^26
+    acc=_mm256_add_epi64(_mm256_loadu_si256(T),_mm256_mul_epu32(ai,_mm256_loadu_si256(B)));
+    q=_mm256_and_si256(_mm256_mul_epu32(acc,vminv),mask);
+    acc=_mm256_add_epi64(acc,_mm256_mul_epu32(q,_mm256_loadu_si256(M)));
+    carry=_mm256_srli_epi64(acc,MONT_AVX2_DIGIT_BITS);
+
+    // T = (T + ai b + q m) / 2^26, the division being a shift of the accumulators
+    for (int j=1 ; j<k ; j++) {
+      acc=_mm256_add_epi64(_mm256_loadu_si256(T+j),_mm256_mul_epu32(ai,_mm256_loadu_si256(B+j)));
+      acc=_mm256_add_epi64(acc,_mm256_mul_epu32(q,_mm256_loadu_si256(M+j)));
+      _mm256_storeu_si256(T+j-1,_mm256_add_epi64(acc,carry));
+      carry=zero;
+    }
+    _mm256_storeu_si256(T+k-1,zero);
+  }
+
+  carry=zero;
+  for (int j=0 ; j<k ; j++) {
+    acc=_mm256_add_epi64(_mm256_loadu_si256(T+j),carry);
+    _mm256_storeu_si256(R+j,_mm256_and_si256(acc,mask));
+    carry=_mm256_srli_epi64(acc,MONT_AVX2_DIGIT_BITS);
+  }
+}
+
+/**
+  * \fn void mont_mul_ifma(uint64_t * r, uint64_t * a, uint64_t * b, uint64_t * m, uint64_t minv, int k, uint64_t * t)
+  * \brief This function computes r = a b 2^(-52 k) mod m in each of the MONT_IFMA_LANES lanes
+
+  * Same operand scanning as mont_mul_avx2 on digits of MONT_IFMA_DIGIT_BITS bits, with the AVX-512 IFMA
+  * instructions adding the low and the high 52 bits of each digit product to two neighbour accumulators.
+  * Each accumulator receives at most 4k values below 2^52, which fits in 64 bits as long as k < 2^10.
+
+  * \param[out] r   uint64_t array of k MONT_IFMA_LANES normalized digits, may be a or b
+
+  * \param[in] a    uint64_t array of k MONT_IFMA_LANES normalized digits
+  * \param[in] b    uint64_t array of k MONT_IFMA_LANES normalized digits
+  * \param[in] m    uint64_t array of k MONT_IFMA_LANES digits, the modulus repeated in every lane
+  * \param[in] minv uint64_t representing -m^-1 mod 2^52
+  * \param[in] k    int representing the number of digits
+  * \param[in] t    uint64_t array of k MONT_IFMA_LANES words used as scratch space
+*/
+__attribute__((target("avx512f,avx512ifma")))
+void mont_mul_ifma(uint64_t * r, uint64_t * a, uint64_t * b, uint64_t * m, uint64_t minv, int k, uint64_t * t) {
+  __m512i * R = (__m512i *) r, * A = (__m512i *) a, * B = (__m512i *) b, * M = (__m512i *) m, * T = (__m512i *) t;
+  __m512i mask = _mm512_set1_epi64((1ULL<<MONT_IFMA_DIGIT_BITS)-1), vminv = _mm512_set1_epi64(minv), zero = _mm512_setzero_si512();
+  __m512i ai, q, acc, carry, bj, mj;
+
+  for (int j=0 ; j<k ; j++) _mm512_storeu_si512(T+j,zero);
+
+  for (int i=0 ; i<k ; i++) {
+    ai=_mm512_loadu_si512(A+i);
+    bj=_mm512_loadu_si512(B);
+    mj=_mm512_loadu_si512(M);
+    acc=_mm512_madd52lo_epu64(_mm512_loadu_si512(T),ai,bj);
+    q=_mm512_madd52lo_epu64(zero,_mm512_and_si512(acc,mask),vminv);
+    acc=_mm512_madd52lo_epu64(acc,q,mj);
+    carry=_mm512_srli_epi64(acc,MONT_IFMA_DIGIT_BITS);
+
+    // T = (T + ai b + q m) / 2^52, the high halves of the products of digit j-1 land on digit j
+    for (int j=1 ; j<k ; j++) {
+      acc=_mm512_madd52hi_epu64(_mm512_loadu_si512(T+j),ai,bj);
+      acc=_mm512_madd52hi_epu64(acc,q,mj);
+      bj=_mm512_loadu_si512(B+j);
+      mj=_mm512_loadu_si512(M+j);
+      acc=_mm512_madd52lo_epu64(acc,ai,bj);
+      acc=_mm512_madd52lo_epu64(acc,q,mj);
+      _mm512_storeu_si512(T+j-1,_mm512_add_epi64(acc,carry));
+      carry=zero;
+    }
+    acc=_mm512_madd52hi_epu64(zero,ai,bj);
+    acc=_mm512_madd52hi_epu64(acc,q,mj);
+    _mm512_storeu_si512(T+k-1,acc);
+  }
+
+  carry=zero;
+  for (int j=0 ; j<k ; j++) {
+    acc=_mm512_add_epi64(_mm512_loadu_si512(T+j),carry);
+    _mm512_storeu_si512(R+j,_mm512_and_si512(acc,mask));
+    carry=_mm512_srli_epi64(acc,MONT_IFMA_DIGIT_BITS);
+  }
+}
+
+/**
+  * \fn void mont_powm_lanes(mpz_t * r, mpz_t * b, mpz_t * e, mpz_t modulus, int lanes, int digit_bits, mont_lanes_mul mul)
+  * \brief This function computes r[i] = b[i]^e[i] mod m for lanes independent exponentiations at once
+
+  * Fixed window exponentiation of width MONT_BATCH_WINDOW on a vector kernel. Every lane squares at the same
+  * time, then multiplies by the table entry selected by its own exponent window.
+
+  * \param[out] r          mpz_t array of lanes results, r[i] may be b[i] or e[i]
+
+  * \param[in] b           mpz_t array of lanes bases
+  * \param[in] e           mpz_t array of lanes non negative exponents
+  * \param[in] modulus     mpz_t representing the odd modulus
+  * \param[in] lanes       int representing the number of lanes of the kernel
+  * \param[in] digit_bits  int representing the size of the digits of the kernel
+  * \param[in] mul         mont_lanes_mul representing the kernel, mont_mul_avx2 or mont_mul_ifma
+*/
+void mont_powm_lanes(mpz_t * r, mpz_t * b, mpz_t * e, mpz_t modulus, int lanes, int digit_bits, mont_lanes_mul mul) {
+
+  int k = (mpz_sizeinbase(modulus,2)+2+digit_bits-1)/digit_bits;
+  int entries = 1<<MONT_BATCH_WINDOW, words = k*lanes, idx;
+  long bits = 0, nw;
+  uint64_t minv;
+  uint64_t * m = calloc(words,sizeof(uint64_t)), * t = calloc(words,sizeof(uint64_t));
+  uint64_t * acc = calloc(words,sizeof(uint64_t)), * sel = calloc(words,sizeof(uint64_t));
+  uint64_t * table = calloc(entries*words,sizeof(uint64_t));
+  mpz_t x, one;
+
+  mpz_inits(x,one,NULL);
+  for (int l=0 ; l<lanes ; l++) {
+    mont_to_digits(m,modulus,k,l,lanes,digit_bits);
+    if (mpz_sgn(e[l]) && mpz_sizeinbase(e[l],2)>(size_t) bits) bits=mpz_sizeinbase(e[l],2);
+  }
+  mpz_setbit(x,digit_bits);
+  mpz_invert(x,modulus,x);
+  minv=((1ULL<<digit_bits)-mpz_get_ui(x))&((1ULL<<digit_bits)-1);
+
+  // table[d] = b^d 2^(digit_bits k) mod m in every lane
+  mpz_setbit(one,(unsigned long) digit_bits*k);
+  mpz_mod(one,one,modulus);
+  for (int l=0 ; l<lanes ; l++) {
+    mont_to_digits(table,one,k,l,lanes,digit_bits);
+    mpz_mod(x,b[l],modulus);
+    mpz_mul_2exp(x,x,(unsigned long) digit_bits*k);
+    mpz_mod(x,x,modulus);
+    mont_to_digits(table+words,x,k,l,lanes,digit_bits);
+  }
+  for (int d=2 ; d<entries ; d++) mul(table+d*words,table+(d-1)*words,table+words,m,minv,k,t);
+
+  memcpy(acc,table,words*sizeof(uint64_t));
+  nw=(bits+MONT_BATCH_WINDOW-1)/MONT_BATCH_WINDOW;
+  for (long w=nw-1 ; w>=0 ; w--) {
+    if (w!=nw-1) for (int s=0 ; s<MONT_BATCH_WINDOW ; s++) mul(acc,acc,acc,m,minv,k,t);
+    for (int l=0 ; l<lanes ; l++) {
+      idx=0;
+      for (int s=MONT_BATCH_WINDOW-1 ; s>=0 ; s--) idx=(idx<<1)|mpz_tstbit(e[l],w*MONT_BATCH_WINDOW+s);
+      for (int j=0 ; j<k ; j++) sel[j*lanes+l]=table[idx*words+j*lanes+l];
+    }
+    mul(acc,acc,sel,m,minv,k,t);
+  }
+
+  // multiplying by 1 leaves the Montgomery domain
+  memset(sel,0,words*sizeof(uint64_t));
+  for (int l=0 ; l<lanes ; l++) sel[l]=1;
+  mul(acc,acc,sel,m,minv,k,t);
+  for (int l=0 ; l<lanes ; l++) {
+    mont_from_digits(r[l],acc,k,l,lanes,digit_bits);
+    mpz_mod(r[l],r[l],modulus);
+  }
+
+  mpz_clears(x,one,NULL);
+  free(m);
+  free(t);
+  free(acc);
+  free(sel);
+  free(table);
+}
+
+/**
+  * \fn int mont_batch_lanes()
+  * \brief This function selects the vector kernel used by mont_powm_batch on the processor running the code
+
+  * AVX-512 IFMA is used when available. The AVX2 kernel is only used on processors without the ADX and BMI2
+  * extensions: with them, the scalar GMP code computes more bits of products per cycle than 26-bit lanes.
+
+  * \return MONT_IFMA_LANES or MONT_AVX2_LANES for the selected kernel
+  * \return 1 if the exponentiations are run one by one
+*/
+int mont_batch_lanes() {
+  static int lanes = 0;
+  if (lanes==0) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512ifma")) lanes=MONT_IFMA_LANES;
+    else if (__builtin_cpu_supports("avx2") && !(__builtin_cpu_supports("adx") && __builtin_cpu_supports("bmi2"))) lanes=MONT_AVX2_LANES;
+    else lanes=1;
+  }
+  return lanes;
+}
+
+/**
+  * \fn void mont_powm_batch(mpz_t * r, mpz_t * b, mpz_t * e, int nb, mpz_t modulus)
+  * \brief This function computes r[i] = b[i]^e[i] mod m for nb independent exponentiations with the same modulus
+
+  * Full groups of lanes run on the vector kernel selected by mont_batch_lanes. The remaining ones, groups with a
+  * negative exponent, and every exponentiation when no kernel is selected use mpz_powm.
+
+  * \param[out] r   mpz_t array of nb results, r[i] may be b[i] or e[i]
+
+  * \param[in] b    mpz_t array of nb bases
+  * \param[in] e    mpz_t array of nb exponents
+  * \param[in] nb   int representing the number of exponentiations
+  * \param[in] modulus  mpz_t representing the odd modulus
+*/
+void mont_powm_batch(mpz_t * r, mpz_t * b, mpz_t * e, int nb, mpz_t modulus) {
+  int i=0, negative, lanes=mont_batch_lanes();
+
+  for ( ; lanes>1 && i+lanes<=nb ; i+=lanes) {
+    negative=0;
+    for (int l=0 ; l<lanes ; l++) negative|=(mpz_sgn(e[i+l])<0);
+    if (negative) for (int l=0 ; l<lanes ; l++) mpz_powm(r[i+l],b[i+l],e[i+l],modulus);
+    else if (lanes==MONT_IFMA_LANES) mont_powm_lanes(r+i,b+i,e+i,modulus,MONT_IFMA_LANES,MONT_IFMA_DIGIT_BITS,mont_mul_ifma);
+    else mont_powm_lanes(r+i,b+i,e+i,modulus,MONT_AVX2_LANES,MONT_AVX2_DIGIT_BITS,mont_mul_avx2);
+  }
+  for ( ; i<nb ; i++) mpz_powm(r[i],b[i],e[i],modulus);
+}
@@ -0,0 +1,36 @@
+/**
+  * \file montgomery.h
+  * \brief Batched Montgomery exponentiation in vector lanes
+*/
+
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "gmp.h"
+
+#define MONT_BATCH_WINDOW 4 /**< Fixed window width of the vector kernels */
+#define MONT_AVX2_LANES 4 /**< Number of exponentiations run together by the AVX2 kernel */
+#define MONT_AVX2_DIGIT_BITS 26 /**< Size in bits of the digits of the AVX2 kernel, read by 32x32-bit multiplications */
+#define MONT_IFMA_LANES 8 /**< Number of exponentiations run together by the AVX-512 IFMA kernel */
+#define MONT_IFMA_DIGIT_BITS 52 /**< Size in bits of the digits of the AVX-512 IFMA kernel */
+
+/**
+  * \typedef mont_lanes_mul
+  * \brief Vector Montgomery multiplication kernel, r = a b 2^(-digit_bits k) mod m in every lane
+  */
+typedef void (* mont_lanes_mul)(uint64_t * r, uint64_t * a, uint64_t * b, uint64_t * m, uint64_t minv, int k, uint64_t * t);
+
+void mont_to_digits(uint64_t * d, mpz_t x, int k, int lane, int lanes, int digit_bits);
+void mont_from_digits(mpz_t x, uint64_t * d, int k, int lane, int lanes, int digit_bits);
+void mont_mul_avx2(uint64_t * r, uint64_t * a, uint64_t * b, uint64_t * m, uint64_t minv, int k, uint64_t * t);
+void mont_mul_ifma(uint64_t * r, uint64_t * a, uint64_t * b, uint64_t * m, uint64_t minv, int k, uint64_t * t);
+void mont_powm_lanes(mpz_t * r, mpz_t * b, mpz_t * e, mpz_t modulus, int lanes, int digit_bits, mont_lanes_mul mul);
+int mont_batch_lanes();
+void mont_powm_batch(mpz_t * r, mpz_t * b, mpz_t * e, int nb, mpz_t modulus);
+
+#endif
@@ -4,107 +4,429 @@
 */
 
 #include "paillier.h"
+#include "paillier_pool.h"
 
 /**
-  * \fn void paillier_encrypt(mpz_t c, mpz_t m)
-  * \brief This function encrypts a message with a paillier public key
+  * \fn paillier_ctx * paillier_ctx_init()
+  * \brief This function initializes an empty Paillier key context
 
-  * \param[out] c mpz_t representing the encrypted value
+  * \return ctx an initialized paillier_ctx variable
+*/
+paillier_ctx * paillier_ctx_init() {
+  paillier_ctx * ctx = (paillier_ctx *) malloc(sizeof(paillier_ctx));
+  ctx->has_sk=0;
+  ctx->pool=NULL;
+  ctx->mode=PAILLIER_MODE_STANDARD;
+  ctx->djn_table=NULL;
+  mpz_inits(ctx->hs,ctx->n,ctx->n_squared,ctx->p,ctx->q,ctx->p_squared,ctx->q_squared,ctx->p_minus_1,ctx->q_minus_1,ctx->hp,ctx->hq,ctx->q_inv_p,ctx->p2_inv_q2,NULL);
+  return ctx;
+}
 
-  * \param[in] m mpz_t representing the message to encrypt
+/**
+  * \fn void paillier_ctx_clear(paillier_ctx * ctx)
+  * \brief This function releases a Paillier key context
+
+  * \param[in] ctx the variable to release
 */
-void paillier_encrypt(mpz_t c, mpz_t m) {
+void paillier_ctx_clear(paillier_ctx * ctx) {
+  paillier_pool_stop(ctx);
+  if (ctx->djn_table!=NULL) {
+    for (int i=0 ; i<PAILLIER_DJN_WINDOWS*((1<<PAILLIER_DJN_WINDOW)-1) ; i++) mpz_clear(ctx->djn_table[i]);
+    free(ctx->djn_table);
+  }
+  mpz_clears(ctx->hs,ctx->n,ctx->n_squared,ctx->p,ctx->q,ctx->p_squared,ctx->q_squared,ctx->p_minus_1,ctx->q_minus_1,ctx->hp,ctx->hq,ctx->q_inv_p,ctx->p2_inv_q2,NULL);
+  free(ctx);
+}
 
-  mpz_t n,n_squared,r;
-  mpz_inits(n,n_squared,r,NULL);
+/**
+  * \fn void paillier_ctx_set_str(paillier_ctx * ctx, char * n, char * p, char * q, int base)
+  * \brief This function sets a Paillier key from given strings and precomputes its values
 
-  mpz_set_str(n,PAILLIER_PK_N,16);
-  srand(time(NULL));
-  gmp_randstate_t seed ;
-  gmp_randinit_default (seed);
-  gmp_randseed_ui(seed,time(NULL));
+  * \param[out] ctx  paillier_ctx representing the key to set
 
-  mpz_mul(n_squared,n,n);
+  * \param[in] n     char array representing the public modulus
+  * \param[in] p     char array representing the first prime factor, NULL for a public key only
+  * \param[in] q     char array representing the second prime factor, NULL for a public key only
+  * \param[in] base  int representing the base in which the values are written
+*/
+void paillier_ctx_set_str(paillier_ctx * ctx, char * n, char * p, char * q, int base) {
+  mpz_set_str(ctx->n,n,base);
+  ctx->has_sk=(p!=NULL && q!=NULL);
+  if (ctx->has_sk) {
+    mpz_set_str(ctx->p,p,base);
+    mpz_set_str(ctx->q,q,base);
+  }
+  paillier_ctx_precompute(ctx);
+}
 
-  mpz_urandomm(r,seed,n);
-  mpz_mul(c,m,n);
-  mpz_add_ui(c,c,1);
-  mpz_mod(c,c,n_squared);
-  mpz_powm(r,r,n,n_squared);
+/**
+  * \fn void paillier_ctx_precompute(paillier_ctx * ctx)
+  * \brief This function computes every value derived from n (and p, q if the secret key is set)
 
-  mpz_mul(c,c,r);
-  mpz_mod(c,c,n_squared);
+  * \param[in,out] ctx paillier_ctx whose n, p, q and has_sk fields are set
+*/
+void paillier_ctx_precompute(paillier_ctx * ctx) {
+  mpz_mul(ctx->n_squared,ctx->n,ctx->n);
+  if (!ctx->has_sk) return;
+
+  mpz_mul(ctx->p_squared,ctx->p,ctx->p);
+  mpz_mul(ctx->q_squared,ctx->q,ctx->q);
+  mpz_sub_ui(ctx->p_minus_1,ctx->p,1);
+  mpz_sub_ui(ctx->q_minus_1,ctx->q,1);
+
+  // hp = L_p(g^(p-1) mod p^2)^-1 mod p with g = n+1
+  mpz_add_ui(ctx->hp,ctx->n,1);
+  mpz_powm(ctx->hp,ctx->hp,ctx->p_minus_1,ctx->p_squared);
+  mpz_sub_ui(ctx->hp,ctx->hp,1);
+  mpz_divexact(ctx->hp,ctx->hp,ctx->p);
+  mpz_invert(ctx->hp,ctx->hp,ctx->p);
+
+  // hq = L_q(g^(q-1) mod q^2)^-1 mod q
+  mpz_add_ui(ctx->hq,ctx->n,1);
+  mpz_powm(ctx->hq,ctx->hq,ctx->q_minus_1,ctx->q_squared);
+  mpz_sub_ui(ctx->hq,ctx->hq,1);
+  mpz_divexact(ctx->hq,ctx->hq,ctx->q);
+  mpz_invert(ctx->hq,ctx->hq,ctx->q);
+
+  mpz_invert(ctx->q_inv_p,ctx->q,ctx->p);
+
+  // coefficient used by the key holder to recombine n-th residues modulo n^2
+  mpz_invert(ctx->p2_inv_q2,ctx->p_squared,ctx->q_squared);
+}
+
+/**
+  * \fn void paillier_set_mode(paillier_ctx * ctx, int mode)
+  * \brief This function selects how encryption randomizers are computed
+
+  * Must be called before a pool is attached to the key.
+
+  * \param[in,out] ctx paillier_ctx representing the key
+  * \param[in] mode    PAILLIER_MODE_STANDARD or PAILLIER_MODE_DJN
+*/
+void paillier_set_mode(paillier_ctx * ctx, int mode) {
+  if (mode==PAILLIER_MODE_DJN && ctx->djn_table==NULL) paillier_djn_precompute(ctx);
+  ctx->mode=mode;
+}
+
+/**
+  * \fn void paillier_djn_precompute(paillier_ctx * ctx)
+  * \brief This function draws hs if it is not set yet and builds its fixed-base table
+
+  * \param[in,out] ctx paillier_ctx representing the key
+*/
+void paillier_djn_precompute(paillier_ctx * ctx) {
+
+  int digits=(1<<PAILLIER_DJN_WINDOW)-1;
+  mpz_t base;
+  mpz_init(base);
+
+  if (mpz_sgn(ctx->hs)==0) {
+    gmp_randstate_t seed ;
+    random_seed(seed);
+    mpz_urandomm(base,seed,ctx->n);
+    paillier_randomizer(ctx->hs,base,ctx);
+    gmp_randclear(seed);
+  }
+
+  ctx->djn_table=calloc(PAILLIER_DJN_WINDOWS*digits,sizeof(mpz_t));
+  mpz_set(base,ctx->hs);
+  for (int i=0 ; i<PAILLIER_DJN_WINDOWS ; i++) {
+    // base = hs^(2^(w*i)), row i holds base^1, ..., base^(2^w-1)
+    mpz_init_set(ctx->djn_table[i*digits],base);
+    for (int d=1 ; d<digits ; d++) {
+      mpz_init(ctx->djn_table[i*digits+d]);
+      mpz_mul(ctx->djn_table[i*digits+d],ctx->djn_table[i*digits+d-1],base);
+      mpz_mod(ctx->djn_table[i*digits+d],ctx->djn_table[i*digits+d],ctx->n_squared);
+    }
+    mpz_mul(base,ctx->djn_table[i*digits+digits-1],base);
+    mpz_mod(base,base,ctx->n_squared);
+  }
+
+  mpz_clear(base);
+}
+
+/**
+  * \fn void paillier_djn_randomizer(mpz_t rn, mpz_t a, paillier_ctx * ctx)
+  * \brief This function computes hs^a mod n^2 from the fixed-base table, using the PAILLIER_DJN_EXP_SIZE low bits of a
+
+  * One multiplication per non-zero window is needed and no squaring.
+
+  * \param[out] rn  mpz_t representing hs^a mod n^2
+
+  * \param[in] a    mpz_t representing the exponent
+  * \param[in] ctx  paillier_ctx whose DJN table is built
+*/
+void paillier_djn_randomizer(mpz_t rn, mpz_t a, paillier_ctx * ctx) {
+
+  int digits=(1<<PAILLIER_DJN_WINDOW)-1, d;
+  mpz_t acc;
+  mpz_init_set_ui(acc,1);
+
+  for (int i=0 ; i<PAILLIER_DJN_WINDOWS ; i++) {
+    d=0;
+    for (int j=PAILLIER_DJN_WINDOW-1 ; j>=0 ; j--) d=(d<<1)|mpz_tstbit(a,i*PAILLIER_DJN_WINDOW+j);
+    if (d==0) continue;
+    mpz_mul(acc,acc,ctx->djn_table[i*digits+d-1]);
+    mpz_mod(acc,acc,ctx->n_squared);
+  }
+  mpz_swap(rn,acc);
+
+  mpz_clear(acc);
+}
+
+/**
+  * \fn void paillier_randomizer(mpz_t rn, mpz_t r, paillier_ctx * ctx)
+  * \brief This function computes a random n-th residue modulo n^2 from a random value r
+
+  * With a public key only, rn = r^n mod n^2. If the context holds the secret key, rn is the n-th residue
+  * congruent to (r mod p)^p modulo p^2 and to (r mod q)^q modulo q^2. Since y^p mod p^2 only depends on
+  * y mod p, this is a bijection from Z_n^* onto the n-th residues, hence rn is uniform as well, while the
+  * two half-size exponentiations with half-size exponents are about 3 to 4 times cheaper.
+  * In DJN mode, rn = hs^a with a the PAILLIER_DJN_EXP_SIZE low bits of r, taken from the fixed-base table.
+
+  * \param[out] rn  mpz_t representing the n-th residue modulo n^2
+
+  * \param[in] r    mpz_t representing a random value of Z_n^*
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_randomizer(mpz_t rn, mpz_t r, paillier_ctx * ctx) {
+
+  if (ctx->mode==PAILLIER_MODE_DJN) {
+    paillier_djn_randomizer(rn,r,ctx);
+    return;
+  }
+
+  if (!ctx->has_sk) {
+    mpz_powm(rn,r,ctx->n,ctx->n_squared);
+    return;
+  }
+
+  mpz_t rp,rq;
+  mpz_inits(rp,rq,NULL);
+
+  mpz_mod(rp,r,ctx->p);
+  mpz_powm(rp,rp,ctx->p,ctx->p_squared);
+  mpz_mod(rq,r,ctx->q);
+  mpz_powm(rq,rq,ctx->q,ctx->q_squared);
+
+  // rn = rp + p^2 * ((rq - rp) * p^-2 mod q^2)
+  mpz_sub(rq,rq,rp);
+  mpz_mul(rq,rq,ctx->p2_inv_q2);
+  mpz_mod(rq,rq,ctx->q_squared);
+  mpz_mul(rq,rq,ctx->p_squared);
+  mpz_add(rn,rq,rp);
+
+  mpz_clears(rp,rq,NULL);
+}
+
+/**
+  * \fn void paillier_randomizer_batch(mpz_t * rn, mpz_t * r, int nb, paillier_ctx * ctx)
+  * \brief This function computes nb n-th residues modulo n^2 as paillier_randomizer does, with the exponentiations batched
+
+  * The exponentiations share their modulus (n^2, or p^2 and q^2 with the secret key) and are run by
+  * mont_powm_batch, which computes several of them at once in vector lanes when the processor allows it.
+
+  * \param[out] rn  mpz_t array of nb n-th residues modulo n^2, rn may be r
+
+  * \param[in] r    mpz_t array of nb random values of Z_n^*
+  * \param[in] nb   int representing the number of randomizers
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_randomizer_batch(mpz_t * rn, mpz_t * r, int nb, paillier_ctx * ctx) {
+
+  if (ctx->mode==PAILLIER_MODE_DJN) {
+    for (int i=0 ; i<nb ; i++) paillier_djn_randomizer(rn[i],r[i],ctx);
+    return;
+  }
+
+  mpz_t * e = calloc(nb,sizeof(mpz_t));
+
+  if (!ctx->has_sk) {
+    for (int i=0 ; i<nb ; i++) mpz_init_set(e[i],ctx->n);
+    mont_powm_batch(rn,r,e,nb,ctx->n_squared);
+    for (int i=0 ; i<nb ; i++) mpz_clear(e[i]);
+    free(e);
+    return;
+  }
+
+  mpz_t * rp = calloc(nb,sizeof(mpz_t)), * rq = calloc(nb,sizeof(mpz_t));
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_init_set(e[i],ctx->p);
+    mpz_init(rp[i]);
+    mpz_init(rq[i]);
+    mpz_mod(rp[i],r[i],ctx->p);
+    mpz_mod(rq[i],r[i],ctx->q);
+  }
+  mont_powm_batch(rp,rp,e,nb,ctx->p_squared);
+  for (int i=0 ; i<nb ; i++) mpz_set(e[i],ctx->q);
+  mont_powm_batch(rq,rq,e,nb,ctx->q_squared);
+
+  for (int i=0 ; i<nb ; i++) {
+    // rn = rp + p^2 * ((rq - rp) * p^-2 mod q^2)
+    mpz_sub(rq[i],rq[i],rp[i]);
+    mpz_mul(rq[i],rq[i],ctx->p2_inv_q2);
+    mpz_mod(rq[i],rq[i],ctx->q_squared);
+    mpz_mul(rq[i],rq[i],ctx->p_squared);
+    mpz_add(rn[i],rq[i],rp[i]);
+    mpz_clears(e[i],rp[i],rq[i],NULL);
+  }
+
+  free(e);
+  free(rp);
+  free(rq);
+}
+
+/**
+  * \fn void paillier_gen_randomizer(mpz_t rn, paillier_ctx * ctx)
+  * \brief This function draws a fresh random n-th residue modulo n^2, from the pool if one is attached to the key
+
+  * \param[out] rn  mpz_t representing the n-th residue
+
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_gen_randomizer(mpz_t rn, paillier_ctx * ctx) {
+
+  if (ctx->pool!=NULL) {
+    paillier_pool_get(rn,ctx->pool);
+    return;
+  }
+
+  gmp_randstate_t seed ;
+  random_seed(seed);
+
+  mpz_urandomm(rn,seed,ctx->n);
+  paillier_randomizer(rn,rn,ctx);
 
-  mpz_clears(n,n_squared,r,NULL);
   gmp_randclear(seed);
 }
 
 /**
-  * \fn void paillier_encrypt_ui(mpz_t c, unsigned int m)
-  * \brief This function encrypts a message with a paillier public key
+  * \fn void paillier_encrypt(mpz_t c, mpz_t m, paillier_ctx * ctx)
+  * \brief This function encrypts a message with a paillier key, using the CRT if the secret key is held
 
   * \param[out] c mpz_t representing the encrypted value
 
-  * \param[in] m mpz_t representing the message to encrypt
+  * \param[in] m    mpz_t representing the message to encrypt
+  * \param[in] ctx  paillier_ctx representing the key
 */
-void paillier_encrypt_ui(mpz_t c, unsigned int m) {
+void paillier_encrypt(mpz_t c, mpz_t m, paillier_ctx * ctx) {
 
-  mpz_t n,n_squared,r;
-  mpz_inits(n,n_squared,r,NULL);
+  mpz_t r;
+  mpz_init(r);
 
-  mpz_set_str(n,PAILLIER_PK_N,16);
-  srand(time(NULL));
-  gmp_randstate_t seed ;
-  gmp_randinit_default (seed);
-  gmp_randseed_ui(seed,time(NULL));
+  paillier_gen_randomizer(r,ctx);
+  mpz_mul(c,m,ctx->n);
+  mpz_add_ui(c,c,1);
+  mpz_mod(c,c,ctx->n_squared);
+
+  mpz_mul(c,c,r);
+  mpz_mod(c,c,ctx->n_squared);
+
+  mpz_clear(r);
+}
+
+/**
+  * \fn void paillier_encrypt_ui(mpz_t c, unsigned int m, paillier_ctx * ctx)
+  * \brief This function encrypts a message with a paillier key, using the CRT if the secret key is held
+
+  * \param[out] c mpz_t representing the encrypted value
+
+  * \param[in] m    unsigned int representing the message to encrypt
+  * \param[in] ctx  paillier_ctx representing the key
+*/
+void paillier_encrypt_ui(mpz_t c, unsigned int m, paillier_ctx * ctx) {
 
-  mpz_mul(n_squared,n,n);
+  mpz_t r;
+  mpz_init(r);
 
-  mpz_urandomm(r,seed,n);
-  mpz_mul_ui(c,n,m);
+  paillier_gen_randomizer(r,ctx);
+  mpz_mul_ui(c,ctx->n,m);
   mpz_add_ui(c,c,1);
-  mpz_mod(c,c,n_squared);
-  mpz_powm(r,r,n,n_squared);
+  mpz_mod(c,c,ctx->n_squared);
 
   mpz_mul(c,c,r);
-  mpz_mod(c,c,n_squared);
+  mpz_mod(c,c,ctx->n_squared);
 
-  mpz_clears(n,n_squared,r,NULL);
-  gmp_randclear(seed);
+  mpz_clear(r);
 }
 
 /**
-  * \fn void paillier_decrypt(mpz_t m, mpz_t c)
-  * \brief function decrypting a ciphertext with a Paillir key
+  * \fn void paillier_encrypt_batch(mpz_t * c, mpz_t * m, int nb, paillier_ctx * ctx)
+  * \brief This function encrypts nb messages with a paillier key
 
-  * \param[out] m mpz_t representing the decrypted value
+  * The randomizers come from the pool if one is attached to the key, otherwise they are computed
+  * together by paillier_randomizer_batch.
+
+  * \param[out] c   mpz_t array of nb encrypted values, c may be m
 
-  * \param[in] c mpz_t representing the ciphertext to decrypt
+  * \param[in] m    mpz_t array of nb messages to encrypt
+  * \param[in] nb   int representing the number of messages
+  * \param[in] ctx  paillier_ctx representing the key
 */
-void paillier_decrypt(mpz_t m, mpz_t c) {
+void paillier_encrypt_batch(mpz_t * c, mpz_t * m, int nb, paillier_ctx * ctx) {
 
-  mpz_t p,q,n,phi,temp,r,n_squared;
-  mpz_inits(p,q,n,phi,temp,r,n_squared, NULL);
+  mpz_t * r = calloc(nb,sizeof(mpz_t));
+  for (int i=0 ; i<nb ; i++) mpz_init(r[i]);
 
-  mpz_set_str(p,PAILLIER_SK_P,16);
-  mpz_set_str(q,PAILLIER_SK_Q,16);
-  mpz_set_str(n,PAILLIER_PK_N,16);;
+  if (ctx->pool!=NULL) {
+    for (int i=0 ; i<nb ; i++) paillier_pool_get(r[i],ctx->pool);
+  } else {
+    gmp_randstate_t seed ;
+    random_seed(seed);
+    for (int i=0 ; i<nb ; i++) mpz_urandomm(r[i],seed,ctx->n);
+    paillier_randomizer_batch(r,r,nb,ctx);
+    gmp_randclear(seed);
+  }
+
+  for (int i=0 ; i<nb ; i++) {
+    mpz_mul(c[i],m[i],ctx->n);
+    mpz_add_ui(c[i],c[i],1);
+    mpz_mod(c[i],c[i],ctx->n_squared);
+    mpz_mul(c[i],c[i],r[i]);
+    mpz_mod(c[i],c[i],ctx->n_squared);
+    mpz_clear(r[i]);
+  }
+
+  free(r);
+}
+
+/**
+  * \fn void paillier_decrypt(mpz_t m, mpz_t c, paillier_ctx * ctx)
+  * \brief function decrypting a ciphertext with a Paillier key, using two half-size exponentiations and the CRT
+
+  * \param[out] m mpz_t representing the decrypted value
+
+  * \param[in] c    mpz_t representing the ciphertext to decrypt
+  * \param[in] ctx  paillier_ctx representing the secret key
+*/
+void paillier_decrypt(mpz_t m, mpz_t c, paillier_ctx * ctx) {
 
-  mpz_mul(n_squared,n,n);
-  mpz_sub_ui(phi,p,1);
-  mpz_sub_ui(temp,q,1);
-  mpz_mul(phi,phi,temp);
+  mpz_t mp,mq;
+  mpz_inits(mp,mq,NULL);
 
-  mpz_invert(r,n,phi);
-  mpz_powm(r,c,r,n);
+  // mp = L_p(c^(p-1) mod p^2) * hp mod p
+  mpz_mod(mp,c,ctx->p_squared);
+  mpz_powm(mp,mp,ctx->p_minus_1,ctx->p_squared);
+  mpz_sub_ui(mp,mp,1);
+  mpz_divexact(mp,mp,ctx->p);
+  mpz_mul(mp,mp,ctx->hp);
+  mpz_mod(mp,mp,ctx->p);
 
-  mpz_invert(r,r,n_squared);
-  mpz_powm(r,r,n,n_squared);
-  mpz_mul(r,r,c);
-  mpz_mod(r,r,n_squared);
+  // mq = L_q(c^(q-1) mod q^2) * hq mod q
+  mpz_mod(mq,c,ctx->q_squared);
+  mpz_powm(mq,mq,ctx->q_minus_1,ctx->q_squared);
+  mpz_sub_ui(mq,mq,1);
+  mpz_divexact(mq,mq,ctx->q);
+  mpz_mul(mq,mq,ctx->hq);
+  mpz_mod(mq,mq,ctx->q);
 
-  mpz_sub_ui(r,r,1);
-  mpz_cdiv_q(m,r,n);
+  // m = mq + q * ((mp - mq) * q^-1 mod p)
+  mpz_sub(mp,mp,mq);
+  mpz_mul(mp,mp,ctx->q_inv_p);
+  mpz_mod(mp,mp,ctx->p);
+  mpz_mul(mp,mp,ctx->q);
+  mpz_add(m,mp,mq);
 
-  mpz_clears(p,q,n,phi,temp,r,n_squared, NULL);
+  mpz_clears(mp,mq,NULL);
 }
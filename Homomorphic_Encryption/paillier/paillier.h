@@ -13,9 +13,52 @@
 
 #include "gmp.h"
 #include "parameters.h"
+#include "montgomery.h"
+#include "../dgk/randombytes.h"
 
-void paillier_encrypt(mpz_t c, mpz_t m);
-void paillier_encrypt_ui(mpz_t c, unsigned int m);
-void paillier_decrypt(mpz_t m, mpz_t c);
+#define PAILLIER_MODE_STANDARD 0 /**< Randomizers are r^n mod n^2 with a full size r */
+#define PAILLIER_MODE_DJN 1 /**< Randomizers are hs^a mod n^2 with a short exponent a (Damgard-Jurik-Nielsen) */
+
+struct paillier_pool ;
+
+/**
+  * \typedef paillier_ctx
+  * \brief Structure for a Paillier key and its precomputed values
+  */
+typedef struct paillier_ctx {
+  int has_sk ; /**< 1 if the secret part of the context is set, 0 otherwise */
+  mpz_t n ; /**< Public modulus n = pq */
+  mpz_t n_squared ; /**< Ciphertext modulus n^2 */
+  mpz_t p ; /**< First prime factor of n */
+  mpz_t q ; /**< Second prime factor of n */
+  mpz_t p_squared ; /**< p^2 */
+  mpz_t q_squared ; /**< q^2 */
+  mpz_t p_minus_1 ; /**< p-1, decryption exponent modulo p^2 */
+  mpz_t q_minus_1 ; /**< q-1, decryption exponent modulo q^2 */
+  mpz_t hp ; /**< L_p(g^(p-1) mod p^2)^-1 mod p */
+  mpz_t hq ; /**< L_q(g^(q-1) mod q^2)^-1 mod q */
+  mpz_t q_inv_p ; /**< q^-1 mod p, CRT recombination coefficient */
+  mpz_t p2_inv_q2 ; /**< p^-2 mod q^2, CRT recombination coefficient modulo n^2 */
+  int mode ; /**< PAILLIER_MODE_STANDARD or PAILLIER_MODE_DJN */
+  mpz_t hs ; /**< Public n-th residue hs = x^n mod n^2 used in DJN mode */
+  mpz_t * djn_table ; /**< Fixed-base table, djn_table[i*(2^w-1)+d-1] = hs^(d*2^(w*i)) mod n^2, NULL until DJN mode is set */
+  struct paillier_pool * pool ; /**< Pool of precomputed randomizers, NULL if they are computed online */
+} paillier_ctx ;
+
+paillier_ctx * paillier_ctx_init();
+void paillier_ctx_clear(paillier_ctx * ctx);
+void paillier_ctx_set_str(paillier_ctx * ctx, char * n, char * p, char * q, int base);
+void paillier_ctx_precompute(paillier_ctx * ctx);
+
+void paillier_set_mode(paillier_ctx * ctx, int mode);
+void paillier_djn_precompute(paillier_ctx * ctx);
+void paillier_djn_randomizer(mpz_t rn, mpz_t a, paillier_ctx * ctx);
+void paillier_randomizer(mpz_t rn, mpz_t r, paillier_ctx * ctx);
+void paillier_randomizer_batch(mpz_t * rn, mpz_t * r, int nb, paillier_ctx * ctx);
+void paillier_gen_randomizer(mpz_t rn, paillier_ctx * ctx);
+void paillier_encrypt(mpz_t c, mpz_t m, paillier_ctx * ctx);
+void paillier_encrypt_ui(mpz_t c, unsigned int m, paillier_ctx * ctx);
+void paillier_encrypt_batch(mpz_t * c, mpz_t * m, int nb, paillier_ctx * ctx);
+void paillier_decrypt(mpz_t m, mpz_t c, paillier_ctx * ctx);
 
 #endif
@@ -0,0 +1,42 @@
+/**
+  * \file paillier_key.h
+  * \brief Runtime generation of Paillier keys and binary key files
+*/
+
+#ifndef PAILLIER_KEY_H
+#define PAILLIER_KEY_H
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "gmp.h"
+#include "paillier.h"
+#include "../dgk/randombytes.h"
+
+#define PAILLIER_KEY_MAGIC 0x3159454b4c494150ULL /**< "PAILKEY1" read as a little-endian 64-bit word */
+#define PAILLIER_KEY_FIELDS 13 /**< Number of mpz_t values stored in a key file */
+
+/**
+  * \typedef paillier_prime_search
+  * \brief Structure shared by the threads searching for a prime
+  */
+typedef struct paillier_prime_search {
+  int bits ; /**< Size in bits of the prime to find */
+  unsigned long * small_primes ; /**< Odd primes below PAILLIER_KEYGEN_SIEVE_BOUND */
+  int nb_small_primes ; /**< Number of values in small_primes */
+  int found ; /**< 1 once a thread found a prime */
+  mpz_t prime ; /**< The prime found */
+  pthread_mutex_t lock ; /**< Protects found and prime */
+} paillier_prime_search ;
+
+void paillier_gen_prime(mpz_t prime, int bits, int nb_threads);
+void * paillier_prime_worker(void * arg);
+void paillier_keygen(paillier_ctx * ctx, int bits);
+
+void paillier_key_fields(mpz_ptr * fields, paillier_ctx * ctx);
+int paillier_key_save(paillier_ctx * ctx, char * path, int with_sk);
+int paillier_key_load(paillier_ctx * ctx, char * path);
+
+#endif
@@ -0,0 +1,132 @@
+/**
+  * \file paillier_pool.c
+  * \brief implementation of the offline pool of Paillier randomizers
+*/
+
+#include "paillier_pool.h"
+
+/**
+  * \fn void paillier_pool_start(paillier_ctx * ctx, int depth, int low_water)
+  * \brief This function attaches a randomizer pool to a Paillier key and starts its refill thread
+
+  * Once started, every encryption with ctx draws its n-th residue from the pool, so that the online
+  * cost of an encryption is a single multiplication modulo n^2.
+
+  * \param[in,out] ctx     paillier_ctx representing the key to attach the pool to
+  * \param[in] depth       int representing the number of randomizers kept ready
+  * \param[in] low_water   int representing the level under which the worker starts refilling
+*/
+void paillier_pool_start(paillier_ctx * ctx, int depth, int low_water) {
+  paillier_pool * pool = (paillier_pool *) malloc(sizeof(paillier_pool));
+
+  pool->ctx=ctx;
+  pool->depth=depth;
+  pool->low_water=low_water;
+  pool->head=0;
+  pool->count=0;
+  pool->stop=0;
+  pool->ring=calloc(depth,sizeof(mpz_t));
+  for (int i=0 ; i<depth ; i++) mpz_init(pool->ring[i]);
+
+  random_seed(pool->worker_seed);
+  random_seed(pool->fallback_seed);
+
+  pthread_mutex_init(&pool->lock,NULL);
+  pthread_cond_init(&pool->refill,NULL);
+  pthread_create(&pool->worker,NULL,paillier_pool_worker,pool);
+
+  ctx->pool=pool;
+}
+
+/**
+  * \fn void paillier_pool_stop(paillier_ctx * ctx)
+  * \brief This function stops the refill thread and releases the pool attached to a Paillier key
+
+  * \param[in,out] ctx paillier_ctx whose pool is released
+*/
+void paillier_pool_stop(paillier_ctx * ctx) {
+  paillier_pool * pool = ctx->pool;
+  if (pool==NULL) return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stop=1;
+  pthread_cond_signal(&pool->refill);
+  pthread_mutex_unlock(&pool->lock);
+  pthread_join(pool->worker,NULL);
+
+  for (int i=0 ; i<pool->depth ; i++) mpz_clear(pool->ring[i]);
+  free(pool->ring);
+  gmp_randclear(pool->worker_seed);
+  gmp_randclear(pool->fallback_seed);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->refill);
+  free(pool);
+  ctx->pool=NULL;
+}
+
+/**
+  * \fn void paillier_pool_get(mpz_t rn, paillier_pool * pool)
+  * \brief This function draws a randomizer from the pool
+
+  * If the ring is empty, the randomizer is computed by the caller instead of waiting for the worker.
+
+  * \param[out] rn  mpz_t representing a random n-th residue modulo n^2
+
+  * \param[in] pool paillier_pool to draw from
+*/
+void paillier_pool_get(mpz_t rn, paillier_pool * pool) {
+
+  pthread_mutex_lock(&pool->lock);
+  if (pool->count>0) {
+    mpz_swap(rn,pool->ring[pool->head]);
+    pool->head=(pool->head+1)%pool->depth;
+    pool->count--;
+    if (pool->count<pool->low_water) pthread_cond_signal(&pool->refill);
+    pthread_mutex_unlock(&pool->lock);
+    return;
+  }
+  mpz_urandomm(rn,pool->fallback_seed,pool->ctx->n);
+  pthread_cond_signal(&pool->refill);
+  pthread_mutex_unlock(&pool->lock);
+
+  paillier_randomizer(rn,rn,pool->ctx);
+}
+
+/**
+  * \fn void * paillier_pool_worker(void * arg)
+  * \brief Body of the refill thread: fills the ring up to its depth, then sleeps until it goes under the low-water mark
+
+  * \param[in] arg paillier_pool to refill
+
+  * \return NULL
+*/
+void * paillier_pool_worker(void * arg) {
+  paillier_pool * pool = (paillier_pool *) arg;
+  int lanes = mont_batch_lanes();
+  mpz_t * r = calloc(lanes,sizeof(mpz_t));
+  for (int l=0 ; l<lanes ; l++) mpz_init(r[l]);
+
+  pthread_mutex_lock(&pool->lock);
+  while (!pool->stop) {
+    if (pool->count==pool->depth) {
+      while (!pool->stop && pool->count>=pool->low_water) pthread_cond_wait(&pool->refill,&pool->lock);
+      continue;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    // one group of randomizers per vector pass of the exponentiation kernel
+    for (int l=0 ; l<lanes ; l++) mpz_urandomm(r[l],pool->worker_seed,pool->ctx->n);
+    paillier_randomizer_batch(r,r,lanes,pool->ctx);
+
+    pthread_mutex_lock(&pool->lock);
+    for (int l=0 ; l<lanes && pool->count<pool->depth ; l++) {
+      mpz_swap(pool->ring[(pool->head+pool->count)%pool->depth],r[l]);
+      pool->count++;
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int l=0 ; l<lanes ; l++) mpz_clear(r[l]);
+  free(r);
+  return NULL;
+}
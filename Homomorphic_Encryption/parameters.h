@@ -26,4 +26,20 @@
 #define PAILLIER_SK_Q "A362293EEE6EAF77459A4625F95012CF2C64E3A2D80396E127C676BC8B275B221D9157899421A4BD1FD951EF56A5E92BB7653573BBC116C5146EFC441466A175F9772C124AF815AA4B149F3303D26949A005AE66EB761C4378F8274F194B6E065276774DD7EAFF21EE1EE9E17A0C9C7AEEB0A3FF2579AE95A23616EFCDC31EC3" /**< value q of the paillier secret key*/
 #define PAILLIER_PK_N "A17770E4E3AAA0A5AAD871A984A93F04AAACF7579B13D92CD765F75513DC9BA4BC652981156C92A3E3771124FA80D1293148895125226D51B0995AFF02857371735F43C5B49A1B2E4749FA1BFE82AC08D493EFACF8C95F5A9C5E8CAB3CDF3BC5B214D7EFF4BFFE8C6EC8B6EA4EEBE3498FAB201235981D9E2F081019FCD048726ECA019D28549E0D2BAA3BA712AF8B44A61E3CC53782E136C19FF19BB91277535A6B95950BC73F4E98CD08F8801A2D055DFC933552B6D6088089F2A19811D9EEC175F6713F114559DFF82DCE8A334B7472091EF09C535607C66B1161B7E7293D93D077B3F36789A3A8814764C0BC55A833A0910B8B78E2577A90760EAAD562E1" /**< value n of the public paillier key*/
 
+//Paillier key generation
+#define PAILLIER_KEYGEN_THREADS 4 /**< Number of threads searching for the primes of a new key */
+#define PAILLIER_KEYGEN_SIEVE_BOUND 65536 /**< Candidates with a prime factor below this bound are discarded before any primality test */
+#define PAILLIER_KEYGEN_SIEVE_SIZE 4096 /**< Number of consecutive odd candidates sieved at once by each thread */
+#define PAILLIER_PRIME_TEST_ITERATIONS 30 /**< Number of Miller-Rabin rounds run on the candidates surviving the sieve */
+
+//Paillier randomizers pool
+#define PAILLIER_POOL_DEPTH 16 /**< Number of randomizers kept ready by the pool */
+#define PAILLIER_POOL_LOW_WATER 4 /**< The pool is refilled once it holds less randomizers than this */
+
+//Paillier encryption mode
+#define PAILLIER_ENC_MODE PAILLIER_MODE_STANDARD /**< PAILLIER_MODE_STANDARD or PAILLIER_MODE_DJN (short exponent randomizers) */
+#define PAILLIER_DJN_EXP_SIZE 256 /**< Size in bits of the DJN short exponents (twice the computational security) */
+#define PAILLIER_DJN_WINDOW 4 /**< Window width in bits of the DJN fixed-base table */
+#define PAILLIER_DJN_WINDOWS ((PAILLIER_DJN_EXP_SIZE+PAILLIER_DJN_WINDOW-1)/PAILLIER_DJN_WINDOW) /**< Number of rows of the DJN fixed-base table */
+
 #endif